@@ -0,0 +1,535 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Kernel microbenchmark
+ *
+ * Time individual numerical kernels on synthetic inputs. The program is
+ * linked against the object files of the solver, hence kernels are measured
+ * exactly as they are compiled for production. Build and run by 'make
+ * microbench' in the source directory.
+ ****************************************************************************/
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include <stdio.h> /* standard library for input and output */
+#include <stdlib.h> /* dynamic memory allocation and exit */
+#include <math.h> /* common mathematical functions */
+#include <float.h> /* size of floating point values */
+#include "cfd_parameters.h"
+#include "domain_partition.h"
+#include "computational_geometry.h"
+#include "immersed_boundary.h"
+#include "numerical_test.h"
+#include "fluid_dynamics.h"
+#include "linear_system.h"
+#include "weno.h"
+#include "timer.h"
+#include "cfd_commons.h"
+#include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+typedef enum {
+    MESHN = 24, /* mesh number of each dimension of the field */
+    THETAN = 16, /* polar divisions of the triangulated sphere */
+    PHIN = 32, /* azimuthal divisions of the triangulated sphere */
+    FACEN = 2 * PHIN * (THETAN - 1), /* faces of the triangulated sphere */
+    POINTN = 256, /* number of query points */
+    TRIN = 1024, /* number of random triangles */
+    SYSN = 256, /* number of linear systems */
+    KERNELN = 11, /* number of kernels */
+} MicroConstants;
+/*
+ * Synthetic inputs
+ */
+typedef struct {
+    Time time;
+    Space space; /* a periodic Taylor-Green vortex field */
+    Model model;
+    Geometry geo; /* a triangulated unit sphere */
+    Real (*p)[DIMS]; /* query points around the sphere surface */
+    Real (*tri)[3][DIMS]; /* random triangles: v0, e01, e02 */
+    Real (*A)[DIMS][DIMS]; /* diagonally dominant matrices */
+    Real (*B)[DIMS][1]; /* right hand vectors */
+} Workspace;
+/*
+ * A sweep calls a kernel over its inputs once, accumulates a checksum to
+ * keep the calls alive, and returns the number of calls.
+ */
+typedef long (*KernelSweep)(const Workspace *, Real *);
+/*
+ * Kernel entry
+ *
+ * Floating point operations are nominal counts of the source with divisions
+ * and square roots counted as one, bytes are the nominal input and output
+ * data of a call. Both are only used to report rates.
+ */
+typedef struct {
+    const char *name;
+    KernelSweep Sweep;
+    double flop; /* nominal floating point operations per call */
+    double byte; /* nominal bytes per call */
+} Kernel;
+/****************************************************************************
+ * Static Function Declarations
+ ****************************************************************************/
+static void GenerateField(Workspace *);
+static void GeneratePolyhedron(Workspace *);
+static void GenerateSamples(Workspace *);
+static void ReleaseWorkspace(Workspace *);
+static void SphereVertex(const int, const int, Real [restrict]);
+static Real Random(const Real, const Real);
+static void MeasureKernel(const Kernel *, const Workspace *);
+static long SweepWENO3(const Workspace *, Real *);
+static long SweepWENO5(const Workspace *, Real *);
+static long SweepWENO5Z(const Workspace *, Real *);
+static long SweepWENO5M(const Workspace *, Real *);
+static long SweepEigenvector(const Workspace *, Real *);
+static long SweepEigenvectorProjection(const Workspace *, Real *);
+static long SweepDiffusiveFlux(const Workspace *, Real *);
+static long SweepPointTriangleDistance(const Workspace *, Real *);
+static long SweepPointInPolyhedron(const Workspace *, Real *);
+static long SweepInverseDistanceWeighting(const Workspace *, Real *);
+static long SweepLinearSystem(const Workspace *, Real *);
+/****************************************************************************
+ * Global Variables Definition with Private Scope
+ ****************************************************************************/
+static const double minTime = 0.2; /* minimum measured time of each kernel */
+static const Kernel kernel[KERNELN] = {
+    {"WENO3", SweepWENO3, 505.0, (4 + 1) * DIMU * sizeof(Real)},
+    {"WENO5", SweepWENO5, 1020.0, (6 + 1) * DIMU * sizeof(Real)},
+    {"WENO5Z", SweepWENO5Z, 1050.0, (6 + 1) * DIMU * sizeof(Real)},
+    {"WENO5M", SweepWENO5M, 1260.0, (6 + 1) * DIMU * sizeof(Real)},
+    {"SymmetricAverage+EigenvectorL/R", SweepEigenvector, 135.0,
+        (2 * DIMU + DIMUo + 2 * DIMU * DIMU) * sizeof(Real)},
+    {"SymmetricAverage+EigenvectorProject", SweepEigenvectorProjection, 240.0,
+        (2 * DIMU + DIMUo + 2 * 7 * DIMU) * sizeof(Real)},
+    {"NumericalDiffusiveFluxX", SweepDiffusiveFlux, 110.0, (10 + 1) * DIMU * sizeof(Real)},
+    {"PointTriangleDistance", SweepPointTriangleDistance, 60.0, (4 * DIMS + 3) * sizeof(Real)},
+    {"PointInPolyhedron", SweepPointInPolyhedron, 66.0 * FACEN + 30.0,
+        FACEN * (POLYN * sizeof(int) + POLYN * DIMS * sizeof(Real))},
+    {"InverseDistanceWeighting", SweepInverseDistanceWeighting, 27.0 * 47.0,
+        27 * (2 * sizeof(int) + DIMU * sizeof(Real)) + DIMUo * sizeof(Real)},
+    {"MatrixLinearSystemSolver", SweepLinearSystem, 50.0,
+        (DIMS * DIMS + 2 * DIMS) * sizeof(Real)}
+};
+/****************************************************************************
+ * Function definitions
+ ****************************************************************************/
+int main(void)
+{
+    Workspace *ws = AssignStorage(sizeof(*ws));
+    GenerateField(ws);
+    GeneratePolyhedron(ws);
+    GenerateSamples(ws);
+    fprintf(stdout, "%-34s %12s %12s %10s %12s %14s\n",
+            "kernel", "calls", "ns/call", "GFLOP/s", "bytes/call", "checksum");
+    for (int n = 0; n < KERNELN; ++n) {
+        MeasureKernel(kernel + n, ws);
+    }
+    ReleaseWorkspace(ws);
+    RetrieveStorage(ws);
+    return 0;
+}
+/*
+ * Repeat sweeps until the measured time is long enough to be stable, the
+ * first sweep warms up caches and is not measured.
+ */
+static void MeasureKernel(const Kernel *ker, const Workspace *ws)
+{
+    Timer timer;
+    Real sum = 0.0;
+    long callN = 0;
+    double elapsed = 0.0;
+    ker->Sweep(ws, &sum);
+    sum = 0.0;
+    TickTime(&timer);
+    do {
+        callN = callN + ker->Sweep(ws, &sum);
+        elapsed = TockTime(&timer);
+    } while (minTime > elapsed);
+    const double time = elapsed / (double)callN;
+    fprintf(stdout, "%-34s %12ld %12.2f %10.3f %12.0f %14.6g\n", ker->name, callN,
+            time * 1.0e9, ker->flop / time * 1.0e-9, ker->byte, sum);
+    fflush(stdout);
+    return;
+}
+/*
+ * Set the data that are normally loaded from case files, the field is a
+ * three dimensional Taylor-Green vortex on a periodic domain.
+ */
+static void GenerateField(Workspace *ws)
+{
+    const Real pi = 3.14159265359;
+    Time *time = &(ws->time);
+    Space *space = &(ws->space);
+    Model *model = &(ws->model);
+    Partition *part = &(space->part);
+    for (int s = 0; s < DIMS; ++s) {
+        part->m[s] = MESHN;
+        part->domain[s][MIN] = -pi;
+        part->domain[s][MAX] = pi;
+        part->typeBC[PWB+2*s] = PERIODIC;
+        part->typeBC[PEB+2*s] = PERIODIC;
+    }
+    time->end = 1.0;
+    time->numCFL = 0.6;
+    time->stepN = 1;
+    model->tScheme = 1;
+    model->sScheme = WENOFIVE;
+    model->jacobMean = 1;
+    model->ibmLayer = 1;
+    model->refMu = 1.0;
+    model->refL = 1.0;
+    model->refRho = 1.0;
+    model->refT = 300.0;
+    model->refV = sqrt(287.058 * model->refT);
+    const Real Uo[VARIC] = {1.0, 1.0, 1.0, 0.0, 71.4286};
+    part->countIC = 1;
+    for (int n = 0; n < VARIC; ++n) {
+        part->valueIC[0][ENTRYIC-VARIC+n] = Uo[n];
+    }
+    ComputeParameters(time, space, model);
+    DomainPartition(space);
+    const int idxMax = part->n[X] * part->n[Y] * part->n[Z];
+    space->node = AssignStorage(idxMax * sizeof(*space->node));
+    for (int idx = 0; idx < idxMax; ++idx) {
+        space->node[idx].gid = NONE;
+        space->node[idx].fid = NONE;
+        space->node[idx].lid = NONE;
+        space->node[idx].gst = NONE;
+    }
+    ComputeGeometryDomain(space, model);
+    SetField(TO, TAYLORGREEN, space, model);
+    return;
+}
+/*
+ * A unit sphere triangulated by latitude and longitude lines, vertices are
+ * generated by the same expressions for shared positions to be identical.
+ */
+static void GeneratePolyhedron(Workspace *ws)
+{
+    Geometry *geo = &(ws->geo);
+    geo->totN = 1;
+    geo->stlN = 1;
+    geo->poly = AssignStorage(geo->totN * sizeof(*geo->poly));
+    Polyhedron *poly = geo->poly;
+    poly->faceN = FACEN;
+    poly->facet = AssignStorage(poly->faceN * sizeof(*poly->facet));
+    int n = 0;
+    for (int t = 0; t < THETAN; ++t) {
+        for (int p = 0; p < PHIN; ++p) {
+            if (0 != t) { /* skip degenerated faces at the north pole */
+                SphereVertex(t, p, poly->facet[n].v0);
+                SphereVertex(t + 1, p + 1, poly->facet[n].v1);
+                SphereVertex(t, p + 1, poly->facet[n].v2);
+                ++n;
+            }
+            if (THETAN - 1 != t) { /* skip degenerated faces at the south pole */
+                SphereVertex(t, p, poly->facet[n].v0);
+                SphereVertex(t + 1, p, poly->facet[n].v1);
+                SphereVertex(t + 1, p + 1, poly->facet[n].v2);
+                ++n;
+            }
+        }
+    }
+    ConvertPolyhedron(&(geo->arena), poly);
+    ComputeGeometryParameters(COLLAPSEN, geo);
+    return;
+}
+static void SphereVertex(const int t, const int p, Real v[restrict])
+{
+    const Real pi = 3.14159265359;
+    const Real theta = pi * t / THETAN;
+    const Real phi = 2.0 * pi * (p % PHIN) / PHIN;
+    if (0 == t) {
+        v[X] = 0.0;
+        v[Y] = 0.0;
+        v[Z] = 1.0;
+        return;
+    }
+    if (THETAN == t) {
+        v[X] = 0.0;
+        v[Y] = 0.0;
+        v[Z] = -1.0;
+        return;
+    }
+    v[X] = sin(theta) * cos(phi);
+    v[Y] = sin(theta) * sin(phi);
+    v[Z] = cos(theta);
+    return;
+}
+/*
+ * Inputs are pseudo random with a fixed seed for runs to be comparable.
+ */
+static void GenerateSamples(Workspace *ws)
+{
+    srand(1);
+    ws->p = AssignStorage(POINTN * sizeof(*ws->p));
+    for (int n = 0; n < POINTN; ++n) {
+        for (int s = 0; s < DIMS; ++s) {
+            ws->p[n][s] = Random(-1.2, 1.2);
+        }
+    }
+    ws->tri = AssignStorage(TRIN * sizeof(*ws->tri));
+    for (int n = 0; n < TRIN; ++n) {
+        for (int s = 0; s < DIMS; ++s) {
+            ws->tri[n][0][s] = Random(-1.0, 1.0);
+            ws->tri[n][1][s] = Random(-0.5, 0.5);
+            ws->tri[n][2][s] = Random(-0.5, 0.5);
+        }
+    }
+    ws->A = AssignStorage(SYSN * sizeof(*ws->A));
+    ws->B = AssignStorage(SYSN * sizeof(*ws->B));
+    for (int n = 0; n < SYSN; ++n) {
+        for (int r = 0; r < DIMS; ++r) {
+            for (int c = 0; c < DIMS; ++c) {
+                ws->A[n][r][c] = Random(-1.0, 1.0);
+            }
+            ws->A[n][r][r] = ws->A[n][r][r] + 4.0;
+            ws->B[n][r][0] = Random(-1.0, 1.0);
+        }
+    }
+    return;
+}
+static Real Random(const Real low, const Real high)
+{
+    return low + (high - low) * (Real)rand() / (Real)RAND_MAX;
+}
+static void ReleaseWorkspace(Workspace *ws)
+{
+    RetrieveStorage(ws->space.node);
+    ReleaseDomainPartition(&(ws->space));
+    ReleaseGeometryDomain(&(ws->space));
+    RetrieveArenaStorage(&(ws->geo.arena));
+    RetrieveStorage(ws->geo.poly);
+    RetrieveStorage(ws->p);
+    RetrieveStorage(ws->tri);
+    RetrieveStorage(ws->A);
+    RetrieveStorage(ws->B);
+    return;
+}
+/*
+ * Field kernels sweep the interfaces of the x direction in the interior
+ * nodes, as the solver does.
+ */
+static long SweepWENO3(const Workspace *ws, Real *sum)
+{
+    const Partition *part = &(ws->space.part);
+    Real Fhat[DIMU] = {0.0};
+    long callN = 0;
+    for (int k = part->ns[PIN][Z][MIN]; k < part->ns[PIN][Z][MAX]; ++k) {
+        for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
+            for (int i = part->ns[PIN][X][MIN] - 1; i < part->ns[PIN][X][MAX]; ++i) {
+                WENO3(TO, X, k, j, i, part->n, ws->space.node, &(ws->model), Fhat);
+                *sum = *sum + Fhat[1];
+                ++callN;
+            }
+        }
+    }
+    return callN;
+}
+static long SweepWENO5(const Workspace *ws, Real *sum)
+{
+    const Partition *part = &(ws->space.part);
+    Real Fhat[DIMU] = {0.0};
+    long callN = 0;
+    for (int k = part->ns[PIN][Z][MIN]; k < part->ns[PIN][Z][MAX]; ++k) {
+        for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
+            for (int i = part->ns[PIN][X][MIN] - 1; i < part->ns[PIN][X][MAX]; ++i) {
+                WENO5(TO, X, k, j, i, part->n, ws->space.node, &(ws->model), Fhat);
+                *sum = *sum + Fhat[1];
+                ++callN;
+            }
+        }
+    }
+    return callN;
+}
+static long SweepWENO5Z(const Workspace *ws, Real *sum)
+{
+    const Partition *part = &(ws->space.part);
+    Real Fhat[DIMU] = {0.0};
+    long callN = 0;
+    for (int k = part->ns[PIN][Z][MIN]; k < part->ns[PIN][Z][MAX]; ++k) {
+        for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
+            for (int i = part->ns[PIN][X][MIN] - 1; i < part->ns[PIN][X][MAX]; ++i) {
+                WENO5Z(TO, X, k, j, i, part->n, ws->space.node, &(ws->model), Fhat);
+                *sum = *sum + Fhat[1];
+                ++callN;
+            }
+        }
+    }
+    return callN;
+}
+static long SweepWENO5M(const Workspace *ws, Real *sum)
+{
+    const Partition *part = &(ws->space.part);
+    Real Fhat[DIMU] = {0.0};
+    long callN = 0;
+    for (int k = part->ns[PIN][Z][MIN]; k < part->ns[PIN][Z][MAX]; ++k) {
+        for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
+            for (int i = part->ns[PIN][X][MIN] - 1; i < part->ns[PIN][X][MAX]; ++i) {
+                WENO5M(TO, X, k, j, i, part->n, ws->space.node, &(ws->model), Fhat);
+                *sum = *sum + Fhat[1];
+                ++callN;
+            }
+        }
+    }
+    return callN;
+}
+static long SweepEigenvector(const Workspace *ws, Real *sum)
+{
+    const Partition *part = &(ws->space.part);
+    const Node *const node = ws->space.node;
+    const Model *model = &(ws->model);
+    Real Uo[DIMUo] = {0.0};
+    Real L[DIMU][DIMU] = {{0.0}};
+    Real R[DIMU][DIMU] = {{0.0}};
+    int idxL = 0;
+    int idxR = 0;
+    long callN = 0;
+    for (int k = part->ns[PIN][Z][MIN]; k < part->ns[PIN][Z][MAX]; ++k) {
+        for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
+            for (int i = part->ns[PIN][X][MIN] - 1; i < part->ns[PIN][X][MAX]; ++i) {
+                idxL = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                idxR = IndexNode(k, j, i + 1, part->n[Y], part->n[X]);
+                SymmetricAverage(model->jacobMean, model->gamma, node[idxL].U[TO], node[idxR].U[TO], Uo);
+                EigenvectorL(X, model->gamma, Uo, L);
+                EigenvectorR(X, Uo, R);
+                *sum = *sum + L[1][1] + R[1][1];
+                ++callN;
+            }
+        }
+    }
+    return callN;
+}
+/*
+ * A call projects a stencil of six vectors onto the characteristic fields
+ * and a flux vector back, as WENO5 does per interface.
+ */
+static long SweepEigenvectorProjection(const Workspace *ws, Real *sum)
+{
+    const Partition *part = &(ws->space.part);
+    const Node *const node = ws->space.node;
+    const Model *model = &(ws->model);
+    Real Uo[DIMUo] = {0.0};
+    Real U[6][DIMU] = {{0.0}};
+    Real W[6][DIMU] = {{0.0}};
+    Real Fhat[DIMU] = {0.0};
+    int idx = 0;
+    long callN = 0;
+    for (int k = part->ns[PIN][Z][MIN]; k < part->ns[PIN][Z][MAX]; ++k) {
+        for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
+            for (int i = part->ns[PIN][X][MIN] - 1; i < part->ns[PIN][X][MAX]; ++i) {
+                for (int n = 0; n < 6; ++n) {
+                    idx = IndexNode(k, j, i + n - 2, part->n[Y], part->n[X]);
+                    for (int dim = 0; dim < DIMU; ++dim) {
+                        U[n][dim] = node[idx].U[TO][dim];
+                    }
+                }
+                SymmetricAverage(model->jacobMean, model->gamma, U[2], U[3], Uo);
+                EigenvectorProjectL(X, model->gamma, Uo, 6, U[0], W[0]);
+                EigenvectorProjectR(X, Uo, 1, W[2], Fhat);
+                *sum = *sum + W[2][1] + Fhat[1];
+                ++callN;
+            }
+        }
+    }
+    return callN;
+}
+static long SweepDiffusiveFlux(const Workspace *ws, Real *sum)
+{
+    const Partition *part = &(ws->space.part);
+    Real Fvhat[DIMU] = {0.0};
+    long callN = 0;
+    for (int k = part->ns[PIN][Z][MIN]; k < part->ns[PIN][Z][MAX]; ++k) {
+        for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
+            for (int i = part->ns[PIN][X][MIN] - 1; i < part->ns[PIN][X][MAX]; ++i) {
+                NumericalDiffusiveFluxX(TO, k, j, i, part->n, part->dd, ws->space.node, &(ws->model), Fvhat);
+                *sum = *sum + Fvhat[4];
+                ++callN;
+            }
+        }
+    }
+    return callN;
+}
+static long SweepPointTriangleDistance(const Workspace *ws, Real *sum)
+{
+    RealVec para = {0.0};
+    long callN = 0;
+    for (int m = 0; m < POINTN; m = m + 16) {
+        for (int n = 0; n < TRIN; ++n) {
+            *sum = *sum + PointTriangleDistance(ws->p[m], ws->tri[n][0], ws->tri[n][1], ws->tri[n][2], para);
+            ++callN;
+        }
+    }
+    return callN;
+}
+static long SweepPointInPolyhedron(const Workspace *ws, Real *sum)
+{
+    int fid = 0;
+    long callN = 0;
+    for (int n = 0; n < POINTN; ++n) {
+        *sum = *sum + PointInPolyhedron(ws->p[n], ws->geo.poly, &fid) + fid;
+        ++callN;
+    }
+    return callN;
+}
+/*
+ * Interpolate at points offset from the fluid nodes, with the normal node
+ * type and the smallest search range used by the flow reconstruction.
+ */
+static long SweepInverseDistanceWeighting(const Workspace *ws, Real *sum)
+{
+    const Partition *part = &(ws->space.part);
+    const Real offset = 0.3;
+    Real Uo[DIMUo] = {0.0};
+    IntVec n = {0};
+    RealVec p = {0.0};
+    long callN = 0;
+    for (int k = part->ns[PIN][Z][MIN]; k < part->ns[PIN][Z][MAX]; ++k) {
+        for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
+            for (int i = part->ns[PIN][X][MIN]; i < part->ns[PIN][X][MAX]; ++i) {
+                n[X] = i;
+                n[Y] = j;
+                n[Z] = k;
+                p[X] = PointSpace(i, part->domain[X][MIN], part->d[X], part->ng) + offset * part->d[X];
+                p[Y] = PointSpace(j, part->domain[Y][MIN], part->d[Y], part->ng) + offset * part->d[Y];
+                p[Z] = PointSpace(k, part->domain[Z][MIN], part->d[Z], part->ng) + offset * part->d[Z];
+                *sum = *sum + InverseDistanceWeighting(TO, n, p, 1, NONE, 0, part,
+                        ws->space.node, &(ws->space.cache), &(ws->model), Uo);
+                ++callN;
+            }
+        }
+    }
+    return callN;
+}
+/*
+ * The matrix is overwritten by its LU decomposition, a copy is solved.
+ */
+static long SweepLinearSystem(const Workspace *ws, Real *sum)
+{
+    Real A[DIMS][DIMS] = {{0.0}};
+    Real x[DIMS][1] = {{0.0}};
+    long callN = 0;
+    for (int n = 0; n < SYSN; ++n) {
+        for (int r = 0; r < DIMS; ++r) {
+            for (int c = 0; c < DIMS; ++c) {
+                A[r][c] = ws->A[n][r][c];
+            }
+        }
+        MatrixLinearSystemSolver(DIMS, A, 1, x, ws->B[n]);
+        *sum = *sum + x[0][0] + x[1][0] + x[2][0];
+        ++callN;
+    }
+    return callN;
+}
+/* a good practice: end file with a newline */
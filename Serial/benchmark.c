@@ -0,0 +1,265 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include "benchmark.h"
+#include <stdio.h> /* standard library for input and output */
+#include <math.h> /* common mathematical functions */
+#include <float.h> /* size of floating point values */
+#include <sys/resource.h> /* resource usage */
+#include "cfd_parameters.h"
+#include "domain_partition.h"
+#include "computational_geometry.h"
+#include "immersed_boundary.h"
+#include "numerical_test.h"
+#include "fluid_dynamics.h"
+#include "solve.h"
+#include "timer.h"
+#include "cfd_commons.h"
+#include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+typedef enum {
+    NSIZE = 3, /* number of grid sizes of each case */
+    NBENCH = 4, /* number of benchmark cases */
+} BenchConstants;
+/*
+ * Benchmark case
+ */
+typedef struct {
+    const char *name; /* case name */
+    int test; /* test case of the field */
+    int stepN; /* number of steps */
+    int size[NSIZE]; /* mesh number of non collapsed dimensions */
+    IntVec collapse; /* collapsed dimensions */
+    int typeBC; /* boundary type of non collapsed dimensions */
+    int sphN; /* number of static spheres at the domain center */
+    Real refMu; /* viscous level */
+    Real Uo[VARIC]; /* reference state: rho, u, v, w, p */
+    Real domain[DIMS][LIMIT]; /* space domain */
+} BenchCase;
+/*
+ * Benchmark phases
+ */
+typedef struct {
+    double setup; /* case generation and initialization */
+    double step; /* time step computation */
+    double fluid; /* fluid dynamics */
+    double total; /* whole run */
+} Phase;
+/****************************************************************************
+ * Static Function Declarations
+ ****************************************************************************/
+static void RunCase(const BenchCase *, const int, const int);
+static void GenerateCase(const BenchCase *, const int, Time *, Space *, Model *);
+static void InitializeCase(const BenchCase *, Space *, const Model *);
+static void ReleaseCase(Space *);
+static long PeakResidentSetSize(void);
+/****************************************************************************
+ * Global Variables Definition with Private Scope
+ ****************************************************************************/
+/*
+ * The inflow boundary with the static sphere is the west boundary, and
+ * the reference state is normalized such that the gas constant is 1.
+ */
+static const BenchCase benchCase[NBENCH] = {
+    {"vortex2d", VORTEX, 10, {64, 128, 256}, {0, 0, 1}, PERIODIC, 0, 0.0,
+        {1.0, 1.0, 1.0, 0.0, 1.0}, {{-5.0, 5.0}, {-5.0, 5.0}, {-0.5, 0.5}}},
+    {"taylorgreen3d", TAYLORGREEN, 5, {16, 24, 32}, {0, 0, 0}, PERIODIC, 0, 1.0,
+        {1.0, 1.0, 1.0, 0.0, 71.4286}, {{-3.14159265359, 3.14159265359}, 
+            {-3.14159265359, 3.14159265359}, {-3.14159265359, 3.14159265359}}},
+    {"shocktube1d", SHOCKTUBE, 50, {400, 800, 1600}, {0, 1, 1}, OUTFLOW, 0, 0.0,
+        {0.125, 0.0, 0.0, 0.0, 0.1}, {{-0.5, 0.5}, {-0.5, 0.5}, {-0.5, 0.5}}},
+    {"sphere2d", UNIFORM, 10, {64, 128, 256}, {0, 0, 1}, OUTFLOW, 1, 0.0,
+        {1.0, 0.5, 0.0, 0.0, 1.0}, {{-2.0, 2.0}, {-2.0, 2.0}, {-0.5, 0.5}}}
+};
+/****************************************************************************
+ * Function definitions
+ ****************************************************************************/
+int Benchmark(void)
+{
+    fprintf(stdout, "{\n");
+    fprintf(stdout, "  \"program\": \"artracfd\",\n");
+    fprintf(stdout, "  \"real\": %d,\n", (int)sizeof(Real));
+    fprintf(stdout, "  \"cases\": [\n");
+    for (int n = 0; n < NBENCH; ++n) {
+        for (int m = 0; m < NSIZE; ++m) {
+            RunCase(benchCase + n, m, (NBENCH - 1 == n) && (NSIZE - 1 == m));
+        }
+    }
+    fprintf(stdout, "  ]\n");
+    fprintf(stdout, "}\n");
+    return 0;
+}
+static void RunCase(const BenchCase *bc, const int m, const int last)
+{
+    Time time = {0};
+    Space space = {0};
+    Model model = {0};
+    Phase phase = {0};
+    Timer timer; /* timer for the whole run */
+    Timer timerPhase; /* timer for each phase */
+    Real dt = 0.0;
+    TickTime(&timer);
+    GenerateCase(bc, m, &time, &space, &model);
+    InitializeCase(bc, &space, &model);
+    phase.setup = TockTime(&timer);
+    while (time.stepC < time.stepN) {
+        ++(time.stepC);
+        TickTime(&timerPhase);
+        dt = ComputeTimeStep(&time, &space, &model);
+        phase.step = phase.step + TockTime(&timerPhase);
+        time.now = time.now + dt;
+        TickTime(&timerPhase);
+        FluidDynamics(dt, &space, &model);
+        phase.fluid = phase.fluid + TockTime(&timerPhase);
+    }
+    phase.total = TockTime(&timer);
+    const Partition *part = &(space.part);
+    const long nodeN = (long)(part->ns[PIN][X][MAX] - part->ns[PIN][X][MIN]) *
+        (part->ns[PIN][Y][MAX] - part->ns[PIN][Y][MIN]) * (part->ns[PIN][Z][MAX] - part->ns[PIN][Z][MIN]);
+    fprintf(stdout, "    {\n");
+    fprintf(stdout, "      \"case\": \"%s\",\n", bc->name);
+    fprintf(stdout, "      \"mesh\": [%d, %d, %d],\n", (0 != bc->collapse[X]) ? 1 : bc->size[m],
+            (0 != bc->collapse[Y]) ? 1 : bc->size[m], (0 != bc->collapse[Z]) ? 1 : bc->size[m]);
+    fprintf(stdout, "      \"nodes\": %ld,\n", nodeN);
+    fprintf(stdout, "      \"steps\": %d,\n", time.stepC);
+    fprintf(stdout, "      \"time\": {\"setup\": %.6g, \"step\": %.6g, \"fluid\": %.6g, \"total\": %.6g},\n",
+            phase.setup, phase.step, phase.fluid, phase.total);
+    fprintf(stdout, "      \"cell_updates_per_second\": %.6g,\n", 
+            (double)nodeN * time.stepC / MaxReal(phase.fluid + phase.step, DBL_MIN));
+    fprintf(stdout, "      \"peak_rss_kb\": %ld\n", PeakResidentSetSize());
+    fprintf(stdout, "    }%s\n", (0 == last) ? "," : "");
+    fflush(stdout);
+    ReleaseCase(&space);
+    return;
+}
+/*
+ * Set the data that are normally loaded from case files, then compute
+ * parameters and partition the domain as the preprocessor does.
+ */
+static void GenerateCase(const BenchCase *bc, const int m, Time *time, Space *space, Model *model)
+{
+    Partition *part = &(space->part);
+    Geometry *geo = &(space->geo);
+    /* space */
+    for (int s = 0; s < DIMS; ++s) {
+        part->m[s] = bc->size[m];
+        if (0 != bc->collapse[s]) {
+            part->m[s] = 1;
+        }
+        part->domain[s][MIN] = bc->domain[s][MIN];
+        part->domain[s][MAX] = bc->domain[s][MAX];
+    }
+    /* time */
+    time->end = 1.0e30;
+    time->numCFL = 0.6;
+    time->stepN = bc->stepN;
+    /* numerical */
+    model->tScheme = 1;
+    model->sScheme = WENOFIVE;
+    model->ibmLayer = 1;
+    /* material and reference */
+    model->refMu = bc->refMu;
+    model->refL = 1.0;
+    model->refRho = 1.0;
+    model->refT = 300.0;
+    model->refV = sqrt(287.058 * model->refT);
+    /* initialization and boundary */
+    part->countIC = 1;
+    for (int n = 0; n < VARIC; ++n) {
+        part->valueIC[0][ENTRYIC-VARIC+n] = bc->Uo[n];
+        part->valueBC[PWB][n] = bc->Uo[n];
+    }
+    for (int s = 0; s < DIMS; ++s) {
+        part->typeBC[PWB+2*s] = OUTFLOW;
+        part->typeBC[PEB+2*s] = OUTFLOW;
+        if (0 == bc->collapse[s]) {
+            part->typeBC[PWB+2*s] = bc->typeBC;
+            part->typeBC[PEB+2*s] = bc->typeBC;
+        }
+    }
+    if (0 < bc->sphN) {
+        part->typeBC[PWB] = INFLOW;
+    }
+    /* geometry */
+    geo->sphN = bc->sphN;
+    ComputeParameters(time, space, model);
+    DomainPartition(space);
+    /* storage */
+    space->node = AssignStorage(part->n[X] * part->n[Y] * part->n[Z] * sizeof(*space->node));
+    if (0 != geo->totN) {
+        geo->col = AssignStorage(geo->totN * sizeof(*geo->col));
+        geo->poly = AssignStorage(geo->totN * sizeof(*geo->poly));
+    }
+    return;
+}
+/*
+ * Spheres are stationary, they are flagged as stationary after the
+ * initial node mapping, the same as the initializer does.
+ */
+static void InitializeCase(const BenchCase *bc, Space *space, const Model *model)
+{
+    const Partition *restrict part = &(space->part);
+    Geometry *geo = &(space->geo);
+    Polyhedron *poly = NULL;
+    const int idxMax = part->n[X] * part->n[Y] * part->n[Z];
+    for (int idx = 0; idx < idxMax; ++idx) {
+        space->node[idx].gid = NONE;
+        space->node[idx].fid = NONE;
+        space->node[idx].lid = NONE;
+        space->node[idx].gst = NONE;
+    }
+    for (int n = 0; n < geo->totN; ++n) {
+        poly = geo->poly + n;
+        poly->r = 0.25 * (part->domain[Y][MAX] - part->domain[Y][MIN]) / geo->totN;
+        poly->rho = 1.0e37;
+        poly->T = -1.0;
+        poly->to = 1.0e30;
+        for (int s = 0; s < DIMS; ++s) {
+            poly->O[s] = 0.5 * (part->domain[s][MIN] + part->domain[s][MAX]);
+        }
+    }
+    ComputeGeometryParameters(part->collapse, geo);
+    ComputeGeometryDomain(space, model);
+    for (int n = 0; n < geo->totN; ++n) {
+        geo->poly[n].state = 1;
+    }
+    SetField(TO, bc->test, space, model);
+    return;
+}
+static void ReleaseCase(Space *space)
+{
+    Geometry *geo = &(space->geo);
+    RetrieveArenaStorage(&(geo->arena));
+    RetrieveStorage(geo->poly);
+    RetrieveStorage(geo->col);
+    ReleaseGeometryDomain(space);
+    RetrieveStorage(space->node);
+    ReleaseDomainPartition(space);
+    return;
+}
+/*
+ * Peak resident set size of the process in kilobytes. The peak is a
+ * process-wide quantity, hence it is the maximum over all cases run so far.
+ * Grid sizes of each case are run in growing order for this reason.
+ */
+static long PeakResidentSetSize(void)
+{
+    struct rusage usage;
+    if (0 != getrusage(RUSAGE_SELF, &usage)) {
+        return 0;
+    }
+    return usage.ru_maxrss;
+}
+/* a good practice: end file with a newline */
@@ -0,0 +1,36 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Header File Guards to Avoid Interdependence
+ ****************************************************************************/
+#ifndef ARTRACFD_BENCHMARK_H_ /* if this is the first definition */
+#define ARTRACFD_BENCHMARK_H_ /* a unique marker for this header file */
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+/****************************************************************************
+ * Public Functions Declaration
+ ****************************************************************************/
+/*
+ * Benchmark
+ *
+ * Function
+ *      Generate standard cases in memory, run each case for a fixed number
+ *      of steps at several grid sizes, and write the performance data to
+ *      the standard output in JSON format. No case file is required.
+ */
+extern int Benchmark(void);
+#endif
+/* a good practice: end file with a newline */
@@ -14,13 +14,14 @@
 #include "boundary_treatment.h"
 #include <stdio.h> /* standard library for input and output */
 #include "immersed_boundary.h"
+#include "primitive_cache.h"
+#include "trace.h"
 #include "cfd_commons.h"
 #include "commons.h"
 /****************************************************************************
  * Static Function Declarations
  ****************************************************************************/
-static void ApplyBoundaryConditions(const int, const int, int [restrict][LIMIT],
-        const int, Space *, const Model *);
+static void ApplyBoundaryConditions(const int, const BCList *, const int, Space *, const Model *);
 static void ZeroGradient(const Real [restrict], Real [restrict]);
 /****************************************************************************
  * Function definitions
@@ -44,35 +45,41 @@ void BoundaryConditionsAndTreatments(const int tn, Space *space, const Model *mo
      * mixed derivatives as in viscous fluxes, or for transfer operators
      * within multigrid. To treat the entire ghost region, the boundary
      * treatment should be performed one box layer by one box layer from
-     * inside to outside.
+     * inside to outside. The node lists of the box layers are prepared by
+     * the domain partition in this order. The primitive cache of each box
+     * is refreshed right after the box is treated, hence the cache agrees
+     * with the field data throughout the treatment. Only the boundary
+     * layer and the first ghost layer are cached, which cover all the
+     * nodes that are read around the inner region.
      */
     const Partition *restrict part = &(space->part);
-    int box[DIMS][LIMIT] = {{0}}; /* range box of regions */
+    const BCList *bcl = NULL;
+    TraceBegin("domain boundary");
     for (int r = 0; r <= part->ng; ++r) { /* process layer by layer */
         for (int p = PWB; p < PWG; ++p) {
-            const IntVec N = {part->N[p][X], part->N[p][Y], part->N[p][Z]};
-            for (int s = 0; s < DIMS; ++s) { /* compute range box of each layer */
-                box[s][MIN] = part->ns[p][s][MIN] + r * (N[s] - !N[s]);
-                box[s][MAX] = part->ns[p][s][MAX] + r * (N[s] + !N[s]);
+            bcl = &(part->bcl[p][r]);
+            ApplyBoundaryConditions(p, bcl, tn, space, model);
+            if (1 >= r) {
+                CacheBoxPrimitive(tn, bcl->box, space, model);
             }
-            ApplyBoundaryConditions(p, r, box, tn, space, model);
         }
     }
+    TraceEnd("domain boundary");
     return;
 }
-static void ApplyBoundaryConditions(const int p, const int r, int box[restrict][LIMIT],
-        const int tn, Space *space, const Model *model)
+/*
+ * Always remember that boundary conditions should be based on primitive
+ * variables rather than conservative variables. The operation is the same
+ * for all nodes of a list, hence each operation is a plain loop over the
+ * node indices of the list.
+ */
+static void ApplyBoundaryConditions(const int p, const BCList *bcl, const int tn,
+        Space *space, const Model *model)
 {
     const Partition *restrict part = &(space->part);
     Node *const node = space->node;
-    Real *restrict UG = NULL;
-    Real *restrict UI = NULL;
-    Real *restrict UO = NULL;
-    Real *restrict Uh = NULL;
-    int idxG = 0; /* index at ghost node */
-    int idxI = 0; /* index at image node */
-    int idxO = 0; /* index at boundary point */
-    int idxh = 0; /* index at neighbouring point */
+    const Cache *cache = &(space->cache);
+    int (*const idx)[BCIDX] = bcl->idx; /* target, donor, image */
     const Real zero = 0.0;
     Real UoG[DIMUo] = {zero};
     Real UoI[DIMUo] = {zero};
@@ -86,96 +93,60 @@ static void ApplyBoundaryConditions(const int p, const int r, int box[restrict][
         part->valueBC[p][4],
         part->valueBC[p][5]};
     const IntVec N = {part->N[p][X], part->N[p][Y], part->N[p][Z]};
-    const IntVec LN = {part->m[X] * N[X], part->m[Y] * N[Y], part->m[Z] * N[Z]};
-    for (int k = box[Z][MIN]; k < box[Z][MAX]; ++k) {
-        for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
-            for (int i = box[X][MIN]; i < box[X][MAX]; ++i) {
-                /*
-                 * Apply boundary conditions for current node, always remember
-                 * that boundary conditions should be based on primitive
-                 * variables rather than conservative variables.
-                 */
-                if (0 != r) { /* treat ghost layers */
-                    idxG = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                    UG = node[idxG].U[tn];
-                    switch (part->typeBC[p]) {
-                        case SLIPWALL:
-                        case NOSLIPWALL:
-                            idxO = IndexNode(k - r*N[Z], j - r*N[Y], i - r*N[X], part->n[Y], part->n[X]);
-                            UO = node[idxO].U[tn];
-                            PrimitiveByConservative(model->gamma, model->gasR, UO, UoO);
-                            idxI = IndexNode(k - 2*r*N[Z], j - 2*r*N[Y], i - 2*r*N[X], part->n[Y], part->n[X]);
-                            UI = node[idxI].U[tn];
-                            PrimitiveByConservative(model->gamma, model->gasR, UI, UoI);
-                            MethodOfImage(UoI, UoO, UoG);
-                            UoG[0] = UoG[4] / (UoG[5] * model->gasR); /* compute density */
-                            ConservativeByPrimitive(model->gamma, UoG, UG);
-                            break;
-                        case PERIODIC:
-                            idxh = IndexNode(k - LN[Z], j - LN[Y], i - LN[X], part->n[Y], part->n[X]);
-                            Uh = node[idxh].U[tn];
-                            ZeroGradient(Uh, UG);
-                            break;
-                        default:
-                            idxh = IndexNode(k - N[Z], j - N[Y], i - N[X], part->n[Y], part->n[X]);
-                            Uh = node[idxh].U[tn];
-                            ZeroGradient(Uh, UG);
-                            break;
-                    }
-                    continue;
+    switch (bcl->op) {
+        case BCVALUE:
+            for (int m = 0; m < bcl->n; ++m) {
+                ConservativeByPrimitive(model->gamma, UoGiven, node[idx[m][0]].U[tn]);
+            }
+            break;
+        case BCCOPY: /* zero gradient or periodic */
+            for (int m = 0; m < bcl->n; ++m) {
+                ZeroGradient(node[idx[m][1]].U[tn], node[idx[m][0]].U[tn]);
+            }
+            break;
+        case BCSLIP: /* zero-gradient for scalar and tangential component, zero for normal component */
+            for (int m = 0; m < bcl->n; ++m) {
+                NodePrimitive(tn, idx[m][1], node, cache, model, Uoh);
+                UoO[1] = (!N[X]) * Uoh[1];
+                UoO[2] = (!N[Y]) * Uoh[2];
+                UoO[3] = (!N[Z]) * Uoh[3];
+                UoO[4] = Uoh[4]; /* zero normal gradient of pressure */
+                if (zero > UoGiven[5]) { /* adiabatic, dT/dn = 0 */
+                    UoO[5] = Uoh[5];
+                } else { /* otherwise, use specified constant wall temperature, T = Tw */
+                    UoO[5] = UoGiven[5];
                 }
-                idxO = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                UO = node[idxO].U[tn];
-                switch (part->typeBC[p]) { /* treat physical boundary */
-                    case INFLOW:
-                        ConservativeByPrimitive(model->gamma, UoGiven, UO);
-                        break;
-                    case OUTFLOW:
-                        /* Calculate inner neighbour nodes according to normal vector direction. */
-                        idxh = IndexNode(k - N[Z], j - N[Y], i - N[X], part->n[Y], part->n[X]);
-                        Uh = node[idxh].U[tn];
-                        ZeroGradient(Uh, UO);
-                        break;
-                    case SLIPWALL: /* zero-gradient for scalar and tangential component, zero for normal component */
-                        idxh = IndexNode(k - N[Z], j - N[Y], i - N[X], part->n[Y], part->n[X]);
-                        Uh = node[idxh].U[tn];
-                        PrimitiveByConservative(model->gamma, model->gasR, Uh, Uoh);
-                        UoO[1] = (!N[X]) * Uoh[1];
-                        UoO[2] = (!N[Y]) * Uoh[2];
-                        UoO[3] = (!N[Z]) * Uoh[3];
-                        UoO[4] = Uoh[4]; /* zero normal gradient of pressure */
-                        if (zero > UoGiven[5]) { /* adiabatic, dT/dn = 0 */
-                            UoO[5] = Uoh[5];
-                        } else { /* otherwise, use specified constant wall temperature, T = Tw */
-                            UoO[5] = UoGiven[5];
-                        }
-                        UoO[0] = UoO[4] / (UoO[5] * model->gasR); /* compute density */
-                        ConservativeByPrimitive(model->gamma, UoO, UO);
-                        break;
-                    case NOSLIPWALL:
-                        idxh = IndexNode(k - N[Z], j - N[Y], i - N[X], part->n[Y], part->n[X]);
-                        Uh = node[idxh].U[tn];
-                        PrimitiveByConservative(model->gamma, model->gasR, Uh, Uoh);
-                        UoO[1] = zero;
-                        UoO[2] = zero;
-                        UoO[3] = zero;
-                        UoO[4] = Uoh[4]; /* zero normal gradient of pressure */
-                        if (zero > UoGiven[5]) { /* adiabatic, dT/dn = 0 */
-                            UoO[5] = Uoh[5];
-                        } else { /* otherwise, use specified constant wall temperature, T = Tw */
-                            UoO[5] = UoGiven[5];
-                        }
-                        UoO[0] = UoO[4] / (UoO[5] * model->gasR); /* compute density */
-                        ConservativeByPrimitive(model->gamma, UoO, UO);
-                        break;
-                    case PERIODIC:
-                        /* no treatment needed since global boundary participate normal computation*/
-                        break;
-                    default:
-                        break;
+                UoO[0] = UoO[4] / (UoO[5] * model->gasR); /* compute density */
+                ConservativeByPrimitive(model->gamma, UoO, node[idx[m][0]].U[tn]);
+            }
+            break;
+        case BCNOSLIP:
+            for (int m = 0; m < bcl->n; ++m) {
+                NodePrimitive(tn, idx[m][1], node, cache, model, Uoh);
+                UoO[1] = zero;
+                UoO[2] = zero;
+                UoO[3] = zero;
+                UoO[4] = Uoh[4]; /* zero normal gradient of pressure */
+                if (zero > UoGiven[5]) { /* adiabatic, dT/dn = 0 */
+                    UoO[5] = Uoh[5];
+                } else { /* otherwise, use specified constant wall temperature, T = Tw */
+                    UoO[5] = UoGiven[5];
                 }
+                UoO[0] = UoO[4] / (UoO[5] * model->gasR); /* compute density */
+                ConservativeByPrimitive(model->gamma, UoO, node[idx[m][0]].U[tn]);
             }
-        }
+            break;
+        case BCIMAGE:
+            for (int m = 0; m < bcl->n; ++m) {
+                NodePrimitive(tn, idx[m][1], node, cache, model, UoO);
+                NodePrimitive(tn, idx[m][2], node, cache, model, UoI);
+                MethodOfImage(UoI, UoO, UoG);
+                UoG[0] = UoG[4] / (UoG[5] * model->gasR); /* compute density */
+                ConservativeByPrimitive(model->gamma, UoG, node[idx[m][0]].U[tn]);
+            }
+            break;
+        default:
+            break;
     }
     return;
 }
@@ -187,4 +158,3 @@ static void ZeroGradient(const Real Uh[restrict], Real U[restrict])
     return;
 }
 /* a good practice: end file with a newline */
-
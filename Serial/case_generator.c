@@ -70,7 +70,7 @@ static int CaseSettingFileGenerator(void)
     fprintf(filePointer, "1.2                # CFL condition number in (0, 2]\n");
     fprintf(filePointer, "0                  # maximum computing steps (integer; 0: automatic)\n");
     fprintf(filePointer, "1                  # field data writing frequency (integer; 0: infinity)\n");
-    fprintf(filePointer, "1                  # data streamer (integer; 0: ParaView; 1: Ensight)\n");
+    fprintf(filePointer, "1                  # data streamer (integer; 0: ParaView; 1: Ensight; 2: ParaView pieces; 3: quantized)\n");
     fprintf(filePointer, "time end\n");
     fprintf(filePointer, "#------------------------------------------------------------------------------\n");
     fprintf(filePointer, "#\n");
@@ -80,13 +80,23 @@ static int CaseSettingFileGenerator(void)
     fprintf(filePointer, "#------------------------------------------------------------------------------\n");
     fprintf(filePointer, "numerical begin\n");
     fprintf(filePointer, "1                  # temporal scheme (integer; 0: RK2; 1: RK3;)\n");
-    fprintf(filePointer, "1                  # spatial scheme (integer; 0: WENO3; 1: WENO5;)\n");
+    fprintf(filePointer, "1                  # spatial scheme (integer; 0: WENO3; 1: WENO5; 2: WENO5-Z; 3: WENO5-M)\n");
     fprintf(filePointer, "0                  # multidimensional method (integer; 0: dim split; 1: dim by dim)\n");
     fprintf(filePointer, "0                  # Jacobian average (integer; 0: Arithmetic mean; 1: Roe averages)\n");
     fprintf(filePointer, "0                  # flux splitting method (integer; 0: LLF; 1: SW)\n");
     fprintf(filePointer, "0                  # phase interaction (integer; 0: F; 1: FSI; 2: FSI+SSI)\n");
     fprintf(filePointer, "1                  # layers for reconstruction (integer; 0: infinity)\n");
     fprintf(filePointer, "numerical end\n");
+    fprintf(filePointer, "#\n");
+    fprintf(filePointer, "#refinement begin\n");
+    fprintf(filePointer, "#1                 # mesh refinement (integer; 0: off; 1: on)\n");
+    fprintf(filePointer, "#0.05              # threshold of relative density variation (real)\n");
+    fprintf(filePointer, "#10                # regridding frequency (integer; 0: once)\n");
+    fprintf(filePointer, "#refinement end\n");
+    fprintf(filePointer, "#\n");
+    fprintf(filePointer, "#cache begin\n");
+    fprintf(filePointer, "#1                 # primitive cache (integer; 0: off; 1: u, v, w, T; 2: rho, u, v, w, p, T)\n");
+    fprintf(filePointer, "#cache end\n");
     fprintf(filePointer, "#------------------------------------------------------------------------------\n");
     fprintf(filePointer, "#\n");
     fprintf(filePointer, "#                        >> Material Properties <<\n");
@@ -259,6 +269,65 @@ static int CaseSettingFileGenerator(void)
     fprintf(filePointer, "500                # resolution (points on line)\n");
     fprintf(filePointer, "line probe end\n");
     fprintf(filePointer, "#------------------------------------------------------------------------------\n");
+    fprintf(filePointer, "#\n");
+    fprintf(filePointer, "#                       >> Region Outputs <<\n");
+    fprintf(filePointer, "#\n");
+    fprintf(filePointer, "# Field data in a box sub-sampled by a stride, written by the data streamer.\n");
+    fprintf(filePointer, "# Available variables: rho, u, v, w, p, T, gid, fid, lid, gst, Vel\n");
+    fprintf(filePointer, "#------------------------------------------------------------------------------\n");
+    fprintf(filePointer, "#\n");
+    fprintf(filePointer, "#region output begin\n");
+    fprintf(filePointer, "#-0.5, -0.5, -0.5  # xmin, ymin, zmin of box\n");
+    fprintf(filePointer, "#0.5, 0.5, 0.5     # xmax, ymax, zmax of box\n");
+    fprintf(filePointer, "#1, 1, 1           # x, y, z stride (integer; 1: full resolution)\n");
+    fprintf(filePointer, "#rho, p, Vel       # output variables\n");
+    fprintf(filePointer, "#10                # writing frequency (integer; 0: infinity)\n");
+    fprintf(filePointer, "#region output end\n");
+    fprintf(filePointer, "#------------------------------------------------------------------------------\n");
+    fprintf(filePointer, "#\n");
+    fprintf(filePointer, "#                      >> Quantized Output <<\n");
+    fprintf(filePointer, "#\n");
+    fprintf(filePointer, "# Lossy field data of data streamer 3, converted to ParaView by '-m convert'.\n");
+    fprintf(filePointer, "#------------------------------------------------------------------------------\n");
+    fprintf(filePointer, "#quantization begin\n");
+    fprintf(filePointer, "#1                 # error bound mode (integer; 0: absolute; 1: relative to value range)\n");
+    fprintf(filePointer, "#1.0e-4            # error bound (0: default, relative 1.0e-4)\n");
+    fprintf(filePointer, "#quantization end\n");
+    fprintf(filePointer, "#------------------------------------------------------------------------------\n");
+    fprintf(filePointer, "#\n");
+    fprintf(filePointer, "#                      >> Geometry Output <<\n");
+    fprintf(filePointer, "#\n");
+    fprintf(filePointer, "# Mode 1 writes polyhedra once to geo_stl_topo.vtp and then per output only\n");
+    fprintf(filePointer, "# the rigid transforms of moving polyhedra to geo_stlNNNNN.tf.\n");
+    fprintf(filePointer, "#------------------------------------------------------------------------------\n");
+    fprintf(filePointer, "#geometry output begin\n");
+    fprintf(filePointer, "#1                 # output mode (integer; 0: full polyhedra; 1: topology and transforms)\n");
+    fprintf(filePointer, "#geometry output end\n");
+    fprintf(filePointer, "#------------------------------------------------------------------------------\n");
+    fprintf(filePointer, "#\n");
+    fprintf(filePointer, "#                         >> Statistics <<\n");
+    fprintf(filePointer, "#\n");
+    fprintf(filePointer, "# Time averaged means, rms and uv, vw, wu covariances of fluid nodes over cells\n");
+    fprintf(filePointer, "# of a block of nodes per axis, written once to statistics.vts at the end and\n");
+    fprintf(filePointer, "# checkpointed to statisticsNNNNN.chk with each field data for restart.\n");
+    fprintf(filePointer, "#------------------------------------------------------------------------------\n");
+    fprintf(filePointer, "#statistics begin\n");
+    fprintf(filePointer, "#1                 # nodes per axis of a cell (integer; 0: off; 1: per node)\n");
+    fprintf(filePointer, "#0.0               # start time of statistics\n");
+    fprintf(filePointer, "#statistics end\n");
+    fprintf(filePointer, "#------------------------------------------------------------------------------\n");
+    fprintf(filePointer, "#\n");
+    fprintf(filePointer, "#                       >> Residual Monitor <<\n");
+    fprintf(filePointer, "#\n");
+    fprintf(filePointer, "# L2 and Linf norms of the changes per time step divided by dt of conservative\n");
+    fprintf(filePointer, "# variables, logged to residual.csv; the computation stops once the L2 norms of\n");
+    fprintf(filePointer, "# all variables are within the tolerance.\n");
+    fprintf(filePointer, "#------------------------------------------------------------------------------\n");
+    fprintf(filePointer, "#residual begin\n");
+    fprintf(filePointer, "#10                # monitor interval of steps (integer; 0: off)\n");
+    fprintf(filePointer, "#1.0e-6            # tolerance of steady state (0: no termination)\n");
+    fprintf(filePointer, "#residual end\n");
+    fprintf(filePointer, "#------------------------------------------------------------------------------\n");
     fprintf(filePointer, "#------------------------------------------------------------------------------\n");
     fprintf(filePointer, "#/* a good practice: end file with a newline */\n");
     fprintf(filePointer, "\n");
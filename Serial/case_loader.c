@@ -22,10 +22,15 @@ static int ReadCaseSettingData(Time *, Space *, Model *);
 static int ReadGeometrySettingData(Geometry *);
 static int ReadBoundaryData(FILE *, Space *, const int);
 static int ReadConsecutiveRealData(FILE *, Real *, const int);
+static int ReadOutputVariable(char *);
 static int WriteBoundaryData(FILE *, const Space *, const int);
 static int WriteInitializerData(FILE *, const Space *, const int);
 static int WriteVerifyData(const Time *, const Space *, const Model *);
 static int CheckCaseSettingData(const Time *, const Space *, const Model *);
+/****************************************************************************
+ * Global Variables Definition with Private Scope
+ ****************************************************************************/
+static const char varOut[VAROUT][5] = {"rho", "u", "v", "w", "p", "T", "gid", "fid", "lid", "gst", "Vel"};
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
@@ -270,10 +275,10 @@ static int ReadCaseSettingData(Time *time, Space *space, Model *model)
             nscan = sscanf(currentLine, "%d", &(time->forceProbeN)); 
             VerifyReadConversion(nscan, 1);
             if (0 < time->pointProbeN) {
-                time->pp = AssignStorage(time->pointProbeN * sizeof(*time->pp));
+                time->pp = AssignArenaStorage(&(time->arena), time->pointProbeN * sizeof(*time->pp));
             }
             if (0 < time->lineProbeN) {
-                time->lp = AssignStorage(time->lineProbeN * sizeof(*time->lp));
+                time->lp = AssignArenaStorage(&(time->arena), time->lineProbeN * sizeof(*time->lp));
             }
             continue;
         }
@@ -293,6 +298,90 @@ static int ReadCaseSettingData(Time *time, Space *space, Model *model)
             VerifyReadConversion(nscan, 1);
             continue;
         }
+        if (0 == strncmp(currentLine, "refinement begin", sizeof currentLine)) {
+            /* optional entry do not increase entry count */
+            Fgets(currentLine, sizeof currentLine, filePointer);
+            nscan = sscanf(currentLine, "%d", &(model->amr)); 
+            VerifyReadConversion(nscan, 1);
+            Fgets(currentLine, sizeof currentLine, filePointer);
+            nscan = sscanf(currentLine, formatI, &(model->amrTol)); 
+            VerifyReadConversion(nscan, 1);
+            Fgets(currentLine, sizeof currentLine, filePointer);
+            nscan = sscanf(currentLine, "%d", &(model->amrN)); 
+            VerifyReadConversion(nscan, 1);
+            continue;
+        }
+        if (0 == strncmp(currentLine, "cache begin", sizeof currentLine)) {
+            /* optional entry do not increase entry count */
+            Fgets(currentLine, sizeof currentLine, filePointer);
+            nscan = sscanf(currentLine, "%d", &(model->cache)); 
+            VerifyReadConversion(nscan, 1);
+            continue;
+        }
+        if (0 == strncmp(currentLine, "region output begin", sizeof currentLine)) {
+            /* optional entry do not increase entry count */
+            if (NOUTPUT <= time->outputN) {
+                FatalError("too many region outputs in case file");
+            }
+            FieldOutput *out = time->output + time->outputN;
+            Fgets(currentLine, sizeof currentLine, filePointer);
+            nscan = sscanf(currentLine, formatIII, &(out->box[X][MIN]),
+                    &(out->box[Y][MIN]), &(out->box[Z][MIN])); 
+            VerifyReadConversion(nscan, 3);
+            Fgets(currentLine, sizeof currentLine, filePointer);
+            nscan = sscanf(currentLine, formatIII, &(out->box[X][MAX]),
+                    &(out->box[Y][MAX]), &(out->box[Z][MAX])); 
+            VerifyReadConversion(nscan, 3);
+            Fgets(currentLine, sizeof currentLine, filePointer);
+            nscan = sscanf(currentLine, "%d, %d, %d", 
+                    &(out->stride[X]), &(out->stride[Y]), &(out->stride[Z])); 
+            VerifyReadConversion(nscan, 3);
+            Fgets(currentLine, sizeof currentLine, filePointer);
+            CommandLineProcessor(currentLine); /* process current line */
+            out->var = ReadOutputVariable(currentLine);
+            Fgets(currentLine, sizeof currentLine, filePointer);
+            nscan = sscanf(currentLine, "%d", &(out->writeN)); 
+            VerifyReadConversion(nscan, 1);
+            ++time->outputN;
+            continue;
+        }
+        if (0 == strncmp(currentLine, "quantization begin", sizeof currentLine)) {
+            /* optional entry do not increase entry count */
+            Fgets(currentLine, sizeof currentLine, filePointer);
+            nscan = sscanf(currentLine, "%d", &(time->quantMode)); 
+            VerifyReadConversion(nscan, 1);
+            Fgets(currentLine, sizeof currentLine, filePointer);
+            nscan = sscanf(currentLine, formatI, &(time->quantErr)); 
+            VerifyReadConversion(nscan, 1);
+            continue;
+        }
+        if (0 == strncmp(currentLine, "geometry output begin", sizeof currentLine)) {
+            /* optional entry do not increase entry count */
+            Fgets(currentLine, sizeof currentLine, filePointer);
+            nscan = sscanf(currentLine, "%d", &(time->geoMode)); 
+            VerifyReadConversion(nscan, 1);
+            continue;
+        }
+        if (0 == strncmp(currentLine, "statistics begin", sizeof currentLine)) {
+            /* optional entry do not increase entry count */
+            Fgets(currentLine, sizeof currentLine, filePointer);
+            nscan = sscanf(currentLine, "%d", &(time->statBlock)); 
+            VerifyReadConversion(nscan, 1);
+            Fgets(currentLine, sizeof currentLine, filePointer);
+            nscan = sscanf(currentLine, formatI, &(time->statStart)); 
+            VerifyReadConversion(nscan, 1);
+            continue;
+        }
+        if (0 == strncmp(currentLine, "residual begin", sizeof currentLine)) {
+            /* optional entry do not increase entry count */
+            Fgets(currentLine, sizeof currentLine, filePointer);
+            nscan = sscanf(currentLine, "%d", &(time->resInterval)); 
+            VerifyReadConversion(nscan, 1);
+            Fgets(currentLine, sizeof currentLine, filePointer);
+            nscan = sscanf(currentLine, formatI, &(time->resTol)); 
+            VerifyReadConversion(nscan, 1);
+            continue;
+        }
         if (0 == strncmp(currentLine, "point probe begin", sizeof currentLine)) {
             /* optional entry do not increase entry count */
             for (int n = 0; n < time->pointProbeN; ++n) {
@@ -420,6 +509,26 @@ static int ReadConsecutiveRealData(FILE *filePointer, Real *address, const int e
     }
     return 0;
 }
+/*
+ * Convert a comma separated list of output variable names into a bit mask.
+ */
+static int ReadOutputVariable(char *currentLine)
+{
+    int var = 0; /* bit mask of output variables */
+    int n = 0; /* variable index */
+    for (char *name = strtok(currentLine, ", "); NULL != name; name = strtok(NULL, ", ")) {
+        for (n = 0; n < VAROUT; ++n) {
+            if (0 == strncmp(name, varOut[n], sizeof varOut[n])) {
+                break;
+            }
+        }
+        if (VAROUT == n) {
+            FatalError("unidentified output variable in case file");
+        }
+        var = var | (1 << n);
+    }
+    return var;
+}
 static int WriteBoundaryData(FILE *filePointer, const Space *space, const int n)
 {
     const Partition *part = &(space->part);
@@ -533,6 +642,13 @@ static int WriteVerifyData(const Time *time, const Space *space, const Model *mo
     fprintf(filePointer, "maximum computing steps: %d\n", time->stepN); 
     fprintf(filePointer, "field data writing frequency: %d\n", time->writeN); 
     fprintf(filePointer, "data streamer: %d\n", time->dataStreamer); 
+    fprintf(filePointer, "quantization error mode: %d\n", time->quantMode); 
+    fprintf(filePointer, "quantization error bound: %.6g\n", time->quantErr); 
+    fprintf(filePointer, "geometry output mode: %d\n", time->geoMode); 
+    fprintf(filePointer, "statistics block: %d\n", time->statBlock); 
+    fprintf(filePointer, "statistics start time: %.6g\n", time->statStart); 
+    fprintf(filePointer, "residual monitor interval: %d\n", time->resInterval); 
+    fprintf(filePointer, "residual tolerance: %.6g\n", time->resTol); 
     fprintf(filePointer, "#------------------------------------------------------------------------------\n");
     fprintf(filePointer, "#\n");
     fprintf(filePointer, "#                        >> Numerical Method <<\n");
@@ -545,6 +661,10 @@ static int WriteVerifyData(const Time *time, const Space *space, const Model *mo
     fprintf(filePointer, "flux splitting method: %d\n", model->fluxSplit);
     fprintf(filePointer, "phase interaction: %d\n", model->fsi);
     fprintf(filePointer, "layers for reconstruction: %d\n", model->ibmLayer);
+    fprintf(filePointer, "mesh refinement: %d\n", model->amr);
+    fprintf(filePointer, "refinement threshold: %.6g\n", model->amrTol);
+    fprintf(filePointer, "regridding frequency: %d\n", model->amrN);
+    fprintf(filePointer, "primitive cache: %d\n", model->cache);
     fprintf(filePointer, "#------------------------------------------------------------------------------\n");
     fprintf(filePointer, "#\n");
     fprintf(filePointer, "#                       >> Material Properties <<\n");
@@ -629,6 +749,28 @@ static int WriteVerifyData(const Time *time, const Space *space, const Model *mo
         fprintf(filePointer, "resolution: %.6g\n", time->lp[n][6]);
     }
     fprintf(filePointer, "#------------------------------------------------------------------------------\n");
+    fprintf(filePointer, "#\n");
+    fprintf(filePointer, "#                      >> Region Outputs <<\n");
+    fprintf(filePointer, "#\n");
+    fprintf(filePointer, "#------------------------------------------------------------------------------\n");
+    for (int n = 0; n < time->outputN; ++n) {
+        fprintf(filePointer, "#\n");
+        fprintf(filePointer, "xmin, ymin, zmin: %.6g, %.6g, %.6g\n", 
+                time->output[n].box[X][MIN], time->output[n].box[Y][MIN], time->output[n].box[Z][MIN]);
+        fprintf(filePointer, "xmax, ymax, zmax: %.6g, %.6g, %.6g\n", 
+                time->output[n].box[X][MAX], time->output[n].box[Y][MAX], time->output[n].box[Z][MAX]);
+        fprintf(filePointer, "x, y, z stride: %d, %d, %d\n", 
+                time->output[n].stride[X], time->output[n].stride[Y], time->output[n].stride[Z]);
+        fprintf(filePointer, "variables:");
+        for (int m = 0; m < VAROUT; ++m) {
+            if (time->output[n].var & (1 << m)) {
+                fprintf(filePointer, " %s", varOut[m]);
+            }
+        }
+        fprintf(filePointer, "\n");
+        fprintf(filePointer, "writing frequency: %d\n", time->output[n].writeN);
+    }
+    fprintf(filePointer, "#------------------------------------------------------------------------------\n");
     fprintf(filePointer, "#------------------------------------------------------------------------------\n");
     fclose(filePointer); /* close current opened file */
     return 0;
@@ -650,14 +792,42 @@ static int CheckCaseSettingData(const Time *time, const Space *space, const Mode
         FatalError("too small mesh values in case settings");
     }
     /* time */
-    if ((0 > time->restart) || (zero >= time->end) || (zero >= time->numCFL)) {
+    if ((0 > time->restart) || (zero >= time->end) || (zero >= time->numCFL) ||
+            (0 > time->dataStreamer) || (3 < time->dataStreamer)) {
         FatalError("wrong values in time section of case settings");
     }
+    if ((0 > time->quantMode) || (1 < time->quantMode) || (zero > time->quantErr)) {
+        FatalError("wrong values in quantization of case settings");
+    }
+    if ((0 > time->geoMode) || (1 < time->geoMode)) {
+        FatalError("wrong values in geometry output of case settings");
+    }
+    if (0 > time->statBlock) {
+        FatalError("wrong values in statistics of case settings");
+    }
+    if ((0 > time->resInterval) || (zero > time->resTol)) {
+        FatalError("wrong values in residual monitor of case settings");
+    }
+    for (int n = 0; n < time->outputN; ++n) {
+        if ((time->output[n].box[X][MIN] > time->output[n].box[X][MAX]) ||
+                (time->output[n].box[Y][MIN] > time->output[n].box[Y][MAX]) ||
+                (time->output[n].box[Z][MIN] > time->output[n].box[Z][MAX]) ||
+                (1 > time->output[n].stride[X]) || (1 > time->output[n].stride[Y]) ||
+                (1 > time->output[n].stride[Z]) || (0 == time->output[n].var)) {
+            FatalError("wrong values in region output of case settings");
+        }
+    }
     /* numerical method */
-    if ((0 > model->tScheme) || (0 > model->sScheme) || (0 > model->multidim) || 
-            (0 > model->jacobMean) || (0 > model->fluxSplit) || (0 > model->fsi)) {
+    if ((0 > model->tScheme) || (0 > model->sScheme) || (WENOFIVEM < model->sScheme) || 
+            (0 > model->multidim) || (0 > model->jacobMean) || (0 > model->fluxSplit) || (0 > model->fsi)) {
         FatalError("wrong values in numerical method of case settings");
     }
+    if ((0 > model->amr) || (0.0 > model->amrTol)) {
+        FatalError("wrong values in mesh refinement of case settings");
+    }
+    if ((0 > model->cache) || (2 < model->cache)) {
+        FatalError("wrong values in primitive cache of case settings");
+    }
     /* material */
     if ((0 > model->mid)) {
         FatalError("wrong values in material section of case settings");
@@ -49,6 +49,18 @@ static void EigenvectorRY(const Real, const Real, const Real, const Real,
         const Real, const Real, Real [restrict][DIMU]);
 static void EigenvectorRZ(const Real, const Real, const Real, const Real,
         const Real, const Real, Real [restrict][DIMU]);
+static void ProjectLX(const Real [restrict], const Real, const Real, const Real,
+        const int, const Real [restrict], Real [restrict]);
+static void ProjectLY(const Real [restrict], const Real, const Real, const Real,
+        const int, const Real [restrict], Real [restrict]);
+static void ProjectLZ(const Real [restrict], const Real, const Real, const Real,
+        const int, const Real [restrict], Real [restrict]);
+static void ProjectRX(const Real [restrict], const Real, const Real, const Real,
+        const int, const Real [restrict], Real [restrict]);
+static void ProjectRY(const Real [restrict], const Real, const Real, const Real,
+        const int, const Real [restrict], Real [restrict]);
+static void ProjectRZ(const Real [restrict], const Real, const Real, const Real,
+        const int, const Real [restrict], Real [restrict]);
 static void ConvectiveFluxX(const Real, const Real, const Real, const Real, 
         const Real, const Real, Real [restrict]);
 static void ConvectiveFluxY(const Real, const Real, const Real, const Real, 
@@ -244,6 +256,97 @@ static void EigenvectorRZ(const Real u, const Real v, const Real w, const Real h
     R[4][0] = hT - w * c;  R[4][1] = u;    R[4][2] = v;    R[4][3] = w * w - q;  R[4][4] = hT + w * c;
     return;
 }
+/*
+ * Left eigenvectors have the structure L = [l0; I + m; l4] on the wave basis
+ * of direction s, where the rows of the two acoustic waves and the rank one
+ * correction m of the other waves share the scalar products
+ *      E = q * U0 - V . (U1, U2, U3) + U4
+ *      G = Vs * U0 - Us
+ * Right eigenvectors have a similar structure, and both are applied without
+ * forming the matrices. The projections only differ in the permutation of the
+ * velocity components of each direction, which is generated below from the
+ * normal component S and the tangential components T1 and T2.
+ */
+void EigenvectorProjectL(const int s, const Real gamma, const Real Uo[restrict],
+        const int n, const Real U[restrict], Real W[restrict])
+{
+    const Real V[DIMS] = {Uo[1], Uo[2], Uo[3]};
+    const Real c = Uo[5];
+    const Real q = 0.5 * (V[X] * V[X] + V[Y] * V[Y] + V[Z] * V[Z]);
+    const Real b = (gamma - 1.0) / (2.0 * c * c);
+    const Real d = 1.0 / (2.0 * c); 
+    switch (s) {
+        case X:
+            ProjectLX(V, q, b, d, n, U, W);
+            break;
+        case Y:
+            ProjectLY(V, q, b, d, n, U, W);
+            break;
+        default:
+            ProjectLZ(V, q, b, d, n, U, W);
+            break;
+    }
+    return;
+}
+#define PROJECTL(NAME, S, T1, T2) \
+static void NAME(const Real V[restrict], const Real q, const Real b, const Real d, \
+        const int n, const Real U[restrict], Real W[restrict]) \
+{ \
+    for (int m = 0; m < n * DIMU; m = m + DIMU) { \
+        const Real E = q * U[m] - (V[X] * U[m+1] + V[Y] * U[m+2] + V[Z] * U[m+3]) + U[m+4]; \
+        const Real G = V[S] * U[m] - U[m+S+1]; \
+        W[m] = b * E + d * G; \
+        W[m+S+1] = U[m] - 2.0 * b * E; \
+        W[m+T1+1] = U[m+T1+1] - 2.0 * b * V[T1] * E; \
+        W[m+T2+1] = U[m+T2+1] - 2.0 * b * V[T2] * E; \
+        W[m+4] = b * E - d * G; \
+    } \
+    return; \
+}
+PROJECTL(ProjectLX, X, Y, Z)
+PROJECTL(ProjectLY, Y, X, Z)
+PROJECTL(ProjectLZ, Z, X, Y)
+#undef PROJECTL
+void EigenvectorProjectR(const int s, const Real Uo[restrict],
+        const int n, const Real H[restrict], Real F[restrict])
+{
+    const Real V[DIMS] = {Uo[1], Uo[2], Uo[3]};
+    const Real hT = Uo[4];
+    const Real c = Uo[5];
+    const Real q = 0.5 * (V[X] * V[X] + V[Y] * V[Y] + V[Z] * V[Z]);
+    switch (s) {
+        case X:
+            ProjectRX(V, hT, c, q, n, H, F);
+            break;
+        case Y:
+            ProjectRY(V, hT, c, q, n, H, F);
+            break;
+        default:
+            ProjectRZ(V, hT, c, q, n, H, F);
+            break;
+    }
+    return;
+}
+#define PROJECTR(NAME, S, T1, T2) \
+static void NAME(const Real V[restrict], const Real hT, const Real c, const Real q, \
+        const int n, const Real H[restrict], Real F[restrict]) \
+{ \
+    for (int m = 0; m < n * DIMU; m = m + DIMU) { \
+        const Real A = H[m] + H[m+4]; /* sum of acoustic waves */ \
+        const Real B = H[m+4] - H[m]; /* difference of acoustic waves */ \
+        F[m] = A + H[m+S+1]; \
+        F[m+S+1] = V[S] * (A + H[m+S+1]) + c * B; \
+        F[m+T1+1] = V[T1] * A + H[m+T1+1]; \
+        F[m+T2+1] = V[T2] * A + H[m+T2+1]; \
+        F[m+4] = hT * A + V[S] * c * B + (V[S] * V[S] - q) * H[m+S+1] + \
+            V[T1] * H[m+T1+1] + V[T2] * H[m+T2+1]; \
+    } \
+    return; \
+}
+PROJECTR(ProjectRX, X, Y, Z)
+PROJECTR(ProjectRY, Y, X, Z)
+PROJECTR(ProjectRZ, Z, X, Y)
+#undef PROJECTR
 void ConvectiveFlux(const int s, const Real gamma, const Real U[restrict], Real F[restrict])
 {
     const Real rho = U[0];
@@ -43,6 +43,18 @@ extern void EigenvalueSplitting(const int splitter, const Real Lambda[restrict],
 extern void EigenvectorL(const int s, const Real gamma, const Real Uo[restrict],
         Real L[restrict][DIMU]);
 extern void EigenvectorR(const int s, const Real Uo[restrict], Real R[restrict][DIMU]);
+/*
+ * Eigenvector projections
+ *
+ * Function
+ *      Project n vectors stored contiguously in U onto the characteristic
+ *      fields of direction s, W = L U, and project n characteristic vectors
+ *      in H back, F = R H, without forming the eigenvector matrices.
+ */
+extern void EigenvectorProjectL(const int s, const Real gamma, const Real Uo[restrict],
+        const int n, const Real U[restrict], Real W[restrict]);
+extern void EigenvectorProjectR(const int s, const Real Uo[restrict],
+        const int n, const Real H[restrict], Real F[restrict]);
 /*
  * Convective fluxes
  *
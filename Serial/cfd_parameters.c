@@ -48,7 +48,8 @@ static int NodeBasedMeshNumberRefine(Space *space, const Model *model)
     if (WENOTHREE == model->sScheme) {
         part->gl = 2;
     }
-    if (WENOFIVE == model->sScheme) {
+    if ((WENOFIVE == model->sScheme) || (WENOFIVEZ == model->sScheme) ||
+            (WENOFIVEM == model->sScheme)) {
         part->gl = 3;
     }
     /* global boundary account for one ghost layer */
@@ -105,6 +106,20 @@ static int InitializeParameters(Time *time, Space *space, Model *model)
         time->writeN = INT_MAX;
     }
     time->writeC = time->restart;
+    if (0.0 >= time->quantErr) { /* default to a relative error bound */
+        time->quantMode = 1;
+        time->quantErr = 1.0e-4;
+    }
+    for (int n = 0; n < time->outputN; ++n) {
+        for (int s = 0; s < DIMS; ++s) {
+            time->output[n].box[s][MIN] = time->output[n].box[s][MIN] / model->refL;
+            time->output[n].box[s][MAX] = time->output[n].box[s][MAX] / model->refL;
+        }
+        if (0 >= time->output[n].writeN) {
+            time->output[n].writeN = INT_MAX;
+        }
+        time->output[n].writeC = 0; /* restored by a restart */
+    }
     if (0 >= time->pointWriteN) {
         time->pointWriteN = INT_MAX;
     }
@@ -141,6 +156,9 @@ static int InitializeParameters(Time *time, Space *space, Model *model)
     if (0 >= model->ibmLayer) {
         model->ibmLayer = INT_MAX;
     }
+    if (0 >= model->amrN) {
+        model->amrN = INT_MAX;
+    }
     model->gamma = 1.4;
     model->gasR = 287.058;
     for (int s = 0; s < DIMS; ++s) {
@@ -105,6 +105,40 @@ int RetrieveStorage(void *pointer)
     }
     return 0;
 }
+void *AssignArenaStorage(Arena *arena, size_t size)
+{
+    const size_t blockMin = 1 << 16; /* minimum block size in bytes */
+    size = ((size + sizeof(Real) - 1) / sizeof(Real)) * sizeof(Real);
+    if ((0 == arena->blockN) || (arena->size - arena->used < size)) {
+        if (NBLOCK == arena->blockN) {
+            FatalError("arena storage exhausted");
+        }
+        arena->size = 2 * arena->size;
+        if (blockMin > arena->size) {
+            arena->size = blockMin;
+        }
+        if (size > arena->size) {
+            arena->size = size;
+        }
+        arena->block[arena->blockN] = AssignStorage(arena->size);
+        arena->used = 0;
+        ++(arena->blockN);
+    }
+    void *pointer = arena->block[arena->blockN - 1] + arena->used;
+    arena->used = arena->used + size;
+    return pointer;
+}
+int RetrieveArenaStorage(Arena *arena)
+{
+    for (int n = 0; n < arena->blockN; ++n) {
+        RetrieveStorage(arena->block[n]);
+        arena->block[n] = NULL;
+    }
+    arena->blockN = 0;
+    arena->size = 0;
+    arena->used = 0;
+    return 0;
+}
 int ReadInLine(FILE *filePointer, const char *lineString)
 {
     String currentLine = {'\0'}; /* store the current read line */
@@ -38,6 +38,8 @@ typedef enum {
     DIMU = 5, /* conservative vector: rho, rho_u, rho_v, rho_w, rho_eT */
     DIMUo = 6, /* primitive vector: rho, u, v, w, [p, hT, h], [T, c] */
     DIMT = 3, /* number of time levels to store field data */
+    DIMCV = 4, /* cached primitives of the first kind: u, v, w, T */
+    DIMCP = 2, /* cached primitives of the second kind: rho, p */
     TO = 0, /* the time level for current */
     TN = 1, /* the time level for intermediate */
     TM = 2, /* the time level for intermediate */
@@ -47,9 +49,10 @@ typedef enum {
     NONE = -1, /* invalid flag */
     WENOTHREE = 0, /* 3th order weno */
     WENOFIVE = 1, /* 5th order weno */
+    WENOFIVEZ = 2, /* 5th order weno-z */
+    WENOFIVEM = 3, /* 5th order mapped weno */
     /* parameters related to domain partitions */
     NPART = 13, /* inner region, [west, east, south, north, front, back] x [Boundary, Ghost] */
-    NPARTWRITE = 1, /* number of partitions to write data out */
     PIN = 0,
     PWB = 1, 
     PEB = 2, 
@@ -73,8 +76,17 @@ typedef enum {
     SLIPWALL = 2,
     NOSLIPWALL = 3,
     PERIODIC = 4,
+    INTERFACE = 5, /* coarse-fine interface of refined patches */
     ENTRYBC = 6, /* rho, u, v, w, p, T */
     VARBC = 5, /* rho, u, v, w, p */
+    BCLAYER = 4, /* maximum number of treated layers of a boundary: boundary and ghost layers */
+    BCIDX = 3, /* node indices of a boundary condition entry: target, donor, image */
+    BCNONE = 0, /* boundary condition operation: no treatment */
+    BCVALUE = 1, /* specified values */
+    BCCOPY = 2, /* copy of donor node */
+    BCSLIP = 3, /* slip wall at boundary node */
+    BCNOSLIP = 4, /* no-slip wall at boundary node */
+    BCIMAGE = 5, /* method of image at ghost node */
     /* parameters related to global and regional initialization */
     NIC = 10, /* maximum number of initializer to support */
     ICGLOBAL = 0, /* global initializer */
@@ -84,10 +96,25 @@ typedef enum {
     ICCYLINDER = 4, /* cylinder initializer */
     ENTRYIC = 12, /* x1, y1, z1, [x2, Nx], [y2, Ny], [z2, Nz], r, primitive variables */
     VARIC = 5, /* primitive variables: rho, u, v, w, p */
+    /* parameters related to field data output */
+    NOUTPUT = 8, /* maximum number of region outputs to support */
+    VAROUT = 11, /* output variables: rho, u, v, w, p, T, gid, fid, lid, gst, Vel */
+    QUANTN = 65536, /* number of quantization codes, code 0 marks an unpredictable value */
+    QUANTL = 56, /* maximum Huffman code length of quantization codes */
+    QUANTBLOCK = 262144, /* target number of values in a quantized block */
+    ENSIGHTCHUNK = 1048576, /* target number of nodes of a buffered Ensight write */
+    PROBEN = 8, /* nodes of a trilinear probe stencil */
+    STATN = 9, /* second moments of statistics: rho, u, v, w, p, T, u'v', v'w', w'u' */
     /* parameters related to geometry */
     DIMTK = 2, /* number of time levels to store kinematic data */
     POLYN = 3, /* polygon facet type */
     EVF = 4, /* edge-vertex-face type */
+    NLAYER = 4, /* maximum number of interfacial layers of a geometry plus one, layer 0 unused */
+    LISTGST = 0, /* node list of ghost nodes */
+    LISTLID = 1, /* node list of interfacial nodes */
+    NLIST = 8, /* number of node lists of a geometry: [ghost, interfacial] x [layers] */
+    /* parameters related to storage */
+    NBLOCK = 40, /* maximum number of storage blocks of an arena */
 } Constants;
 /*
  * Define some universe data type for portability and maintenance.
@@ -99,6 +126,18 @@ typedef Real RealVec[DIMS]; /* real type vector */
 /*
  * Define structures for packing compound data
  */
+/*
+ * Arena storage
+ *
+ * A list of large storage blocks from which small storage pieces are
+ * assigned consecutively. All pieces are retrieved in one call.
+ */
+typedef struct {
+    int blockN; /* number of blocks */
+    size_t size; /* size of current block */
+    size_t used; /* used size of current block */
+    char *block[NBLOCK]; /* storage blocks */
+} Arena;
 typedef struct {
     int gid; /* geometry identifier */
     int fid; /* closest face identifier */
@@ -106,6 +145,18 @@ typedef struct {
     int gst; /* ghost layer identifier */
     Real U[DIMT][DIMU]; /* field data at each time level */
 } Node;
+/*
+ * Boundary condition list
+ *
+ * Nodes of a box layer of a domain boundary with the node indices required
+ * by the boundary condition operation of the layer.
+ */
+typedef struct {
+    int op; /* boundary condition operation */
+    int n; /* number of nodes */
+    int box[DIMS][LIMIT]; /* range box of the layer */
+    int (*idx)[BCIDX]; /* target, donor, and image node of each node */
+} BCList;
 /*
  * Domain discretization and partition structure
  */
@@ -127,6 +178,8 @@ typedef struct {
     int countIC; /* flow initializer count */
     int typeIC[NIC]; /* flow initializer type recorder */
     Real valueBC[NBC][ENTRYBC]; /* field values of each boundary */
+    BCList bcl[NBC][BCLAYER]; /* boundary condition lists of each boundary layer */
+    int (*bcIdx)[BCIDX]; /* storage of boundary condition lists */
     Real valueIC[NIC][ENTRYIC]; /* field values of each initializer */
     Real domain[DIMS][LIMIT]; /* coordinates define the space domain */
 } Partition;
@@ -166,6 +219,7 @@ typedef struct {
     Real area; /* area */
     Real volume; /* volume */
     Real box[DIMS][LIMIT]; /* a bounding box of the polyhedron */
+    Real tf[DIMS][DIMS + 1]; /* affine transform of vertices relative to the output topology */
     int (*restrict f)[POLYN]; /* face-vertex list */
     Real (*restrict Nf)[DIMS]; /* face normal */
     int (*restrict e)[EVF]; /* edge-vertex-face list */
@@ -181,16 +235,45 @@ typedef struct {
     int gid; /* geometry identifier */
     IntVec N; /* line of impact */
 } Collision;
+/*
+ * Particle bin
+ *
+ * Analytical spheres are stored as a structure of arrays and binned into
+ * a uniform cell list whose cell size is no less than the maximum sphere
+ * diameter plus the interaction reach of the numerical stencil.
+ */
+typedef struct {
+    int cellN; /* total number of cells */
+    IntVec n; /* number of cells of spatial dimensions */
+    RealVec dd; /* reciprocal of cell sizes */
+    Real reach; /* interaction distance beyond sphere surfaces */
+    Real *O[DIMS]; /* sphere centroids */
+    Real *r; /* sphere radius */
+    char *iso; /* isolation flag, no other geometry within reach */
+    int *head; /* first sphere in each cell */
+    int *next; /* next sphere in the same cell */
+} Bin;
 /*
  * Geometry Entities
+ *
+ * Node lists of geometries are maintained by the geometry domain. Nodes of
+ * list l = type * NLAYER + r of geometry n are list[listSep[n * NLIST + l]]
+ * to list[listSep[n * NLIST + l + 1] - 1] in the order of node index.
  */
 typedef struct {
     int totN; /* total number of geometries */
     int sphN; /* number of analytical spheres */
     int stlN; /* number of triangulated polyhedrons */
     int colN; /* colliding list pointer and count */
+    int loaded; /* geometry data are loaded before initialization */
     Polyhedron *poly; /* geometry list */
     Collision *col; /* collision list */
+    Bin bin; /* particle bin of analytical spheres */
+    Arena arena; /* storage of polyhedron topology */
+    int listMax; /* capacity of node list storage */
+    int *listSep; /* node list separators of each geometry */
+    int (*list)[DIMS]; /* ghost and interfacial nodes of each geometry by layer */
+    int (*scan)[DIMS]; /* interfacial nodes of all geometries in scan order */
 } Geometry;
 /*
  * Material properties
@@ -198,6 +281,47 @@ typedef struct {
 typedef struct {
     Real eos; /* equation of state */
 } Material;
+/*
+ * Primitive cache
+ *
+ * Primitive variables of the normal nodes and the first ghost layer at a
+ * single time level, converted once along with boundary treatments and
+ * shared by readers of the level.
+ */
+typedef struct {
+    int tn; /* cached time level */
+    Real (*V)[DIMCV]; /* u, v, w, T; NULL if cache is off */
+    Real (*P)[DIMCP]; /* rho, p; NULL if not cached */
+} Cache;
+/*
+ * In-situ statistics
+ *
+ * Time weighted running means of rho, u, v, w, p, T of fluid nodes, and the
+ * weighted sums of squared deviations of them and of the cross products
+ * u'v', v'w', w'u', on cells of the interior domain that merge a block of
+ * nodes per axis.
+ */
+typedef struct {
+    int cellN; /* total number of cells */
+    IntVec n; /* number of cells of each axis */
+    Real *W; /* accumulated weight of each cell; NULL if statistics is off */
+    Real (*mean)[DIMUo]; /* running means */
+    Real (*M2)[STATN]; /* weighted sums of squared deviations and cross products */
+} Statistics;
+/*
+ * Residual monitor
+ *
+ * Changes of conservative variables of fluid nodes over a monitored time
+ * step, the field data at the beginning of the step are saved by the first
+ * update of the step and compared by the last update of the step.
+ */
+typedef struct {
+    int stage; /* monitor stage of current step */
+    int nodeN; /* number of measured nodes */
+    Real (*U)[DIMU]; /* field data at the beginning of a step; NULL if monitor is off */
+    Real L2[DIMU]; /* sums of squared changes */
+    Real Linf[DIMU]; /* maximum absolute changes */
+} Residual;
 /*
  * Space domain parameters
  */
@@ -205,7 +329,39 @@ typedef struct {
     Node *node; /* field data */
     Geometry geo; /* geometry in space */
     Partition part; /* domain discretization and partition information */
+    Cache cache; /* primitive cache of field data */
+    Statistics stat; /* in-situ statistics of field data */
+    Residual res; /* residual monitor of field data */
 } Space;
+/*
+ * Region output
+ *
+ * Field data in a box of the interior domain sub-sampled by a stride on each
+ * axis. Bit n of var selects the n-th output variable in the order of
+ * rho, u, v, w, p, T, gid, fid, lid, gst, Vel.
+ */
+typedef struct {
+    int stride[DIMS]; /* sub-sampling stride on each axis */
+    int var; /* bit mask of output variables */
+    int writeN; /* writing frequency */
+    int writeC; /* writing count */
+    Real box[DIMS][LIMIT]; /* region of interest */
+} FieldOutput;
+/*
+ * Probe stencils
+ *
+ * Point probes and then line probes are compiled into samples, and each
+ * sample is a trilinear stencil of eight nodes. Samples of probe n are
+ * sample sep[n] to sep[n + 1] - 1, with line probes numbered after point
+ * probes.
+ */
+typedef struct {
+    int sampleN; /* total number of samples */
+    int *sep; /* sample separators of probes */
+    int (*restrict idx)[PROBEN]; /* stencil nodes of samples */
+    Real (*restrict w)[PROBEN]; /* stencil weights of samples */
+    Real (*restrict p)[DIMS]; /* coordinates of samples */
+} ProbeStencil;
 /*
  * Time domain parameters
  */
@@ -224,11 +380,22 @@ typedef struct {
     int lineProbeN; /* total number of line probes */
     int curveProbeN; /* body-conformal probe */
     int forceProbeN; /* surface force probe */
+    int outputN; /* number of region outputs */
+    int quantMode; /* error bound of quantized output: 0 absolute; 1 relative */
+    int geoMode; /* polyhedron output: 0 full polyhedra; 1 topology and transforms */
+    int statBlock; /* nodes per axis of a statistics cell; 0 statistics off */
+    int resInterval; /* steps between residual monitoring; 0 monitor off */
     Real end; /* termination time */
     Real now; /* current time recorder */
     Real numCFL; /* CFL number */
+    Real quantErr; /* error bound of quantized output */
+    Real statStart; /* start time of statistics */
+    Real resTol; /* residual tolerance of steady state; 0 no termination */
     Real (*restrict pp)[DIMS]; /* point probes */
     Real (*restrict lp)[7]; /* line probes */
+    FieldOutput output[NOUTPUT]; /* region outputs */
+    ProbeStencil stencil; /* compiled point and line probes */
+    Arena arena; /* storage of probes */
 } Time;
 /*
  * Model properties and physics parameters
@@ -241,9 +408,13 @@ typedef struct {
     int fluxSplit; /* flux vector splitting method */
     int fsi; /* material interaction trigger */
     int ibmLayer; /* number of interfacial layers using flow reconstruction */
+    int amr; /* adaptive mesh refinement trigger */
+    int amrN; /* regridding frequency */
+    int cache; /* primitive cache level */
     int mid; /* material identifier */
     int gState; /* gravity state */
     int sState; /* source state */
+    Real amrTol; /* threshold of relative density variation for refinement */
     Real refMa; /* reference Mach number */
     Real refMu; /* reference dynamic viscosity */
     Real gamma; /* heat capacity ratio */
@@ -260,8 +431,9 @@ typedef struct {
  * Program command line arguments and overall control
  */
 typedef struct {
-    char runMode; /* mode: [i] interact, [s] serial, [t] threaded, [m] mpi, [g] gpu */
+    char runMode; /* mode: [i] interact, [s] serial, [t] threaded, [m] mpi, [g] gpu, [b] bench, [w] sweep */
     int procN; /* number of processors */
+    const char *trace; /* trace file, NULL when tracing is off */
 } Control;
 /****************************************************************************
  * Public Functions Declaration
@@ -314,6 +486,18 @@ extern void *AssignStorage(size_t size);
  *      NULL after calling free.
  */
 extern int RetrieveStorage(void *pointer);
+/*
+ * Arena storage
+ *
+ * Function
+ *      Assign a piece of zero-initialized storage from the arena. A new block
+ *      is obtained when the current block is exhausted, the block size grows
+ *      geometrically to keep the number of blocks small. Pieces are aligned
+ *      to the size of Real.
+ *      Retrieve all storage blocks of the arena at once.
+ */
+extern void *AssignArenaStorage(Arena *, size_t size);
+extern int RetrieveArenaStorage(Arena *);
 /*
  * Auxiliary Functions for File Reading
  *
@@ -0,0 +1,70 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Header File Guards to Avoid Interdependence
+ ****************************************************************************/
+#ifndef ARTRACFD_COMPRESSED_H_ /* if this is the first definition */
+#define ARTRACFD_COMPRESSED_H_ /* a unique marker for this header file */
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+/*
+ * Compressed data format control
+ */
+typedef char CompressedString[80]; /* string data */
+typedef char CompressedName[16]; /* short string data */
+/*
+ * Compressed data configuration structure
+ */
+typedef struct {
+    CompressedName rootName; /* data file root name */
+    CompressedString baseName; /* data file base name */
+    char fileName[sizeof(CompressedString) + sizeof(CompressedName)]; /* store current open file name */
+    CompressedName fileExt; /* data file extension */
+}CompressedSet;
+/****************************************************************************
+ * Public Functions Declaration
+ ****************************************************************************/
+/*
+ * Quantized structured data writer and reader
+ *
+ * Function
+ *      Field data of the interior domain are written to a single binary
+ *      file fieldNNNNN.aqz holding time, step, grid, and the primitive
+ *      variables rho, u, v, w, p. Each variable is quantized to its error
+ *      bound: the absolute bound, or the relative bound times the value
+ *      range of the variable at the time. Variables are split into slabs
+ *      along the outermost dimension that has more than one node, and slabs
+ *      are encoded and decoded independently, concurrently with OpenMP.
+ *
+ *      Layout: "ArtraAQZ", time, step, node numbers, coordinates of the
+ *      first node, mesh sizes, gamma, cv (double and int), variable count,
+ *      slab dimension, slab count, start and node number of slabs, error
+ *      bounds of variables, byte sizes of encoded slabs in the order of
+ *      variables then slabs, and encoded slabs in the same order.
+ */
+extern int WriteStructuredDataCompressed(const Time *, const Space *, const Model *);
+extern int ReadStructuredDataCompressed(Time *, Space *, const Model *);
+/*
+ * Quantized data converter
+ *
+ * Function
+ *      Convert the series of quantized field data in the current directory
+ *      to ParaView structured data with rho, u, v, w, p, T, and Vel. Node
+ *      flags are not stored in quantized data and are written as zero.
+ */
+extern int ConvertCompressedData(void);
+#endif
+/* a good practice: end file with a newline */
@@ -0,0 +1,247 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include "compressed.h"
+#include <stdio.h> /* standard library for input and output */
+#include <string.h> /* manipulating strings */
+#include "quantizer.h"
+#include "paraview.h"
+#include "cfd_commons.h"
+#include "commons.h"
+/****************************************************************************
+ * Static Function Declarations
+ ****************************************************************************/
+static int InitializeTransientCaseFile(void);
+static FILE *OpenDataFile(CompressedSet *);
+static int ReadGridData(Space *, Model *, CompressedSet *);
+static int ReadStructuredData(Time *, Space *, const Model *, CompressedSet *);
+/****************************************************************************
+ * Function definitions
+ ****************************************************************************/
+int ReadStructuredDataCompressed(Time *time, Space *space, const Model *model)
+{
+    CompressedSet zipSet = { /* initialize environment */
+        .rootName = "field", /* data file root name */
+        .baseName = {'\0'}, /* data file base name */
+        .fileName = {'\0'}, /* data file name */
+        .fileExt = ".aqz" /* data file extension */
+    };
+    if ((int)sizeof(zipSet.baseName) <= snprintf(zipSet.baseName, sizeof(zipSet.baseName), "%s%05d",
+            zipSet.rootName, time->writeC)) {
+        FatalError("data file name is too long...");
+    }
+    ReadStructuredData(time, space, model, &zipSet);
+    return 0;
+}
+int ConvertCompressedData(void)
+{
+    CompressedSet zipSet = { /* initialize environment */
+        .rootName = "field", /* data file root name */
+        .baseName = {'\0'}, /* data file base name */
+        .fileName = {'\0'}, /* data file name */
+        .fileExt = ".aqz" /* data file extension */
+    };
+    Time time = {0};
+    Space space = {0};
+    Model model = {0};
+    InitializeTransientCaseFile();
+    for (time.writeC = 0; ; ++time.writeC) {
+        if ((int)sizeof(zipSet.baseName) <= snprintf(zipSet.baseName, sizeof(zipSet.baseName), "%s%05d",
+                zipSet.rootName, time.writeC)) {
+            FatalError("data file name is too long...");
+        }
+        if ((int)sizeof(zipSet.fileName) <= snprintf(zipSet.fileName, sizeof(zipSet.fileName), "%s%s",
+                zipSet.baseName, zipSet.fileExt)) {
+            FatalError("data file name is too long...");
+        }
+        FILE *filePointer = fopen(zipSet.fileName, "rb");
+        if (NULL == filePointer) {
+            break;
+        }
+        fclose(filePointer); /* close current opened file */
+        if (NULL == space.node) {
+            ReadGridData(&space, &model, &zipSet);
+        }
+        ReadStructuredData(&time, &space, &model, &zipSet);
+        WriteStructuredDataParaview(&time, &space, &model);
+        fprintf(stdout, "  %s converted\n", zipSet.fileName);
+    }
+    RetrieveStorage(space.node);
+    if (0 == time.writeC) {
+        FatalError("no quantized data found...");
+    }
+    return 0;
+}
+/*
+ * The ParaView writer starts a transient case only at step zero, which may
+ * not be the first converted data.
+ */
+static int InitializeTransientCaseFile(void)
+{
+    FILE *filePointer = fopen("field.pvd", "w");
+    if (NULL == filePointer) {
+        FatalError("failed to initialize transient case file...");
+    }
+    fprintf(filePointer, "<?xml version=\"1.0\"?>\n");
+    fprintf(filePointer, "<VTKFile type=\"Collection\" version=\"1.0\"\n");
+    fprintf(filePointer, "         byte_order=\"LittleEndian\">\n");
+    fprintf(filePointer, "  <Collection>\n");
+    fprintf(filePointer, "  </Collection>\n");
+    fprintf(filePointer, "</VTKFile>\n");
+    fclose(filePointer); /* close current opened file */
+    return 0;
+}
+static FILE *OpenDataFile(CompressedSet *zipSet)
+{
+    if ((int)sizeof(zipSet->fileName) <= snprintf(zipSet->fileName, sizeof(zipSet->fileName), "%s%s",
+            zipSet->baseName, zipSet->fileExt)) {
+        FatalError("data file name is too long...");
+    }
+    FILE *filePointer = fopen(zipSet->fileName, "rb");
+    if (NULL == filePointer) {
+        FatalError("failed to open data file...");
+    }
+    char magic[8] = {'\0'};
+    Fread(magic, sizeof(char), 8, filePointer);
+    if (0 != strncmp(magic, "ArtraAQZ", 8)) {
+        FatalError("not a quantized data file...");
+    }
+    return filePointer;
+}
+/*
+ * Set up a domain without ghost layers holding the grid of a data file.
+ */
+static int ReadGridData(Space *space, Model *model, CompressedSet *zipSet)
+{
+    FILE *filePointer = OpenDataFile(zipSet);
+    Partition *restrict part = &(space->part);
+    double now = 0.0;
+    int stepC = 0;
+    int nodeCount[DIMS] = {0};
+    double origin[DIMS] = {0.0};
+    double d[DIMS] = {0.0};
+    double gas[2] = {0.0};
+    Fread(&now, sizeof(double), 1, filePointer);
+    Fread(&stepC, sizeof(int), 1, filePointer);
+    Fread(nodeCount, sizeof(int), DIMS, filePointer);
+    Fread(origin, sizeof(double), DIMS, filePointer);
+    Fread(d, sizeof(double), DIMS, filePointer);
+    Fread(gas, sizeof(double), 2, filePointer);
+    fclose(filePointer); /* close current opened file */
+    part->ng = 0;
+    for (int s = 0; s < DIMS; ++s) {
+        if (1 > nodeCount[s]) {
+            FatalError("corrupted quantized data...");
+        }
+        part->n[s] = nodeCount[s];
+        part->ns[PIN][s][MIN] = 0;
+        part->ns[PIN][s][MAX] = nodeCount[s];
+        part->domain[s][MIN] = origin[s];
+        part->domain[s][MAX] = origin[s] + (nodeCount[s] - 1) * d[s];
+        part->d[s] = d[s];
+        part->dd[s] = 1.0 / d[s];
+    }
+    model->gamma = gas[0];
+    model->cv = gas[1];
+    space->node = AssignStorage(part->n[X] * part->n[Y] * part->n[Z] * sizeof(*space->node));
+    return 0;
+}
+static int ReadStructuredData(Time *time, Space *space, const Model *model, CompressedSet *zipSet)
+{
+    FILE *filePointer = OpenDataFile(zipSet);
+    const Partition *restrict part = &(space->part);
+    Node *const node = space->node;
+    double now = 0.0;
+    int nodeCount[DIMS] = {0};
+    double skip[2 * DIMS + 2] = {0.0}; /* grid and gas data */
+    int layout[3] = {0}; /* variable count, slab dimension, slab count */
+    Fread(&now, sizeof(double), 1, filePointer);
+    Fread(&(time->stepC), sizeof(int), 1, filePointer);
+    Fread(nodeCount, sizeof(int), DIMS, filePointer);
+    Fread(skip, sizeof(double), 2 * DIMS + 2, filePointer);
+    Fread(layout, sizeof(int), 3, filePointer);
+    time->now = now;
+    for (int s = 0; s < DIMS; ++s) {
+        if (nodeCount[s] != part->ns[PIN][s][MAX] - part->ns[PIN][s][MIN]) {
+            FatalError("quantized data do not match the domain...");
+        }
+    }
+    const int varN = layout[0];
+    const int split = layout[1];
+    const int blockN = layout[2];
+    if ((DIMU != varN) || (X > split) || (Z < split) || (1 > blockN) || (nodeCount[split] < blockN)) {
+        FatalError("corrupted quantized data...");
+    }
+    int planeN = 1; /* node number of a plane normal to the split dimension */
+    for (int s = 0; s < split; ++s) {
+        planeN = planeN * nodeCount[s];
+    }
+    int (*slab)[LIMIT] = AssignStorage(blockN * sizeof(*slab));
+    double eb[DIMU] = {0.0};
+    int *size = AssignStorage(varN * blockN * sizeof(*size));
+    size_t *offset = AssignStorage((varN * blockN + 1) * sizeof(*offset));
+    Fread(slab, sizeof(int), LIMIT * blockN, filePointer);
+    Fread(eb, sizeof(double), varN, filePointer);
+    Fread(size, sizeof(int), varN * blockN, filePointer);
+    for (int t = 0; t < varN * blockN; ++t) {
+        if (0 > size[t]) {
+            FatalError("corrupted quantized data...");
+        }
+        offset[t + 1] = offset[t] + size[t];
+    }
+    for (int b = 0; b < blockN; ++b) {
+        if ((0 > slab[b][MIN]) || (1 > slab[b][MAX]) || (nodeCount[split] < slab[b][MIN] + slab[b][MAX])) {
+            FatalError("corrupted quantized data...");
+        }
+    }
+    /* encoded slabs are loaded in bulk */
+    unsigned char *stream = AssignStorage(offset[varN * blockN]);
+    Fread(stream, sizeof(unsigned char), offset[varN * blockN], filePointer);
+    fclose(filePointer); /* close current opened file */
+    /*
+     * Decode slabs of all variables concurrently
+     */
+    const int totN = nodeCount[X] * nodeCount[Y] * nodeCount[Z];
+    Real *field = AssignStorage(varN * totN * sizeof(*field));
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int t = 0; t < varN * blockN; ++t) {
+        const int v = t / blockN;
+        const int b = t % blockN;
+        int n[DIMS] = {nodeCount[X], nodeCount[Y], nodeCount[Z]};
+        n[split] = slab[b][MAX];
+        DecodeQuantizedBlock(stream + offset[t], size[t], n, eb[v],
+                field + v * totN + slab[b][MIN] * planeN);
+    }
+    for (int k = part->ns[PIN][Z][MIN], idx = 0; k < part->ns[PIN][Z][MAX]; ++k) {
+        for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
+            for (int i = part->ns[PIN][X][MIN]; i < part->ns[PIN][X][MAX]; ++i, ++idx) {
+                Real *restrict U = node[IndexNode(k, j, i, part->n[Y], part->n[X])].U[TO];
+                U[0] = field[idx];
+                U[1] = U[0] * field[totN + idx];
+                U[2] = U[0] * field[2 * totN + idx];
+                U[3] = U[0] * field[3 * totN + idx];
+                U[4] = 0.5 * (U[1] * U[1] + U[2] * U[2] + U[3] * U[3]) / U[0] +
+                    field[4 * totN + idx] / (model->gamma - 1.0);
+            }
+        }
+    }
+    RetrieveStorage(slab);
+    RetrieveStorage(size);
+    RetrieveStorage(offset);
+    RetrieveStorage(stream);
+    RetrieveStorage(field);
+    return 0;
+}
+/* a good practice: end file with a newline */
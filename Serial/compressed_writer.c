@@ -0,0 +1,185 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include "compressed.h"
+#include <stdio.h> /* standard library for input and output */
+#include <math.h> /* common mathematical functions */
+#include <float.h> /* size of floating point values */
+#include "quantizer.h"
+#include "cfd_commons.h"
+#include "commons.h"
+/****************************************************************************
+ * Static Function Declarations
+ ****************************************************************************/
+static int WriteStructuredData(const Time *, const Space *, const Model *, CompressedSet *);
+static Real PrimitiveValue(const int, const Real [restrict], const Model *);
+/****************************************************************************
+ * Function definitions
+ ****************************************************************************/
+int WriteStructuredDataCompressed(const Time *time, const Space *space, const Model *model)
+{
+    CompressedSet zipSet = { /* initialize environment */
+        .rootName = "field", /* data file root name */
+        .baseName = {'\0'}, /* data file base name */
+        .fileName = {'\0'}, /* data file name */
+        .fileExt = ".aqz" /* data file extension */
+    };
+    if ((int)sizeof(zipSet.baseName) <= snprintf(zipSet.baseName, sizeof(zipSet.baseName), "%s%05d",
+            zipSet.rootName, time->writeC)) {
+        FatalError("data file name is too long...");
+    }
+    WriteStructuredData(time, space, model, &zipSet);
+    return 0;
+}
+static int WriteStructuredData(const Time *time, const Space *space, const Model *model, CompressedSet *zipSet)
+{
+    const Partition *restrict part = &(space->part);
+    const Node *const node = space->node;
+    const int varN = DIMU; /* rho, u, v, w, p */
+    IntVec nodeCount = {0}; /* i, j, k node number of the interior domain */
+    for (int s = 0; s < DIMS; ++s) {
+        nodeCount[s] = part->ns[PIN][s][MAX] - part->ns[PIN][s][MIN];
+    }
+    /*
+     * Slabs are normal to the outermost dimension that has more than one
+     * node, thus each slab is contiguous in the x fastest order.
+     */
+    int split = Z;
+    while ((X < split) && (1 == nodeCount[split])) {
+        --split;
+    }
+    int planeN = 1; /* node number of a plane normal to the split dimension */
+    for (int s = 0; s < split; ++s) {
+        planeN = planeN * nodeCount[s];
+    }
+    const int thick = MaxInt(1, QUANTBLOCK / planeN); /* planes in a slab */
+    const int blockN = (nodeCount[split] + thick - 1) / thick;
+    /*
+     * Error bound of each variable
+     */
+    double eb[DIMU] = {0.0};
+    for (int v = 0; v < varN; ++v) {
+        eb[v] = time->quantErr;
+        if (0 == time->quantMode) {
+            continue;
+        }
+        Real valueMin = FLT_MAX;
+        Real valueMax = -FLT_MAX;
+        for (int k = part->ns[PIN][Z][MIN]; k < part->ns[PIN][Z][MAX]; ++k) {
+            for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
+                for (int i = part->ns[PIN][X][MIN]; i < part->ns[PIN][X][MAX]; ++i) {
+                    const Real value = PrimitiveValue(v, node[IndexNode(k, j, i, part->n[Y], part->n[X])].U[TO], model);
+                    valueMin = MinReal(valueMin, value);
+                    valueMax = MaxReal(valueMax, value);
+                }
+            }
+        }
+        eb[v] = time->quantErr * (valueMax - valueMin);
+        if (0.0 >= eb[v]) { /* constant field */
+            eb[v] = time->quantErr * MaxReal(fabs(valueMax), 1.0);
+        }
+    }
+    /*
+     * Encode slabs of all variables concurrently
+     */
+    unsigned char **stream = AssignStorage(varN * blockN * sizeof(*stream));
+    int *size = AssignStorage(varN * blockN * sizeof(*size));
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int t = 0; t < varN * blockN; ++t) {
+        const int v = t / blockN;
+        const int b = t % blockN;
+        int range[DIMS][LIMIT] = {{0}}; /* node range of the slab */
+        int n[DIMS] = {0}; /* node number of the slab */
+        for (int s = 0; s < DIMS; ++s) {
+            range[s][MIN] = part->ns[PIN][s][MIN];
+            range[s][MAX] = part->ns[PIN][s][MAX];
+        }
+        range[split][MIN] = part->ns[PIN][split][MIN] + b * thick;
+        range[split][MAX] = MinInt(range[split][MIN] + thick, part->ns[PIN][split][MAX]);
+        for (int s = 0; s < DIMS; ++s) {
+            n[s] = range[s][MAX] - range[s][MIN];
+        }
+        Real *data = AssignStorage(n[X] * n[Y] * n[Z] * sizeof(*data));
+        for (int k = range[Z][MIN], idx = 0; k < range[Z][MAX]; ++k) {
+            for (int j = range[Y][MIN]; j < range[Y][MAX]; ++j) {
+                for (int i = range[X][MIN]; i < range[X][MAX]; ++i, ++idx) {
+                    data[idx] = PrimitiveValue(v, node[IndexNode(k, j, i, part->n[Y], part->n[X])].U[TO], model);
+                }
+            }
+        }
+        stream[t] = EncodeQuantizedBlock(data, n, eb[v], size + t);
+        RetrieveStorage(data);
+    }
+    /*
+     * Write header, slab directory, and encoded slabs
+     */
+    if ((int)sizeof(zipSet->fileName) <= snprintf(zipSet->fileName, sizeof(zipSet->fileName), "%s%s",
+            zipSet->baseName, zipSet->fileExt)) {
+        FatalError("data file name is too long...");
+    }
+    FILE *filePointer = fopen(zipSet->fileName, "wb");
+    if (NULL == filePointer) {
+        FatalError("failed to open data file...");
+    }
+    const double now = time->now;
+    double origin[DIMS] = {0.0}; /* coordinates of the first node */
+    double d[DIMS] = {0.0}; /* mesh sizes */
+    for (int s = 0; s < DIMS; ++s) {
+        origin[s] = PointSpace(part->ns[PIN][s][MIN], part->domain[s][MIN], part->d[s], part->ng);
+        d[s] = part->d[s];
+    }
+    const double gas[2] = {model->gamma, model->cv};
+    const int layout[3] = {varN, split, blockN};
+    fwrite("ArtraAQZ", sizeof(char), 8, filePointer);
+    fwrite(&now, sizeof(double), 1, filePointer);
+    fwrite(&(time->stepC), sizeof(int), 1, filePointer);
+    fwrite(nodeCount, sizeof(int), DIMS, filePointer);
+    fwrite(origin, sizeof(double), DIMS, filePointer);
+    fwrite(d, sizeof(double), DIMS, filePointer);
+    fwrite(gas, sizeof(double), 2, filePointer);
+    fwrite(layout, sizeof(int), 3, filePointer);
+    for (int b = 0; b < blockN; ++b) {
+        const int slab[LIMIT] = {b * thick, MinInt(thick, nodeCount[split] - b * thick)};
+        fwrite(slab, sizeof(int), LIMIT, filePointer);
+    }
+    fwrite(eb, sizeof(double), varN, filePointer);
+    fwrite(size, sizeof(int), varN * blockN, filePointer);
+    for (int t = 0; t < varN * blockN; ++t) {
+        fwrite(stream[t], sizeof(unsigned char), size[t], filePointer);
+        RetrieveStorage(stream[t]);
+    }
+    fclose(filePointer); /* close current opened file */
+    RetrieveStorage(stream);
+    RetrieveStorage(size);
+    return 0;
+}
+static Real PrimitiveValue(const int v, const Real U[restrict], const Model *model)
+{
+    switch (v) {
+        case 0: /* rho */
+            return U[0];
+        case 1: /* u */
+            return U[1] / U[0];
+        case 2: /* v */
+            return U[2] / U[0];
+        case 3: /* w */
+            return U[3] / U[0];
+        case 4: /* p */
+            return ComputePressure(model->gamma, U);
+        default:
+            return 0.0;
+    }
+}
+/* a good practice: end file with a newline */
@@ -30,14 +30,27 @@ static void TransformVertex(const Real [restrict], const Real [restrict],
         const Real [restrict][DIMS], const Real [restrict], Real [restrict][LIMIT], 
         const int, Real [restrict][DIMS]);
 static void TransformNormal(const Real [restrict][DIMS], const int, Real [restrict][DIMS]);
+static void ComposeTransform(const Real [restrict], const Real [restrict], const Real [restrict][DIMS],
+        const Real [restrict], Real [restrict][DIMS + 1]);
 static Real TransformInertia(const Real [restrict], Real [restrict][DIMS]);
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
-void ConvertPolyhedron(Polyhedron *poly)
+/*
+ * Conversion is performed in over-estimated scratch storage, then the
+ * topology is laid out with exact sizes in the arena.
+ */
+void ConvertPolyhedron(Arena *arena, Polyhedron *poly)
 {
-    /* allocate memory, assume over-estimated vertex and edge */
-    AllocatePolyhedronMemory(POLYN * poly->faceN, POLYN * poly->faceN, poly->faceN, poly);
+    /* assign scratch storage, assume over-estimated vertex and edge */
+    int (*f)[POLYN] = AssignStorage(poly->faceN * sizeof(*f));
+    int (*e)[EVF] = AssignStorage(POLYN * poly->faceN * sizeof(*e));
+    Real (*v)[DIMS] = AssignStorage(POLYN * poly->faceN * sizeof(*v));
+    poly->f = f;
+    poly->e = e;
+    poly->v = v;
+    poly->edgeN = 0;
+    poly->vertN = 0;
     /* convert representation */
     for (int n = 0; n < poly->faceN; ++n) {
         poly->f[n][0] = AddVertex(poly->facet[n].v0, poly);
@@ -48,23 +61,44 @@ void ConvertPolyhedron(Polyhedron *poly)
         AddEdge(poly->f[n][2], poly->f[n][0], n, poly); 
     }
     QuickSortEdge(poly->edgeN, poly->e);
-    /* adjust the memory allocation */
+    /* move to exact storage */
     RetrieveStorage(poly->facet);
     poly->facet = NULL;
-    poly->e = realloc(poly->e, poly->edgeN * sizeof(*poly->e));
-    poly->Ne = realloc(poly->Ne, poly->edgeN * sizeof(*poly->Ne));
-    poly->v = realloc(poly->v, poly->vertN * sizeof(*poly->v));
-    poly->Nv = realloc(poly->Nv, poly->vertN * sizeof(*poly->Nv));
+    AllocatePolyhedronMemory(poly->vertN, poly->edgeN, poly->faceN, arena, poly);
+    memcpy(poly->f, f, poly->faceN * sizeof(*f));
+    memcpy(poly->e, e, poly->edgeN * sizeof(*e));
+    memcpy(poly->v, v, poly->vertN * sizeof(*v));
+    RetrieveStorage(f);
+    RetrieveStorage(e);
+    RetrieveStorage(v);
     return;
 }
-void AllocatePolyhedronMemory(const int vertN, const int edgeN, const int faceN, Polyhedron *poly)
+/*
+ * The topology of a polyhedron is laid out contiguously in a single
+ * piece of arena storage. Real type data are placed first to keep the
+ * alignment without padding.
+ */
+void AllocatePolyhedronMemory(const int vertN, const int edgeN, const int faceN, 
+        Arena *arena, Polyhedron *poly)
 {
-    poly->f = AssignStorage(faceN * sizeof(*poly->f));
-    poly->Nf = AssignStorage(faceN * sizeof(*poly->Nf));
-    poly->e = AssignStorage(edgeN * sizeof(*poly->e));
-    poly->Ne = AssignStorage(edgeN * sizeof(*poly->Ne));
-    poly->v = AssignStorage(vertN * sizeof(*poly->v));
-    poly->Nv = AssignStorage(vertN * sizeof(*poly->Nv));
+    const size_t sizeV = vertN * sizeof(*poly->v);
+    const size_t sizeNv = vertN * sizeof(*poly->Nv);
+    const size_t sizeNf = faceN * sizeof(*poly->Nf);
+    const size_t sizeNe = edgeN * sizeof(*poly->Ne);
+    const size_t sizeF = faceN * sizeof(*poly->f);
+    const size_t sizeE = edgeN * sizeof(*poly->e);
+    char *pointer = AssignArenaStorage(arena, sizeV + sizeNv + sizeNf + sizeNe + sizeF + sizeE);
+    poly->v = (void *)pointer;
+    pointer = pointer + sizeV;
+    poly->Nv = (void *)pointer;
+    pointer = pointer + sizeNv;
+    poly->Nf = (void *)pointer;
+    pointer = pointer + sizeNf;
+    poly->Ne = (void *)pointer;
+    pointer = pointer + sizeNe;
+    poly->f = (void *)pointer;
+    pointer = pointer + sizeF;
+    poly->e = (void *)pointer;
     return;
 }
 static int AddVertex(const Real v[restrict], Polyhedron *poly)
@@ -177,6 +211,8 @@ void Transformation(const Real O[restrict], const Real scale[restrict], const Re
         {num, num, 0.0}, {0.0, num, num}, {num, 0.0, num}};
     RealVec axis = {0.0}; /* direction vector of axis in rotated frame */
     Real I[6] = {0.0}; /* inertia tensor after rotation */
+    /* accumulate the transform before the reference point moves */
+    ComposeTransform(O, scale, rotate, offset, poly->tf);
     /* transforming vertex and build the new bounding box */
     for (int s = 0; s < DIMS; ++s) {
         poly->box[s][MIN] = FLT_MAX;
@@ -236,6 +272,34 @@ static void TransformVertex(const Real O[restrict], const Real scale[restrict],
     }
     return;
 }
+/*
+ * For accumulated transform v = A v0 + b, a new transform gives
+ * v' = R S (v - O) + O + offset = (R S A) v0 + R S (b - O) + O + offset.
+ */
+static void ComposeTransform(const Real O[restrict], const Real scale[restrict], const Real rotate[restrict][DIMS],
+        const Real offset[restrict], Real tf[restrict][DIMS + 1])
+{
+    Real linear[DIMS][DIMS] = {{0.0}}; /* R S */
+    for (int r = 0; r < DIMS; ++r) {
+        for (int c = 0; c < DIMS; ++c) {
+            linear[r][c] = rotate[r][c] * scale[c];
+        }
+    }
+    Real old[DIMS][DIMS + 1] = {{0.0}};
+    for (int r = 0; r < DIMS; ++r) {
+        for (int c = 0; c <= DIMS; ++c) {
+            old[r][c] = tf[r][c];
+        }
+        old[r][DIMS] = old[r][DIMS] - O[r];
+    }
+    for (int r = 0; r < DIMS; ++r) {
+        for (int c = 0; c <= DIMS; ++c) {
+            tf[r][c] = linear[r][X] * old[X][c] + linear[r][Y] * old[Y][c] + linear[r][Z] * old[Z][c];
+        }
+        tf[r][DIMS] = tf[r][DIMS] + O[r] + offset[r];
+    }
+    return;
+}
 static void TransformNormal(const Real matrix[restrict][DIMS], const int normalN, Real N[restrict][DIMS])
 {
     RealVec tmp = {0.0};
@@ -28,10 +28,12 @@
  *
  * Function
  *      Convert polyhedron representation from STL to a mixture form
- *      of face-vertex mesh and winged-edge mesh.
+ *      of face-vertex mesh and winged-edge mesh. Topology storage is
+ *      assigned from the arena of the geometry.
  */
-extern void ConvertPolyhedron(Polyhedron *);
-extern void AllocatePolyhedronMemory(const int vertN, const int edgeN, const int faceN, Polyhedron *);
+extern void ConvertPolyhedron(Arena *, Polyhedron *);
+extern void AllocatePolyhedronMemory(const int vertN, const int edgeN, const int faceN, 
+        Arena *, Polyhedron *);
 extern void AddEdge(const int v0, const int v1, const int f, Polyhedron *);
 extern void QuickSortEdge(const int n, int e[restrict][EVF]);
 extern void BuildTriangle(const int fid, const Polyhedron *, Real v0[restrict], 
@@ -14,112 +14,188 @@
 #include "data_probe.h"
 #include <stdio.h> /* standard library for input and output */
 #include <stdlib.h> /* support for abs operation */
+#include <math.h> /* common mathematical functions */
+#include "primitive_cache.h"
 #include "cfd_commons.h"
 #include "immersed_boundary.h"
 #include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+typedef float ProbeReal; /* REAL32, probe data */
+/****************************************************************************
+ * Static Function Declarations
+ ****************************************************************************/
+static void BuildStencil(const Partition *, const Real [restrict], int [restrict], Real [restrict]);
+static void InitializeProbeSeries(const char *, const int, const int, const int, const Time *);
+static void WriteProbeSeries(const char *, const int, const int, const int,
+        const Time *, const Space *, const Model *);
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
-void WriteFieldDataAtPointProbes(const Time *time, const Space *space, const Model *model)
+void InitializeProbes(Time *time, const Space *space)
 {
-    if (0 == time->pointProbeN) {
+    const int probeN = time->pointProbeN + time->lineProbeN;
+    if (0 == probeN) {
         return;
     }
-    FILE *filePointer = NULL;
-    String fileName = {'\0'};
-    const Partition *restrict part = &(space->part);
-    const Node *const node = space->node;
-    int idx = 0; /* linear array index math variable */
-    Real Uo[DIMUo] = {0.0};
-    const IntVec nMin = {part->ng, part->ng, part->ng};
-    const IntVec nMax = {part->n[X] - part->ng, part->n[Y] - part->ng, part->n[Z] - part->ng};
-    const RealVec sMin = {part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN]};
-    const RealVec dd = {part->dd[X], part->dd[Y], part->dd[Z]};
-    const int ng = part->ng;
-    RealVec p1 = {0.0};
-    int i = 0, j = 0, k = 0;
+    ProbeStencil *st = &(time->stencil);
+    st->sep = AssignArenaStorage(&(time->arena), (probeN + 1) * sizeof(*st->sep));
     for (int n = 0; n < time->pointProbeN; ++n) {
-        snprintf(fileName, sizeof(fileName), "%s%03d.csv", "point_probe_", n + 1);
-        filePointer = fopen(fileName, "a");
-        if (NULL == filePointer) {
-            FatalError("failed to write data at probes...");
+        st->sep[n + 1] = st->sep[n] + 1;
+    }
+    for (int n = 0; n < time->lineProbeN; ++n) {
+        st->sep[time->pointProbeN + n + 1] = st->sep[time->pointProbeN + n] + 
+            MaxInt(time->lp[n][6] - 1, 1) + 1;
+    }
+    st->sampleN = st->sep[probeN];
+    st->idx = AssignArenaStorage(&(time->arena), st->sampleN * sizeof(*st->idx));
+    st->w = AssignArenaStorage(&(time->arena), st->sampleN * sizeof(*st->w));
+    st->p = AssignArenaStorage(&(time->arena), st->sampleN * sizeof(*st->p));
+    /* sample points */
+    for (int n = 0; n < time->pointProbeN; ++n) {
+        for (int s = 0; s < DIMS; ++s) {
+            st->p[st->sep[n]][s] = time->pp[n][s];
         }
-        if (0 == time->stepC) { /* this is the initialization step */
-            fprintf(filePointer, "# time, rho, u, v, w, p, T\n"); 
+    }
+    for (int n = 0; n < time->lineProbeN; ++n) {
+        const int start = st->sep[time->pointProbeN + n];
+        const int stepN = st->sep[time->pointProbeN + n + 1] - start - 1;
+        for (int m = 0; m <= stepN; ++m) {
+            for (int s = 0; s < DIMS; ++s) {
+                st->p[start + m][s] = time->lp[n][s] + m * (time->lp[n][DIMS + s] - time->lp[n][s]) / (Real)(stepN);
+            }
         }
-        p1[X] = time->pp[n][0];
-        p1[Y] = time->pp[n][1];
-        p1[Z] = time->pp[n][2];
-        i = ValidNodeSpace(NodeSpace(p1[X], sMin[X], dd[X], ng), nMin[X], nMax[X]);
-        j = ValidNodeSpace(NodeSpace(p1[Y], sMin[Y], dd[Y], ng), nMin[Y], nMax[Y]);
-        k = ValidNodeSpace(NodeSpace(p1[Z], sMin[Z], dd[Z], ng), nMin[Z], nMax[Z]);
-        idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-        PrimitiveByConservative(model->gamma, model->gasR, node[idx].U[TO], Uo);
-        fprintf(filePointer, "%.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g\n",
-                time->now, Uo[0], Uo[1], Uo[2], Uo[3], Uo[4], Uo[5]); 
-        fclose(filePointer); /* close current opened file */
+    }
+    for (int m = 0; m < st->sampleN; ++m) {
+        BuildStencil(&(space->part), st->p[m], st->idx[m], st->w[m]);
+    }
+    /* a new run starts the time series */
+    if (0 != time->restart) {
+        return;
+    }
+    for (int n = 0; n < time->pointProbeN; ++n) {
+        InitializeProbeSeries("point_probe_", n, st->sep[n], st->sep[n + 1], time);
+    }
+    for (int n = 0; n < time->lineProbeN; ++n) {
+        InitializeProbeSeries("line_probe_", n, st->sep[time->pointProbeN + n], 
+                st->sep[time->pointProbeN + n + 1], time);
+    }
+    return;
+}
+/*
+ * Stencil nodes are the corners of the cell containing the point in the
+ * interior domain, a point outside takes values of the nearest boundary.
+ * A dimension of a single node has the same node on both sides.
+ */
+static void BuildStencil(const Partition *part, const Real p[restrict], int idx[restrict], Real w[restrict])
+{
+    IntVec n0 = {0};
+    IntVec n1 = {0};
+    RealVec t = {0.0};
+    for (int s = 0; s < DIMS; ++s) {
+        const int nMin = part->ng;
+        const int nMax = part->n[s] - part->ng;
+        const Real f = (p[s] - part->domain[s][MIN]) * part->dd[s] + part->ng; /* continuous node space */
+        n0[s] = ValidNodeSpace((int)floor(f), nMin, MaxInt(nMin + 1, nMax - 1));
+        n1[s] = MinInt(n0[s] + 1, nMax - 1);
+        t[s] = (n1[s] == n0[s]) ? 0.0 : MinReal(1.0, MaxReal(0.0, f - n0[s]));
+    }
+    for (int c = 0; c < PROBEN; ++c) {
+        const int i = (c & 1) ? n1[X] : n0[X];
+        const int j = (c & 2) ? n1[Y] : n0[Y];
+        const int k = (c & 4) ? n1[Z] : n0[Z];
+        idx[c] = IndexNode(k, j, i, part->n[Y], part->n[X]);
+        w[c] = ((c & 1) ? t[X] : 1.0 - t[X]) * ((c & 2) ? t[Y] : 1.0 - t[Y]) * ((c & 4) ? t[Z] : 1.0 - t[Z]);
+    }
+    return;
+}
+static void InitializeProbeSeries(const char *rootName, const int n, const int start, const int end, const Time *time)
+{
+    String fileName = {'\0'};
+    snprintf(fileName, sizeof(fileName), "%s%03d.dat", rootName, n + 1);
+    FILE *filePointer = fopen(fileName, "wb");
+    if (NULL == filePointer) {
+        FatalError("failed to write data at probes...");
+    }
+    const int count[2] = {end - start, DIMUo};
+    fwrite("ArtraPRB", sizeof(char), 8, filePointer);
+    fwrite(count, sizeof(int), 2, filePointer);
+    for (int m = start; m < end; ++m) {
+        const ProbeReal p[DIMS] = {time->stencil.p[m][X], time->stencil.p[m][Y], time->stencil.p[m][Z]};
+        fwrite(p, sizeof(ProbeReal), DIMS, filePointer);
+    }
+    fclose(filePointer); /* close current opened file */
+    return;
+}
+void WriteFieldDataAtPointProbes(const Time *time, const Space *space, const Model *model)
+{
+    for (int n = 0; n < time->pointProbeN; ++n) {
+        WriteProbeSeries("point_probe_", n, time->stencil.sep[n], time->stencil.sep[n + 1],
+                time, space, model);
     }
     return;
 }
 void WriteFieldDataAtLineProbes(const Time *time, const Space *space, const Model *model)
 {
-    if (0 == time->lineProbeN) {
-        return;
+    for (int n = 0; n < time->lineProbeN; ++n) {
+        WriteProbeSeries("line_probe_", n, time->stencil.sep[time->pointProbeN + n], 
+                time->stencil.sep[time->pointProbeN + n + 1], time, space, model);
     }
-    FILE *filePointer = NULL;
+    return;
+}
+/*
+ * Samples gather primitive values of stencil nodes in the fluid or in ghost
+ * layers, weights are renormalized over these nodes. A sample surrounded by
+ * solid nodes only uses all stencil nodes.
+ */
+static void WriteProbeSeries(const char *rootName, const int n, const int start, const int end,
+        const Time *time, const Space *space, const Model *model)
+{
     String fileName = {'\0'};
-    const Partition *restrict part = &(space->part);
+    snprintf(fileName, sizeof(fileName), "%s%03d.dat", rootName, n + 1);
+    FILE *filePointer = fopen(fileName, "ab");
+    if (NULL == filePointer) {
+        FatalError("failed to write data at probes...");
+    }
+    const ProbeStencil *st = &(time->stencil);
     const Node *const node = space->node;
-    int idx = 0; /* linear array index math variable */
-    int idxOld = 0; /* linear array index math variable */
+    ProbeReal *data = AssignStorage((end - start) * DIMUo * sizeof(*data));
     Real Uo[DIMUo] = {0.0};
-    const IntVec nMin = {part->ng, part->ng, part->ng};
-    const IntVec nMax = {part->n[X] - part->ng, part->n[Y] - part->ng, part->n[Z] - part->ng};
-    const RealVec sMin = {part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN]};
-    const RealVec d = {part->d[X], part->d[Y], part->d[Z]};
-    const RealVec dd = {part->dd[X], part->dd[Y], part->dd[Z]};
-    const int ng = part->ng;
-    RealVec p1 = {0.0};
-    RealVec p2 = {0.0};
-    RealVec dl = {0.0};
-    int stepN = 0;
-    int i = 0, j = 0, k = 0;
-    for (int n = 0; n < time->lineProbeN; ++n) {
-        snprintf(fileName, sizeof(fileName), "%s%03d_%05d.csv", "line_probe_", n + 1, time->stepC);
-        filePointer = fopen(fileName, "w");
-        if (NULL == filePointer) {
-            FatalError("failed to write data at probes...");
+    Real value[DIMUo] = {0.0};
+    for (int m = start; m < end; ++m) {
+        Real sum = 0.0;
+        for (int c = 0; c < PROBEN; ++c) {
+            if ((0 == node[st->idx[m][c]].gid) || (0 < node[st->idx[m][c]].gst)) {
+                sum = sum + st->w[m][c];
+            }
         }
-        fprintf(filePointer, "# x, y, z, rho, u, v, w, p, T <time=%.6g>\n", time->now); 
-        p1[X] = time->lp[n][0];
-        p1[Y] = time->lp[n][1];
-        p1[Z] = time->lp[n][2];
-        p2[X] = time->lp[n][3];
-        p2[Y] = time->lp[n][4];
-        p2[Z] = time->lp[n][5];
-        stepN = MaxInt(time->lp[n][6] - 1, 1);
-        dl[X] = (p2[X] - p1[X]) / (Real)(stepN);
-        dl[Y] = (p2[Y] - p1[Y]) / (Real)(stepN);
-        dl[Z] = (p2[Z] - p1[Z]) / (Real)(stepN);
-        idxOld = -1; /* used to avoid repeating node for tiny step sizes */
-        for (int m = 0; m <= stepN; ++m) {
-            i = ValidNodeSpace(NodeSpace(p1[X] + m * dl[X], sMin[X], dd[X], ng), nMin[X], nMax[X]);
-            j = ValidNodeSpace(NodeSpace(p1[Y] + m * dl[Y], sMin[Y], dd[Y], ng), nMin[Y], nMax[Y]);
-            k = ValidNodeSpace(NodeSpace(p1[Z] + m * dl[Z], sMin[Z], dd[Z], ng), nMin[Z], nMax[Z]);
-            idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-            if (idxOld == idx) {
+        const int all = (0.0 >= sum); /* no stencil node in the fluid */
+        if (all) {
+            sum = 1.0;
+        }
+        for (int v = 0; v < DIMUo; ++v) {
+            value[v] = 0.0;
+        }
+        for (int c = 0; c < PROBEN; ++c) {
+            const int idx = st->idx[m][c];
+            if ((0.0 == st->w[m][c]) || (!all && (0 != node[idx].gid) && (0 >= node[idx].gst))) {
                 continue;
             }
-            idxOld = idx; /* record */
-            p2[X] = PointSpace(i, sMin[X], d[X], ng);
-            p2[Y] = PointSpace(j, sMin[Y], d[Y], ng);
-            p2[Z] = PointSpace(k, sMin[Z], d[Z], ng);
-            PrimitiveByConservative(model->gamma, model->gasR, node[idx].U[TO], Uo);
-            fprintf(filePointer, "%.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g\n",
-                    p2[X], p2[Y], p2[Z], Uo[0], Uo[1], Uo[2], Uo[3], Uo[4], Uo[5]); 
+            NodePrimitive(TO, idx, node, &(space->cache), model, Uo);
+            for (int v = 0; v < DIMUo; ++v) {
+                value[v] = value[v] + st->w[m][c] * Uo[v];
+            }
+        }
+        for (int v = 0; v < DIMUo; ++v) {
+            data[(m - start) * DIMUo + v] = value[v] / sum;
         }
-        fclose(filePointer); /* close current opened file */
     }
+    const double now = time->now;
+    fwrite(&now, sizeof(double), 1, filePointer);
+    fwrite(data, sizeof(ProbeReal), (end - start) * DIMUo, filePointer);
+    fclose(filePointer); /* close current opened file */
+    RetrieveStorage(data);
     return;
 }
 void WriteFieldDataAtCurveProbes(const Time *time, const Space *space, const Model *model)
@@ -135,17 +211,15 @@ void WriteFieldDataAtCurveProbes(const Time *time, const Space *space, const Mod
     Polyhedron *poly = NULL;
     int idx = 0; /* linear array index math variable */
     Real Uo[DIMUo] = {0.0};
-    const IntVec nMin = {part->ng, part->ng, part->ng};
-    const IntVec nMax = {part->n[X] - part->ng, part->n[Y] - part->ng, part->n[Z] - part->ng};
     const RealVec sMin = {part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN]};
     const RealVec d = {part->d[X], part->d[Y], part->d[Z]};
-    const RealVec dd = {part->dd[X], part->dd[Y], part->dd[Z]};
     const int ng = part->ng;
+    const int *sep = NULL; /* ghost node list separators */
+    const int *nG = NULL; /* ghost node */
     RealVec pG = {0.0}; /* ghost point */
     RealVec pO = {0.0}; /* boundary point */
     RealVec pI = {0.0}; /* image point */
     RealVec N = {0.0}; /* normal */
-    int box[DIMS][LIMIT] = {{0}}; /* bounding box in node space */
     for (int n = 0; n < geo->totN; ++n) {
         poly = geo->poly + n;
         snprintf(fileName, sizeof(fileName), "%s%03d_%05d.csv", "curve_probe_", n + 1, time->stepC);
@@ -154,27 +228,17 @@ void WriteFieldDataAtCurveProbes(const Time *time, const Space *space, const Mod
             FatalError("failed to write data at probes...");
         }
         fprintf(filePointer, "# x, y, z, Nx, Ny, Nz, rho, u, v, w, p, T <time=%.6g>\n", time->now); 
-        /* determine search range according to bounding box of polyhedron and valid node space */
-        for (int s = 0; s < DIMS; ++s) {
-            box[s][MIN] = ValidNodeSpace(NodeSpace(poly->box[s][MIN], sMin[s], dd[s], ng), nMin[s], nMax[s]);
-            box[s][MAX] = ValidNodeSpace(NodeSpace(poly->box[s][MAX], sMin[s], dd[s], ng), nMin[s], nMax[s]) + 1;
-        }
-        for (int k = box[Z][MIN]; k < box[Z][MAX]; ++k) {
-            for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
-                for (int i = box[X][MIN]; i < box[X][MAX]; ++i) {
-                    idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                    if ((1 != node[idx].gst) || (n + 1 != node[idx].gid)) {
-                        continue;
-                    }
-                    pG[X] = PointSpace(i, sMin[X], d[X], ng);
-                    pG[Y] = PointSpace(j, sMin[Y], d[Y], ng);
-                    pG[Z] = PointSpace(k, sMin[Z], d[Z], ng);
-                    ComputeGeometricData(node[idx].fid, poly, pG, pO, pI, N);
-                    PrimitiveByConservative(model->gamma, model->gasR, node[idx].U[TO], Uo);
-                    fprintf(filePointer, "%.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g\n",
-                            pO[X], pO[Y], pO[Z], N[X], N[Y], N[Z], Uo[0], Uo[1], Uo[2], Uo[3], Uo[4], Uo[5]); 
-                }
-            }
+        sep = NodeListSeparator(n, LISTGST, geo);
+        for (int m = sep[1]; m < sep[2]; ++m) {
+            nG = geo->list[m];
+            idx = IndexNode(nG[Z], nG[Y], nG[X], part->n[Y], part->n[X]);
+            pG[X] = PointSpace(nG[X], sMin[X], d[X], ng);
+            pG[Y] = PointSpace(nG[Y], sMin[Y], d[Y], ng);
+            pG[Z] = PointSpace(nG[Z], sMin[Z], d[Z], ng);
+            ComputeGeometricData(node[idx].fid, poly, pG, pO, pI, N);
+            NodePrimitive(TO, idx, node, &(space->cache), model, Uo);
+            fprintf(filePointer, "%.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g\n",
+                    pO[X], pO[Y], pO[Z], N[X], N[Y], N[Z], Uo[0], Uo[1], Uo[2], Uo[3], Uo[4], Uo[5]); 
         }
         fclose(filePointer); /* close current opened file */
     }
@@ -23,11 +23,23 @@
 /****************************************************************************
  * Public Functions Declaration
  ****************************************************************************/
+/*
+ * Initialize probes
+ *
+ * Function
+ *      Compile point and line probes into trilinear stencils of the interior
+ *      domain, and start their time series files for a non restart run.
+ */
+extern void InitializeProbes(Time *, const Space *);
 /*
  * Write probe data
  *
  * Function
- *      Write field data of probes.
+ *      Write field data of probes. Point and line probes append a record to
+ *      the binary time series point_probe_NNN.dat and line_probe_NNN.dat.
+ *      Layout: "ArtraPRB", sample count, variable count (int), coordinates of
+ *      samples (float), then records of time (double) and rho, u, v, w, p, T
+ *      of each sample (float).
  */
 extern void WriteFieldDataAtPointProbes(const Time *, const Space *, const Model *);
 extern void WriteFieldDataAtLineProbes(const Time *, const Space *, const Model *);
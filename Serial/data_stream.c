@@ -15,26 +15,48 @@
 #include <stdio.h> /* standard library for input and output */
 #include "paraview.h"
 #include "ensight.h"
+#include "compressed.h"
 #include "commons.h"
+/****************************************************************************
+ * Static Function Declarations
+ ****************************************************************************/
+static void WriteRegionCount(const Time *);
+static void ReadRegionCount(Time *);
 /****************************************************************************
  * Function Pointers
  ****************************************************************************/
 typedef int (*StructuredDataWriter)(const Time *, const Space *, const Model *);
 typedef int (*StructuredDataReader)(Time *, Space *, const Model *);
+typedef int (*RegionDataWriter)(const int, const Time *, const Space *, const Model *);
 typedef int (*PolyDataWriter)(const Time *, const Geometry *);
 typedef int (*PolyDataReader)(const Time *, Geometry *);
 /****************************************************************************
  * Global Variables Definition with Private Scope
  ****************************************************************************/
-static StructuredDataWriter WriteStructuredData[2] = {
+static StructuredDataWriter WriteStructuredData[4] = {
     WriteStructuredDataParaview,
-    WriteStructuredDataEnsight};
-static StructuredDataReader ReadStructuredData[2] = {
+    WriteStructuredDataEnsight,
+    WriteStructuredDataParaviewPieces,
+    WriteStructuredDataCompressed};
+static StructuredDataReader ReadStructuredData[4] = {
     ReadStructuredDataParaview,
-    ReadStructuredDataEnsight};
-static PolyDataWriter WritePolyData[1] = {
+    ReadStructuredDataEnsight,
+    ReadStructuredDataParaviewPieces,
+    ReadStructuredDataCompressed};
+static RegionDataWriter WriteRegionData[4] = {
+    WriteRegionDataParaview,
+    WriteRegionDataEnsight,
+    WriteRegionDataParaviewPieces,
+    WriteRegionDataParaview};
+static PolyDataWriter WritePolyData[4] = {
+    WritePolyDataParaview,
+    WritePolyDataParaview,
+    WritePolyDataParaviewPieces,
     WritePolyDataParaview};
-static PolyDataReader ReadPolyData[1] = {
+static PolyDataReader ReadPolyData[4] = {
+    ReadPolyDataParaview,
+    ReadPolyDataParaview,
+    ReadPolyDataParaviewPieces,
     ReadPolyDataParaview};
 /****************************************************************************
  * Function definitions
@@ -42,19 +64,78 @@ static PolyDataReader ReadPolyData[1] = {
 int WriteFieldData(const Time *time, const Space *space, const Model *model)
 {
     WriteStructuredData[time->dataStreamer](time, space, model);
+    WriteRegionCount(time);
+    return 0;
+}
+int WriteFieldDataOfRegion(const int n, const Time *time, const Space *space, const Model *model)
+{
+    WriteRegionData[time->dataStreamer](n, time, space, model);
     return 0;
 }
 int ReadFieldData(Time *time, Space *space, const Model *model)
 {
     ReadStructuredData[time->dataStreamer](time, space, model);
+    ReadRegionCount(time);
     return 0;
 }
+/*
+ * Writing counts of region outputs are kept with each field data in
+ * fieldNNNNN.reg, a restart continues the region series from them. Region
+ * outputs of a step are written before the field data of the step.
+ */
+static void WriteRegionCount(const Time *time)
+{
+    if (0 == time->outputN) {
+        return;
+    }
+    String fileName = {'\0'};
+    snprintf(fileName, sizeof(fileName), "field%05d.reg", time->writeC);
+    FILE *filePointer = fopen(fileName, "w");
+    if (NULL == filePointer) {
+        FatalError("failed to write region output counts...");
+    }
+    fprintf(filePointer, "%d\n", time->outputN);
+    for (int n = 0; n < time->outputN; ++n) {
+        fprintf(filePointer, "%d\n", time->output[n].writeC);
+    }
+    fclose(filePointer); /* close current opened file */
+    return;
+}
+/*
+ * Region outputs without a recorded count start new series.
+ */
+static void ReadRegionCount(Time *time)
+{
+    if (0 == time->outputN) {
+        return;
+    }
+    String fileName = {'\0'};
+    snprintf(fileName, sizeof(fileName), "field%05d.reg", time->writeC);
+    FILE *filePointer = fopen(fileName, "r");
+    if (NULL == filePointer) {
+        return;
+    }
+    String currentLine = {'\0'}; /* store current line */
+    int outputN = 0;
+    Fgets(currentLine, sizeof currentLine, filePointer);
+    VerifyReadConversion(sscanf(currentLine, "%d", &outputN), 1);
+    for (int n = 0; (n < outputN) && (n < time->outputN); ++n) {
+        Fgets(currentLine, sizeof currentLine, filePointer);
+        VerifyReadConversion(sscanf(currentLine, "%d", &(time->output[n].writeC)), 1);
+    }
+    fclose(filePointer); /* close current opened file */
+    return;
+}
 int WriteGeometryData(const Time *time, const Geometry *geo)
 {
     if (0 == geo->totN) {
         return 0;
     }
-    WritePolyData[0](time, geo);
+    if (1 == time->geoMode) {
+        WritePolyDataParaviewTransform(time, geo);
+        return 0;
+    }
+    WritePolyData[time->dataStreamer](time, geo);
     return 0;
 }
 int ReadGeometryData(const Time *time, Geometry *geo)
@@ -62,7 +143,11 @@ int ReadGeometryData(const Time *time, Geometry *geo)
     if (0 == geo->totN) {
         return 0;
     }
-    ReadPolyData[0](time, geo);
+    if (1 == time->geoMode) {
+        ReadPolyDataParaviewTransform(time, geo);
+        return 0;
+    }
+    ReadPolyData[time->dataStreamer](time, geo);
     return 0;
 }
 /* a good practice: end file with a newline */
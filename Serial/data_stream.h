@@ -27,6 +27,10 @@
  * Export field data
  */
 extern int WriteFieldData(const Time *, const Space *, const Model *);
+/*
+ * Export field data of the n-th region output
+ */
+extern int WriteFieldDataOfRegion(const int n, const Time *, const Space *, const Model *);
 /*
  * Load field data
  */
@@ -12,7 +12,13 @@
  * Required Header Files
  ****************************************************************************/
 #include "domain_partition.h"
+#include "cfd_commons.h"
 #include "commons.h"
+/****************************************************************************
+ * Static Function Declarations
+ ****************************************************************************/
+static void BoundaryConditionList(Partition *);
+static int BoundaryConditionOperation(const int, const int);
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
@@ -232,7 +238,135 @@ int DomainPartition(Space *space)
     part->pathSep[3] = part->pathSep[2] + base; /* end index for layer 3 */
     /* max search path for a spatial scheme */
     part->pathSep[0] = part->pathSep[2] + (part->gl - 2) * base;
+    /*
+     * Boundary condition lists
+     */
+    BoundaryConditionList(part);
     return 0;
 }
+/*
+ * The lists are built in the order of treatment: layer by layer from inside
+ * to outside, and boundary by boundary within each layer. The boxes of
+ * ghost layers extend to the tangential ghost regions to treat corner ghost
+ * nodes. For each node, the donor node is the node from which the target
+ * node takes data, and the image node is the node reflected by the method
+ * of image; unused indices are set to the target node.
+ */
+static void BoundaryConditionList(Partition *part)
+{
+    if (BCLAYER <= part->ng) {
+        FatalError("too many ghost layers for boundary condition lists");
+    }
+    BCList *bcl = NULL;
+    int totN = 0;
+    for (int r = 0; r <= part->ng; ++r) {
+        for (int p = PWB; p < PWG; ++p) {
+            bcl = &(part->bcl[p][r]);
+            const IntVec N = {part->N[p][X], part->N[p][Y], part->N[p][Z]};
+            for (int s = 0; s < DIMS; ++s) {
+                bcl->box[s][MIN] = part->ns[p][s][MIN] + r * (N[s] - !N[s]);
+                bcl->box[s][MAX] = part->ns[p][s][MAX] + r * (N[s] + !N[s]);
+            }
+            bcl->op = BoundaryConditionOperation(part->typeBC[p], r);
+            bcl->n = 0;
+            if (BCNONE != bcl->op) {
+                bcl->n = (bcl->box[X][MAX] - bcl->box[X][MIN]) * (bcl->box[Y][MAX] - bcl->box[Y][MIN]) *
+                    (bcl->box[Z][MAX] - bcl->box[Z][MIN]);
+            }
+            totN = totN + bcl->n;
+        }
+    }
+    part->bcIdx = NULL;
+    if (0 < totN) {
+        part->bcIdx = AssignStorage(totN * sizeof(*part->bcIdx));
+    }
+    int count = 0; /* entry count */
+    for (int r = 0; r <= part->ng; ++r) {
+        for (int p = PWB; p < PWG; ++p) {
+            bcl = &(part->bcl[p][r]);
+            bcl->idx = part->bcIdx + count;
+            if (BCNONE == bcl->op) {
+                continue;
+            }
+            const IntVec N = {part->N[p][X], part->N[p][Y], part->N[p][Z]};
+            const IntVec LN = {part->m[X] * N[X], part->m[Y] * N[Y], part->m[Z] * N[Z]};
+            /* offsets of donor and image nodes */
+            IntVec D = {N[X], N[Y], N[Z]};
+            IntVec I = {0, 0, 0};
+            if ((0 != r) && (PERIODIC == part->typeBC[p])) {
+                D[X] = LN[X];
+                D[Y] = LN[Y];
+                D[Z] = LN[Z];
+            }
+            if (BCIMAGE == bcl->op) {
+                for (int s = 0; s < DIMS; ++s) {
+                    D[s] = r * N[s];
+                    I[s] = 2 * r * N[s];
+                }
+            }
+            if (BCVALUE == bcl->op) {
+                D[X] = 0;
+                D[Y] = 0;
+                D[Z] = 0;
+            }
+            for (int k = bcl->box[Z][MIN]; k < bcl->box[Z][MAX]; ++k) {
+                for (int j = bcl->box[Y][MIN]; j < bcl->box[Y][MAX]; ++j) {
+                    for (int i = bcl->box[X][MIN]; i < bcl->box[X][MAX]; ++i) {
+                        part->bcIdx[count][0] = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                        part->bcIdx[count][1] = IndexNode(k - D[Z], j - D[Y], i - D[X], part->n[Y], part->n[X]);
+                        part->bcIdx[count][2] = IndexNode(k - I[Z], j - I[Y], i - I[X], part->n[Y], part->n[X]);
+                        ++count;
+                    }
+                }
+            }
+        }
+    }
+    return;
+}
+/*
+ * Operations of physical boundary conditions on the boundary layer and of
+ * numerical boundary treatments on ghost layers. Periodic boundaries are
+ * computed as normal nodes, and data of coarse-fine interfaces are
+ * provided by the coarse grid.
+ */
+static int BoundaryConditionOperation(const int typeBC, const int r)
+{
+    if (0 != r) {
+        switch (typeBC) {
+            case SLIPWALL:
+            case NOSLIPWALL:
+                return BCIMAGE;
+            case INTERFACE:
+                return BCNONE;
+            default:
+                return BCCOPY;
+        }
+    }
+    switch (typeBC) {
+        case INFLOW:
+            return BCVALUE;
+        case OUTFLOW:
+            return BCCOPY;
+        case SLIPWALL:
+            return BCSLIP;
+        case NOSLIPWALL:
+            return BCNOSLIP;
+        default:
+            return BCNONE;
+    }
+}
+void ReleaseDomainPartition(Space *space)
+{
+    Partition *part = &(space->part);
+    RetrieveStorage(part->bcIdx);
+    part->bcIdx = NULL;
+    for (int p = 0; p < NBC; ++p) {
+        for (int r = 0; r < BCLAYER; ++r) {
+            part->bcl[p][r].n = 0;
+            part->bcl[p][r].idx = NULL;
+        }
+    }
+    return;
+}
 /* a good practice: end file with a newline */
 
@@ -28,9 +28,11 @@
  *
  * Function
  *      Decomposite the computational domain, and provide the index range
- *      for each partitions.
+ *      for each partitions and the node lists of domain boundary
+ *      conditions. Release the lists of a partitioned space.
  */
 extern int DomainPartition(Space *);
+extern void ReleaseDomainPartition(Space *);
 #endif
 /* a good practice: end file with a newline */
 
@@ -33,6 +33,9 @@ typedef struct {
     EnsightString baseName; /* data file base name */
     EnsightString fileName; /* store current open file name */
     EnsightString stringData; /* Ensight string data */
+    int range[DIMS][LIMIT]; /* node range of the output region */
+    int stride[DIMS]; /* sub-sampling stride of the output region */
+    int var; /* bit mask of output variables */
 }EnsightSet;
 /****************************************************************************
  * Public Functions Declaration
@@ -42,6 +45,14 @@ typedef struct {
  */
 extern int WriteStructuredDataEnsight(const Time *, const Space *, const Model *);
 extern int ReadStructuredDataEnsight(Time *, Space *, const Model *);
+/*
+ * Region output writer
+ *
+ * Function
+ *      Write the n-th region output of time as a separate transient case
+ *      with root name regionN_ and its own geometry file.
+ */
+extern int WriteRegionDataEnsight(const int n, const Time *, const Space *, const Model *);
 #endif
 /* a good practice: end file with a newline */
 
@@ -67,55 +67,45 @@ static int ReadCaseFile(Time *time, EnsightSet *enSet)
 static int ReadStructuredData(Space *space, const Model *model, EnsightSet *enSet)
 {
     FILE *filePointer = NULL;
-    EnsightReal data = 0.0; /* the Ensight data format */
     const char scalar[5][5] = {"rho", "u", "v", "w", "p"};
     const Partition *restrict part = &(space->part);
     Node *const node = space->node;
-    Real *restrict U = NULL;
-    int idx = 0; /* linear array index math variable */
-    for (int count = 0; count < DIMU; ++count) {
+    const int totN = (part->ns[PIN][X][MAX] - part->ns[PIN][X][MIN]) *
+        (part->ns[PIN][Y][MAX] - part->ns[PIN][Y][MIN]) * (part->ns[PIN][Z][MAX] - part->ns[PIN][Z][MIN]);
+    /* each variable is loaded by a single block read */
+    EnsightReal *data = AssignStorage(DIMU * totN * sizeof(*data));
+    for (int count = 0, partNum = 1; count < DIMU; ++count) {
         snprintf(enSet->fileName, sizeof(EnsightString), "%s.%s", enSet->baseName, scalar[count]);
         filePointer = fopen(enSet->fileName, "rb");
         if (NULL == filePointer) {
             FatalError("failed to open data file...");
         }
         Fread(enSet->stringData, sizeof(char), sizeof(EnsightString), filePointer);
-        for (int p = PIN, partNum = 1; p < NPARTWRITE; ++p) {
-            Fread(enSet->stringData, sizeof(char), sizeof(EnsightString), filePointer);
-            Fread(&partNum, sizeof(int), 1, filePointer);
-            Fread(enSet->stringData, sizeof(char), sizeof(EnsightString), filePointer);
-            for (int k = part->ns[p][Z][MIN]; k < part->ns[p][Z][MAX]; ++k) {
-                for (int j = part->ns[p][Y][MIN]; j < part->ns[p][Y][MAX]; ++j) {
-                    for (int i = part->ns[p][X][MIN]; i < part->ns[p][X][MAX]; ++i) {
-                        idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                        U = node[idx].U[TO];
-                        Fread(&data, sizeof(EnsightReal), 1, filePointer);
-                        switch (count) {
-                            case 0: /* rho */
-                                U[0] = data;
-                                break;
-                            case 1: /* u */
-                                U[1] = U[0] * data;
-                                break;
-                            case 2: /* v */
-                                U[2] = U[0] * data;
-                                break;
-                            case 3: /* w */
-                                U[3] = U[0] * data;
-                                break;
-                            case 4: /* p */
-                                U[4] = 0.5 * (U[1] * U[1] + U[2] * U[2] + U[3] * U[3]) / U[0] + 
-                                    data / (model->gamma - 1.0);
-                                break;
-                            default:
-                                break;
-                        }
-                    }
-                }
+        Fread(enSet->stringData, sizeof(char), sizeof(EnsightString), filePointer);
+        Fread(&partNum, sizeof(int), 1, filePointer);
+        Fread(enSet->stringData, sizeof(char), sizeof(EnsightString), filePointer);
+        Fread(data + count * totN, sizeof(EnsightReal), totN, filePointer);
+        fclose(filePointer); /* close current opened file */
+    }
+    const EnsightReal *rho = data;
+    const EnsightReal *u = data + totN;
+    const EnsightReal *v = data + 2 * totN;
+    const EnsightReal *w = data + 3 * totN;
+    const EnsightReal *p = data + 4 * totN;
+    for (int k = part->ns[PIN][Z][MIN], m = 0; k < part->ns[PIN][Z][MAX]; ++k) {
+        for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
+            for (int i = part->ns[PIN][X][MIN]; i < part->ns[PIN][X][MAX]; ++i, ++m) {
+                Real *restrict U = node[IndexNode(k, j, i, part->n[Y], part->n[X])].U[TO];
+                U[0] = rho[m];
+                U[1] = U[0] * u[m];
+                U[2] = U[0] * v[m];
+                U[3] = U[0] * w[m];
+                U[4] = 0.5 * (U[1] * U[1] + U[2] * U[2] + U[3] * U[3]) / U[0] + 
+                    p[m] / (model->gamma - 1.0);
             }
         }
-        fclose(filePointer); /* close current opened file */
     }
+    RetrieveStorage(data);
     return 0;
 }
 /* a good practice: end file with a newline */
@@ -19,28 +19,68 @@
 /****************************************************************************
  * Static Function Declarations
  ****************************************************************************/
+static int WriteFieldOutput(const int, const Time *, const Space *, const Model *);
 static int InitializeTransientCaseFile(EnsightSet *);
-static int WriteCaseFile(const Time *, EnsightSet *);
+static int WriteCaseFile(const int, const Time *, EnsightSet *);
 static int WriteGeometryFile(const Space *, EnsightSet *);
 static int WriteStructuredData(const Space *, const Model *, EnsightSet *);
+/****************************************************************************
+ * Global Variables Definition with Private Scope
+ ****************************************************************************/
+static const char scalar[VAROUT-1][4] = {"rho", "u", "v", "w", "p", "T", "gid", "fid", "lid", "gst"};
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
 int WriteStructuredDataEnsight(const Time *time, const Space *space, const Model *model)
+{
+    return WriteFieldOutput(NONE, time, space, model);
+}
+int WriteRegionDataEnsight(const int n, const Time *time, const Space *space, const Model *model)
+{
+    return WriteFieldOutput(n, time, space, model);
+}
+/*
+ * Write the n-th region output, or field data of the whole interior domain
+ * if n is NONE.
+ */
+static int WriteFieldOutput(const int n, const Time *time, const Space *space, const Model *model)
 {
     EnsightSet enSet = { /* initialize environment */
         .rootName = "field", /* data file root name */
         .baseName = {'\0'}, /* data file base name */
         .fileName = {'\0'}, /* data file name */
         .stringData = {'\0'}, /* string data recorder */
+        .var = ((1 << 7) - 1) | (1 << (VAROUT - 1)) /* rho, u, v, w, p, T, gid, Vel */
     };
+    const Partition *restrict part = &(space->part);
+    int writeC = time->writeC; /* writing count */
+    int init = (0 == time->stepC); /* this is the initialization step */
+    for (int s = 0; s < DIMS; ++s) {
+        enSet.range[s][MIN] = part->ns[PIN][s][MIN];
+        enSet.range[s][MAX] = part->ns[PIN][s][MAX];
+        enSet.stride[s] = 1;
+    }
+    if (NONE != n) {
+        const FieldOutput *out = time->output + n;
+        snprintf(enSet.rootName, sizeof(EnsightString), "region%d_", n + 1); 
+        writeC = out->writeC;
+        init = (0 == writeC); /* a region series continues across restarts */
+        for (int s = 0; s < DIMS; ++s) {
+            enSet.range[s][MIN] = ValidNodeSpace(NodeSpace(out->box[s][MIN], part->domain[s][MIN], 
+                        part->dd[s], part->ng), part->ns[PIN][s][MIN], part->ns[PIN][s][MAX]);
+            enSet.range[s][MAX] = ValidNodeSpace(NodeSpace(out->box[s][MAX], part->domain[s][MIN], 
+                        part->dd[s], part->ng), part->ns[PIN][s][MIN], part->ns[PIN][s][MAX]) + 1;
+            enSet.stride[s] = out->stride[s];
+        }
+        enSet.var = out->var;
+    }
     snprintf(enSet.baseName, sizeof(EnsightString), "%s%05d", 
-            enSet.rootName, time->writeC); 
-    if (0 == time->stepC) { /* this is the initialization step */
+            enSet.rootName, writeC); 
+    if (init) {
         InitializeTransientCaseFile(&enSet);
         WriteGeometryFile(space, &enSet);
     }
-    WriteCaseFile(time, &enSet);
+    WriteCaseFile(writeC, time, &enSet);
     WriteStructuredData(space, model, &enSet);
     return 0;
 }
@@ -60,14 +100,15 @@ static int InitializeTransientCaseFile(EnsightSet *enSet)
     fprintf(filePointer, "model:  %s.geo\n", enSet->rootName); 
     fprintf(filePointer, "\n"); 
     fprintf(filePointer, "VARIABLE\n"); 
-    fprintf(filePointer, "scalar per node:  1  rho  %s*****.rho\n", enSet->rootName); 
-    fprintf(filePointer, "scalar per node:  1  u    %s*****.u\n", enSet->rootName); 
-    fprintf(filePointer, "scalar per node:  1  v    %s*****.v\n", enSet->rootName); 
-    fprintf(filePointer, "scalar per node:  1  w    %s*****.w\n", enSet->rootName); 
-    fprintf(filePointer, "scalar per node:  1  p    %s*****.p\n", enSet->rootName); 
-    fprintf(filePointer, "scalar per node:  1  T    %s*****.T\n", enSet->rootName); 
-    fprintf(filePointer, "scalar per node:  1  gid  %s*****.gid\n", enSet->rootName); 
-    fprintf(filePointer, "vector per node:  1  Vel  %s*****.Vel\n", enSet->rootName); 
+    for (int count = 0; count < (VAROUT - 1); ++count) {
+        if (enSet->var & (1 << count)) {
+            fprintf(filePointer, "scalar per node:  1  %-5s%s*****.%s\n", 
+                    scalar[count], enSet->rootName, scalar[count]); 
+        }
+    }
+    if (enSet->var & (1 << (VAROUT - 1))) {
+        fprintf(filePointer, "vector per node:  1  Vel  %s*****.Vel\n", enSet->rootName); 
+    }
     fprintf(filePointer, "\n"); 
     fprintf(filePointer, "TIME\n"); 
     fprintf(filePointer, "time set: 1\n"); 
@@ -78,7 +119,7 @@ static int InitializeTransientCaseFile(EnsightSet *enSet)
     fclose(filePointer); /* close current opened file */
     return 0;
 }
-static int WriteCaseFile(const Time *time, EnsightSet *enSet)
+static int WriteCaseFile(const int writeC, const Time *time, EnsightSet *enSet)
 {
     snprintf(enSet->fileName, sizeof(EnsightString), "%s.case", 
             enSet->baseName); 
@@ -96,14 +137,15 @@ static int WriteCaseFile(const Time *time, EnsightSet *enSet)
     fprintf(filePointer, "VARIABLE\n"); 
     fprintf(filePointer, "constant per case:  Time  %.6g\n", time->now);
     fprintf(filePointer, "constant per case:  Step  %d\n", time->stepC);
-    fprintf(filePointer, "scalar per node:    rho   %s.rho\n", enSet->baseName); 
-    fprintf(filePointer, "scalar per node:    u     %s.u\n", enSet->baseName); 
-    fprintf(filePointer, "scalar per node:    v     %s.v\n", enSet->baseName); 
-    fprintf(filePointer, "scalar per node:    w     %s.w\n", enSet->baseName); 
-    fprintf(filePointer, "scalar per node:    p     %s.p\n", enSet->baseName); 
-    fprintf(filePointer, "scalar per node:    T     %s.T\n", enSet->baseName); 
-    fprintf(filePointer, "scalar per node:    gid   %s.gid\n", enSet->baseName); 
-    fprintf(filePointer, "vector per node:    Vel   %s.Vel\n", enSet->baseName); 
+    for (int count = 0; count < (VAROUT - 1); ++count) {
+        if (enSet->var & (1 << count)) {
+            fprintf(filePointer, "scalar per node:    %-6s%s.%s\n", 
+                    scalar[count], enSet->baseName, scalar[count]); 
+        }
+    }
+    if (enSet->var & (1 << (VAROUT - 1))) {
+        fprintf(filePointer, "vector per node:    Vel   %s.Vel\n", enSet->baseName); 
+    }
     fprintf(filePointer, "\n"); 
     fclose(filePointer); /* close current opened file */
     /*
@@ -117,10 +159,10 @@ static int WriteCaseFile(const Time *time, EnsightSet *enSet)
     }
     /* seek the target line for adding information */
     ReadInLine(filePointer, "time set: 1");
-    fprintf(filePointer, "number of steps:          %d", (time->writeC + 1)); 
+    fprintf(filePointer, "number of steps:          %d", (writeC + 1)); 
     /* add the time flag of current export to the transient case */
     fseek(filePointer, 0, SEEK_END); // seek to the end of file
-    if ((time->writeC % 5) == 0) { /* print to a new line every x outputs */
+    if ((writeC % 5) == 0) { /* print to a new line every x outputs */
         fprintf(filePointer, "\n"); 
     }
     fprintf(filePointer, "%.6g ", time->now); 
@@ -139,8 +181,8 @@ static int WriteGeometryFile(const Space *space, EnsightSet *enSet)
     if (NULL == filePointer) {
         FatalError("failed to open data file...");
     }
-    EnsightReal data = 0.0; /* the Ensight data format */
     const Partition *restrict part = &(space->part);
+    const int *stride = enSet->stride;
     IntVec nodeCount = {0}; /* i, j, k node number in each part */
     /*
      * Output information to file, need to strictly follow the Ensight data format.
@@ -160,46 +202,38 @@ static int WriteGeometryFile(const Space *space, EnsightSet *enSet)
     fwrite(enSet->stringData, sizeof(char), sizeof(EnsightString), filePointer);
     strncpy(enSet->stringData, "element id off", sizeof(EnsightString));
     fwrite(enSet->stringData, sizeof(char), sizeof(EnsightString), filePointer);
-    for (int p = PIN, partNum = 1; p < NPARTWRITE; ++p, ++partNum) {
-        strncpy(enSet->stringData, "part", sizeof(EnsightString));
-        fwrite(enSet->stringData, sizeof(char), sizeof(EnsightString), filePointer);
-        fwrite(&partNum, sizeof(int), 1, filePointer);
-        snprintf(enSet->stringData, sizeof(EnsightString), "part %d", p);
-        fwrite(enSet->stringData, sizeof(char), sizeof(EnsightString), filePointer);
-        strncpy(enSet->stringData, "block", sizeof(EnsightString));
-        fwrite(enSet->stringData, sizeof(char), sizeof(EnsightString), filePointer);
-        nodeCount[X] = part->ns[p][X][MAX] - part->ns[p][X][MIN]; 
-        nodeCount[Y] = part->ns[p][Y][MAX] - part->ns[p][Y][MIN]; 
-        nodeCount[Z] = part->ns[p][Z][MAX] - part->ns[p][Z][MIN]; 
-        fwrite(nodeCount, sizeof(int), 3, filePointer);
-        /* now output the x coordinates of all nodes in current part */
-        for (int k = part->ns[p][Z][MIN]; k < part->ns[p][Z][MAX]; ++k) {
-            for (int j = part->ns[p][Y][MIN]; j < part->ns[p][Y][MAX]; ++j) {
-                for (int i = part->ns[p][X][MIN]; i < part->ns[p][X][MAX]; ++i) {
-                    data = PointSpace(i, part->domain[X][MIN], part->d[X], part->ng);
-                    fwrite(&data, sizeof(EnsightReal), 1, filePointer);
-                }
-            }
-        }
-        /* now output the y coordinates of all nodes in current part */
-        for (int k = part->ns[p][Z][MIN]; k < part->ns[p][Z][MAX]; ++k) {
-            for (int j = part->ns[p][Y][MIN]; j < part->ns[p][Y][MAX]; ++j) {
-                for (int i = part->ns[p][X][MIN]; i < part->ns[p][X][MAX]; ++i) {
-                    data = PointSpace(j, part->domain[Y][MIN], part->d[Y], part->ng);
-                    fwrite(&data, sizeof(EnsightReal), 1, filePointer);
-                }
-            }
-        }
-        /* now output the z coordinates of all nodes in current part */
-        for (int k = part->ns[p][Z][MIN]; k < part->ns[p][Z][MAX]; ++k) {
-            for (int j = part->ns[p][Y][MIN]; j < part->ns[p][Y][MAX]; ++j) {
-                for (int i = part->ns[p][X][MIN]; i < part->ns[p][X][MAX]; ++i) {
-                    data = PointSpace(k, part->domain[Z][MIN], part->d[Z], part->ng);
-                    fwrite(&data, sizeof(EnsightReal), 1, filePointer);
+    /* the output region is written as a single part */
+    const int partNum = 1;
+    strncpy(enSet->stringData, "part", sizeof(EnsightString));
+    fwrite(enSet->stringData, sizeof(char), sizeof(EnsightString), filePointer);
+    fwrite(&partNum, sizeof(int), 1, filePointer);
+    snprintf(enSet->stringData, sizeof(EnsightString), "part %d", PIN);
+    fwrite(enSet->stringData, sizeof(char), sizeof(EnsightString), filePointer);
+    strncpy(enSet->stringData, "block", sizeof(EnsightString));
+    fwrite(enSet->stringData, sizeof(char), sizeof(EnsightString), filePointer);
+    nodeCount[X] = (enSet->range[X][MAX] - enSet->range[X][MIN] - 1) / stride[X] + 1; 
+    nodeCount[Y] = (enSet->range[Y][MAX] - enSet->range[Y][MIN] - 1) / stride[Y] + 1; 
+    nodeCount[Z] = (enSet->range[Z][MAX] - enSet->range[Z][MIN] - 1) / stride[Z] + 1; 
+    fwrite(nodeCount, sizeof(int), 3, filePointer);
+    /* x, y, z coordinates of all nodes in current part, a chunk of planes per write */
+    const int planeN = nodeCount[X] * nodeCount[Y];
+    const int chunkK = MaxInt(1, ENSIGHTCHUNK / planeN) * stride[Z]; /* k range of a chunk */
+    EnsightReal *buffer = AssignStorage(MinInt(chunkK / stride[Z], nodeCount[Z]) * planeN * sizeof(*buffer));
+    for (int s = 0; s < DIMS; ++s) {
+        for (int kc = enSet->range[Z][MIN]; kc < enSet->range[Z][MAX]; kc += chunkK) {
+            int m = 0; /* number of buffered values */
+            for (int k = kc; k < MinInt(kc + chunkK, enSet->range[Z][MAX]); k += stride[Z]) {
+                for (int j = enSet->range[Y][MIN]; j < enSet->range[Y][MAX]; j += stride[Y]) {
+                    for (int i = enSet->range[X][MIN]; i < enSet->range[X][MAX]; i += stride[X], ++m) {
+                        const int ijk[DIMS] = {i, j, k};
+                        buffer[m] = PointSpace(ijk[s], part->domain[s][MIN], part->d[s], part->ng);
+                    }
                 }
             }
+            fwrite(buffer, sizeof(EnsightReal), m, filePointer);
         }
     }
+    RetrieveStorage(buffer);
     fclose(filePointer); /* close current opened file */
     return 0;
 }
@@ -210,95 +244,98 @@ static int WriteGeometryFile(const Space *space, EnsightSet *enSet)
  */
 static int WriteStructuredData(const Space *space, const Model *model, EnsightSet *enSet)
 {
-    FILE *filePointer = NULL;
-    EnsightReal data = 0.0; /* the Ensight data format */
-    const char scalar[7][5] = {"rho", "u", "v", "w", "p", "T", "gid"};
+    FILE *filePointer[VAROUT] = {NULL}; /* data files of output variables */
     const Partition *restrict part = &(space->part);
     const Node *const node = space->node;
-    const Real *restrict U = NULL;
-    int idx = 0; /* linear array index math variable */
-    for (int count = 0; count < 7; ++count) {
-        snprintf(enSet->fileName, sizeof(EnsightString), "%s.%s", enSet->baseName, scalar[count]);
-        filePointer = fopen(enSet->fileName, "wb");
-        if (NULL == filePointer) {
+    const int *stride = enSet->stride;
+    const int partNum = 1; /* the output region is written as a single part */
+    for (int count = 0; count < VAROUT; ++count) {
+        if (!(enSet->var & (1 << count))) {
+            continue;
+        }
+        if ((VAROUT - 1) == count) {
+            snprintf(enSet->fileName, sizeof(EnsightString), "%s.Vel", enSet->baseName);
+        } else {
+            if ((int)sizeof(EnsightString) <= snprintf(enSet->fileName, sizeof(EnsightString), "%s.%s",
+                        enSet->baseName, scalar[count])) {
+                FatalError("data file name is too long...");
+            }
+        }
+        filePointer[count] = fopen(enSet->fileName, "wb");
+        if (NULL == filePointer[count]) {
             FatalError("failed to open data file...");
         }
         /* first line description per file */
-        strncpy(enSet->stringData, "scalar variable", sizeof(EnsightString));
-        fwrite(enSet->stringData, sizeof(char), sizeof(EnsightString), filePointer);
-        for (int p = PIN, partNum = 1; p < NPARTWRITE; ++p, ++partNum) {
-            /* binary file format */
-            strncpy(enSet->stringData, "part", sizeof(EnsightString));
-            fwrite(enSet->stringData, sizeof(char), sizeof(EnsightString), filePointer);
-            fwrite(&partNum, sizeof(int), 1, filePointer);
-            strncpy(enSet->stringData, "block", sizeof(EnsightString));
-            fwrite(enSet->stringData, sizeof(char), sizeof(EnsightString), filePointer);
-            /* now output the scalar value at each node in current part */
-            for (int k = part->ns[p][Z][MIN]; k < part->ns[p][Z][MAX]; ++k) {
-                for (int j = part->ns[p][Y][MIN]; j < part->ns[p][Y][MAX]; ++j) {
-                    for (int i = part->ns[p][X][MIN]; i < part->ns[p][X][MAX]; ++i) {
-                        idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                        U = node[idx].U[TO];
-                        switch (count) {
-                            case 0: /* rho */
-                                data = U[0];
-                                break;
-                            case 1: /* u */
-                                data = U[1] / U[0];
-                                break;
-                            case 2: /* v */
-                                data = U[2] / U[0];
-                                break;
-                            case 3: /* w */
-                                data = U[3] / U[0];
-                                break;
-                            case 4: /* p */
-                                data = ComputePressure(model->gamma, U);
-                                break;
-                            case 5: /* T */
-                                data = ComputeTemperature(model->cv, U);
-                                break;
-                            case 6: /* node flag */
-                                data = node[idx].gid;
-                                break;
-                            default:
-                                break;
-                        }
-                        fwrite(&data, sizeof(EnsightReal), 1, filePointer);
-                    }
-                }
-            }
+        if ((VAROUT - 1) == count) {
+            strncpy(enSet->stringData, "vector variable", sizeof(EnsightString));
+        } else {
+            strncpy(enSet->stringData, "scalar variable", sizeof(EnsightString));
         }
-        fclose(filePointer); /* close current opened file */
-    }
-    snprintf(enSet->fileName, sizeof(EnsightString), "%s.Vel", enSet->baseName);
-    filePointer = fopen(enSet->fileName, "wb");
-    if (NULL == filePointer) {
-        FatalError("failed to open data file...");
-    }
-    /* binary file format */
-    strncpy(enSet->stringData, "vector variable", sizeof(EnsightString));
-    fwrite(enSet->stringData, sizeof(char), sizeof(EnsightString), filePointer);
-    for (int p = PIN, partNum = 1; p < NPARTWRITE; ++p, ++partNum) {
+        fwrite(enSet->stringData, sizeof(char), sizeof(EnsightString), filePointer[count]);
+        /* binary file format */
         strncpy(enSet->stringData, "part", sizeof(EnsightString));
-        fwrite(enSet->stringData, sizeof(char), sizeof(EnsightString), filePointer);
-        fwrite(&partNum, sizeof(int), 1, filePointer);
+        fwrite(enSet->stringData, sizeof(char), sizeof(EnsightString), filePointer[count]);
+        fwrite(&partNum, sizeof(int), 1, filePointer[count]);
         strncpy(enSet->stringData, "block", sizeof(EnsightString));
-        fwrite(enSet->stringData, sizeof(char), sizeof(EnsightString), filePointer);
-        for (int count = 1; count < 4; ++count) {
-            for (int k = part->ns[p][Z][MIN]; k < part->ns[p][Z][MAX]; ++k) {
-                for (int j = part->ns[p][Y][MIN]; j < part->ns[p][Y][MAX]; ++j) {
-                    for (int i = part->ns[p][X][MIN]; i < part->ns[p][X][MAX]; ++i) {
-                        idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                        U = node[idx].U[TO];
-                        data = U[count] / U[0];
-                        fwrite(&data, sizeof(EnsightReal), 1, filePointer);
-                    }
+        fwrite(enSet->stringData, sizeof(char), sizeof(EnsightString), filePointer[count]);
+    }
+    /*
+     * All variables are computed in a single traversal of nodes, a chunk
+     * of planes at a time, and each variable is written per chunk by one
+     * fwrite. Velocity components are placed in their sections of the
+     * vector file by seeking.
+     */
+    IntVec nodeCount = {0}; /* i, j, k node number in each part */
+    nodeCount[X] = (enSet->range[X][MAX] - enSet->range[X][MIN] - 1) / stride[X] + 1; 
+    nodeCount[Y] = (enSet->range[Y][MAX] - enSet->range[Y][MIN] - 1) / stride[Y] + 1; 
+    nodeCount[Z] = (enSet->range[Z][MAX] - enSet->range[Z][MIN] - 1) / stride[Z] + 1; 
+    const long totN = (long)nodeCount[X] * nodeCount[Y] * nodeCount[Z];
+    const int planeN = nodeCount[X] * nodeCount[Y];
+    const int chunkK = MaxInt(1, ENSIGHTCHUNK / planeN) * stride[Z]; /* k range of a chunk */
+    const int chunkN = MinInt(chunkK / stride[Z], nodeCount[Z]) * planeN; /* capacity of a chunk */
+    const long head = 3 * sizeof(EnsightString) + sizeof(int); /* size of file head */
+    EnsightReal *buffer = AssignStorage((VAROUT - 1) * chunkN * sizeof(*buffer));
+    long done = 0; /* number of written nodes */
+    for (int kc = enSet->range[Z][MIN]; kc < enSet->range[Z][MAX]; kc += chunkK) {
+        int m = 0; /* number of buffered nodes */
+        for (int k = kc; k < MinInt(kc + chunkK, enSet->range[Z][MAX]); k += stride[Z]) {
+            for (int j = enSet->range[Y][MIN]; j < enSet->range[Y][MAX]; j += stride[Y]) {
+                for (int i = enSet->range[X][MIN]; i < enSet->range[X][MAX]; i += stride[X], ++m) {
+                    const int idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                    const Real *restrict U = node[idx].U[TO];
+                    EnsightReal *data = buffer + m;
+                    data[0] = U[0]; /* rho */
+                    data[chunkN] = U[1] / U[0]; /* u */
+                    data[2 * chunkN] = U[2] / U[0]; /* v */
+                    data[3 * chunkN] = U[3] / U[0]; /* w */
+                    data[4 * chunkN] = ComputePressure(model->gamma, U); /* p */
+                    data[5 * chunkN] = ComputeTemperature(model->cv, U); /* T */
+                    data[6 * chunkN] = node[idx].gid; /* node flag */
+                    data[7 * chunkN] = node[idx].fid; /* face flag */
+                    data[8 * chunkN] = node[idx].lid; /* layer flag */
+                    data[9 * chunkN] = node[idx].gst; /* ghost flag */
                 }
             }
         }
+        for (int count = 0; count < (VAROUT - 1); ++count) {
+            if (NULL != filePointer[count]) {
+                fwrite(buffer + count * chunkN, sizeof(EnsightReal), m, filePointer[count]);
+            }
+        }
+        if (NULL != filePointer[VAROUT - 1]) {
+            for (int count = 1; count < 4; ++count) {
+                fseek(filePointer[VAROUT - 1], head + ((count - 1) * totN + done) * (long)sizeof(EnsightReal), SEEK_SET);
+                fwrite(buffer + count * chunkN, sizeof(EnsightReal), m, filePointer[VAROUT - 1]);
+            }
+        }
+        done = done + m;
     }
-    fclose(filePointer); /* close current opened file */
+    for (int count = 0; count < VAROUT; ++count) {
+        if (NULL != filePointer[count]) {
+            fclose(filePointer[count]); /* close current opened file */
+        }
+    }
+    RetrieveStorage(buffer);
     return 0;
 }
 /* a good practice: end file with a newline */
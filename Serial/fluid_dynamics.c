@@ -17,8 +17,33 @@
 #include <string.h> /* manipulating strings */
 #include "weno.h"
 #include "boundary_treatment.h"
+#include "perf_counter.h"
+#include "primitive_cache.h"
+#include "residual.h"
+#include "trace.h"
 #include "cfd_commons.h"
 #include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+typedef enum {
+    LINEN = 5, /* a line and its neighbouring lines in transverse directions */
+} LineConstants;
+/*
+ * Line buffer
+ *
+ * Primitives u, v, w, T of the nodes on a sweep line and on its four
+ * neighbouring lines, which are converted once and then shared by all the
+ * interfaces of the line. When the primitive cache holds the time level,
+ * the lines are addressed in the cache instead.
+ */
+typedef struct {
+    int t[2]; /* transverse directions */
+    int stride; /* index distance between neighbouring nodes of a line */
+    int base[LINEN]; /* index of the first node of each line */
+    Real (*V)[DIMCV]; /* primitives of each node */
+    Real (*buffer)[DIMCV]; /* storage of converted primitives */
+} LineBuffer;
 /****************************************************************************
  * Function Pointers
  ****************************************************************************/
@@ -30,9 +55,6 @@ typedef void (*SolutionOperator)(const int, const Real, const Real,
 typedef void (*ConvectiveFluxReconstructor)(const int, const int, const int,
         const int, const int, const int [restrict], const Node *const, 
         const Model *, Real [restrict]);
-typedef void (*DiffusiveFluxReconstructor)(const int, const int, const int, 
-        const int, const int [restrict], const Real [restrict], const Node *const, 
-        const Model *, Real [restrict]);
 /****************************************************************************
  * Static Function Declarations
  ****************************************************************************/
@@ -51,18 +73,11 @@ static void DimensionByDimension(const int, const Real, const Real,
         const Real [restrict], const Real, const Real [restrict]);
 static void NumericalConvectiveFlux(const int, const int, const int, const int,
         const int, const int [restrict], const Node *const, const Model *, Real [restrict]);
-static void NumericalDiffusiveFlux(const int, const int, const int, const int, 
-        const int, const int [restrict], const Real [restrict], const Node *const, 
-        const Model *, Real [restrict]);
-static void NumericalDiffusiveFluxX(const int, const int, const int, const int,
-        const int [restrict], const Real [restrict], const Node *const, 
-        const Model *, Real [restrict]);
-static void NumericalDiffusiveFluxY(const int, const int, const int, const int,
-        const int [restrict], const Real [restrict], const Node *const, 
-        const Model *, Real [restrict]);
-static void NumericalDiffusiveFluxZ(const int, const int, const int, const int,
-        const int [restrict], const Real [restrict], const Node *const, 
-        const Model *, Real [restrict]);
+static void NumericalDiffusiveFlux(const int, const int, const Real [restrict],
+        const Model *, const LineBuffer *, Real [restrict]);
+static void LoadLine(const int, const int, const int, const int, const int [restrict],
+        const int [restrict], const Node *const, const Model *, LineBuffer *);
+static void RecordResidual(const int, const Real [restrict], Real [restrict], Residual *);
 static void SourceVector(const int, const int, const int, const int,
         const int [restrict], const Node *const, const Model *, Real [restrict]);
 /****************************************************************************
@@ -74,13 +89,12 @@ static TemporalDiscretizer DiscretizeTime[2] = {
 static SolutionOperator SolveOperator[2] = {
     DimensionalSplitting,
     DimensionByDimension};
-static ConvectiveFluxReconstructor ReconstructConvectiveFlux[2] = {
+static ConvectiveFluxReconstructor ReconstructConvectiveFlux[4] = {
     WENO3,
-    WENO5};
-static DiffusiveFluxReconstructor ReconstructDiffusiveFlux[DIMS] = {
-    NumericalDiffusiveFluxX,
-    NumericalDiffusiveFluxY,
-    NumericalDiffusiveFluxZ};
+    WENO5,
+    WENO5Z,
+    WENO5M};
+static const char *sweepName[DIMS] = {"sweep x", "sweep y", "sweep z"};
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
@@ -195,6 +209,13 @@ static void RungeKutta3(const Real dt, const int s, Space *space, const Model *m
  * value of s, that is, for each spatial dimension. If a function is too
  * difficult to do a general code, then code functions for each spatial 
  * dimension individually.
+ * The convective and diffusive fluxes of an interface are evaluated in
+ * the same pass, primitives required by diffusive fluxes are converted
+ * once per node per line in a line buffer, or are read from the primitive
+ * cache when it holds the time level.
+ * On a monitored step, the first update of the step saves the field data
+ * and each final update of a stage measures the changes from the saved
+ * data, then the measurement of the last update covers the whole step.
  */
 static void LLL(const Real dt, const Real coeA, const Real coeB, const int to, 
         const int tn, const int tm, const int p, Space *space, const Model *model)
@@ -216,9 +237,35 @@ static void LLL(const Real dt, const Real coeA, const Real coeB, const int to,
     const RealVec r = {dt * dd[X], dt * dd[Y], dt * dd[Z]};
     const Real rPhi = (DIMS == p) ? dt : (1.0 / 3.0) * dt;
     const int sN = (DIMS == p) ? p : p + 1;
+    LineBuffer line = {0};
+    Residual *res = &(space->res);
+    const int save = (RESSAVE == res->stage);
+    const int measure = (RESMEASURE == res->stage) && (to == tm);
+    if (measure) {
+        res->nodeN = 0;
+        for (int dim = 0; dim < DIMU; ++dim) {
+            res->L2[dim] = 0.0;
+            res->Linf[dim] = 0.0;
+        }
+    }
+    const Real zero = 0.0;
+    if (zero < model->refMu) {
+        if (0 < CacheState(tn, &(space->cache))) {
+            line.V = space->cache.V;
+        } else {
+            const int lineN = LINEN * MaxInt(partn[X], MaxInt(partn[Y], partn[Z]));
+            line.buffer = AssignStorage(lineN * sizeof(*line.buffer));
+            line.V = line.buffer;
+        }
+    }
     for (int s = (DIMS == p) ? 0 : p; s < sN; ++s) {
+        TraceBegin(sweepName[s]);
+        StartCounters(PHASESWEEPX + s);
         for (int ks = part->np[s][Z][MIN]; ks < part->np[s][Z][MAX]; ++ks) {
             for (int js = part->np[s][Y][MIN]; js < part->np[s][Y][MAX]; ++js) {
+                if (NULL != line.V) {
+                    LoadLine(tn, s, ks, js, part->np[s][X], partn, node, model, &line);
+                }
                 for (int is = part->np[s][X][MIN], state = 0; is < part->np[s][X][MAX]; ++is) {
                     switch (s) {
                         case X:
@@ -247,17 +294,45 @@ static void LLL(const Real dt, const Real coeA, const Real coeB, const int to,
                         FvhatR = temp;
                     } else {
                         NumericalConvectiveFlux(tn, s, k - h[s][Z], j - h[s][Y], i - h[s][X], partn, node, model, FhatL);
-                        NumericalDiffusiveFlux(tn, s, k - h[s][Z], j - h[s][Y], i - h[s][X], partn, dd, node, model, FvhatL);
+                        NumericalDiffusiveFlux(s, is - 1, dd, model, &line, FvhatL);
                         state = 1;
                     }
                     NumericalConvectiveFlux(tn, s, k, j, i, partn, node, model, FhatR);
-                    NumericalDiffusiveFlux(tn, s, k, j, i, partn, dd, node, model, FvhatR);
+                    NumericalDiffusiveFlux(s, is, dd, model, &line, FvhatR);
                     SourceVector(tn, k, j, i, partn, node, model, Phi);
                     SolveOperator[model->multidim](s, coeA, coeB, node[idx].U[to], node[idx].U[tn], node[idx].U[tm], 
                             r, FhatR, FhatL, FvhatR, FvhatL, rPhi, Phi);
+                    if ((save || measure) && (sN - 1 == s)) {
+                        RecordResidual(save, node[idx].U[save ? to : tm], res->U[idx], res);
+                    }
                 }
             }
         }
+        StopCounters(PHASESWEEPX + s);
+        TraceEnd(sweepName[s]);
+    }
+    RetrieveStorage(line.buffer);
+    if (save) {
+        res->stage = RESMEASURE;
+    }
+    return;
+}
+/*
+ * Save the field data of a node, or accumulate its changes from the saved.
+ */
+static void RecordResidual(const int save, const Real U[restrict], Real Us[restrict], Residual *res)
+{
+    if (save) {
+        for (int dim = 0; dim < DIMU; ++dim) {
+            Us[dim] = U[dim];
+        }
+        return;
+    }
+    ++(res->nodeN);
+    for (int dim = 0; dim < DIMU; ++dim) {
+        const Real d = U[dim] - Us[dim];
+        res->L2[dim] = res->L2[dim] + d * d;
+        res->Linf[dim] = MaxReal(res->Linf[dim], fabs(d));
     }
     return;
 }
@@ -300,19 +375,112 @@ static void NumericalConvectiveFlux(const int tn, const int s, const int k, cons
     ReconstructConvectiveFlux[model->sScheme](tn, s, k, j, i, partn, node, model, Fhat);
     return;
 }
-static void NumericalDiffusiveFlux(const int tn, const int s, const int k, const int j, const int i,
-        const int partn[restrict], const Real dd[restrict], const Node *const node, 
-        const Model *model, Real Fvhat[restrict])
+/*
+ * Diffusive flux at the interface between node m and node m + 1 of the
+ * loaded line, the same discretization as NumericalDiffusiveFluxX/Y/Z
+ * written for a general direction s with transverse directions t.
+ */
+static void NumericalDiffusiveFlux(const int s, const int m, const Real dd[restrict],
+        const Model *model, const LineBuffer *line, Real Fvhat[restrict])
 {
     const Real zero = 0.0;
     if (zero >= model->refMu) {
         memset(Fvhat, 0, DIMU * sizeof(*Fvhat));
         return;
     }
-    ReconstructDiffusiveFlux[s](tn, k, j, i, partn, dd, node, model, Fvhat);
+    Real (*restrict V)[DIMCV] = line->V;
+    const int *restrict base = line->base;
+    const int st = line->stride;
+    const Real *restrict Vc = V[base[0]+m*st];
+    const Real *restrict VcE = V[base[0]+(m+1)*st];
+    Real grad[DIMS][DIMS] = {{zero}}; /* velocity gradient, grad[a][b] = du_a/dx_b */
+    for (int a = 0; a < DIMS; ++a) {
+        grad[a][s] = (VcE[a] - Vc[a]) * dd[s];
+    }
+    for (int l = 0; l < 2; ++l) {
+        const int t = line->t[l];
+        const Real *restrict VS = V[base[2*l+1]+m*st];
+        const Real *restrict VSE = V[base[2*l+1]+(m+1)*st];
+        const Real *restrict VN = V[base[2*l+2]+m*st];
+        const Real *restrict VNE = V[base[2*l+2]+(m+1)*st];
+        grad[t][t] = 0.25 * (VN[t] + VNE[t] - VS[t] - VSE[t]) * dd[t];
+        grad[s][t] = 0.25 * (VN[s] + VNE[s] - VS[s] - VSE[s]) * dd[t];
+    }
+    const Real dT = (VcE[3] - Vc[3]) * dd[s];
+
+    /* Calculate interfacial values */
+    const Real uhat = 0.5 * (Vc[0] + VcE[0]);
+    const Real vhat = 0.5 * (Vc[1] + VcE[1]);
+    const Real what = 0.5 * (Vc[2] + VcE[2]);
+    const Real That = 0.5 * (Vc[3] + VcE[3]);
+    const Real mu = model->refMu * Viscosity(That * model->refT);
+    const Real heatK = model->gamma * model->cv * mu / PrandtlNumber();
+    const Real divV = grad[X][X] + grad[Y][Y] + grad[Z][Z];
+
+    Fvhat[0] = 0.0;
+    for (int a = 0; a < DIMS; ++a) {
+        Fvhat[a+1] = mu * (grad[s][a] + grad[a][s]);
+    }
+    Fvhat[s+1] = mu * (grad[s][s] + grad[s][s] - (2.0/3.0) * divV);
+    Fvhat[4] = heatK * dT + Fvhat[1] * uhat + Fvhat[2] * vhat + Fvhat[3] * what;
+    return;
+}
+/*
+ * Load the line in direction s at (ks, js) in the sweep order of LLL.
+ * Lines are ordered as the sweep line and its neighbours at -1 and +1 of
+ * the first and second transverse direction. Nodes in the sweep range
+ * and one node beyond each end are converted, which are the nodes used
+ * by the interfaces of the sweep. Without buffer storage, the lines are
+ * only located in the primitive cache.
+ */
+static void LoadLine(const int tn, const int s, const int ks, const int js, const int range[restrict],
+        const int partn[restrict], const Node *const node, const Model *model, LineBuffer *line)
+{
+    const int t[DIMS][2] = {{Y, Z}, {X, Z}, {X, Y}}; /* transverse directions */
+    const int stride[DIMS] = {1, partn[X], partn[X] * partn[Y]};
+    int i = 0, j = 0, k = 0; /* index with normal order */
+    switch (s) {
+        case X:
+            j = js; k = ks;
+            break;
+        case Y:
+            i = js; k = ks;
+            break;
+        case Z:
+            i = js; j = ks;
+            break;
+        default:
+            break;
+    }
+    const int idx = IndexNode(k, j, i, partn[Y], partn[X]);
+    const int base[LINEN] = {idx, idx - stride[t[s][0]], idx + stride[t[s][0]],
+        idx - stride[t[s][1]], idx + stride[t[s][1]]};
+    const int n = partn[s];
+    const Real *restrict U = NULL;
+    line->t[0] = t[s][0];
+    line->t[1] = t[s][1];
+    if (NULL == line->buffer) { /* lines in the primitive cache */
+        line->stride = stride[s];
+        for (int l = 0; l < LINEN; ++l) {
+            line->base[l] = base[l];
+        }
+        return;
+    }
+    line->stride = 1;
+    for (int l = 0; l < LINEN; ++l) {
+        line->base[l] = l * n;
+        Real (*restrict V)[DIMCV] = line->V + l * n;
+        for (int m = range[MIN] - 1; m <= range[MAX]; ++m) {
+            U = node[base[l] + m * stride[s]].U[tn];
+            V[m][0] = U[1] / U[0];
+            V[m][1] = U[2] / U[0];
+            V[m][2] = U[3] / U[0];
+            V[m][3] = ComputeTemperature(model->cv, U);
+        }
+    }
     return;
 }
-static void NumericalDiffusiveFluxX(const int tn, const int k, const int j, const int i,
+void NumericalDiffusiveFluxX(const int tn, const int k, const int j, const int i,
         const int partn[restrict], const Real dd[restrict], const Node *const node, 
         const Model *model, Real Fvhat[restrict])
 {
@@ -397,7 +565,7 @@ static void NumericalDiffusiveFluxX(const int tn, const int k, const int j, cons
     Fvhat[4] = heatK * dT_dx + Fvhat[1] * uhat + Fvhat[2] * vhat + Fvhat[3] * what;
     return;
 }
-static void NumericalDiffusiveFluxY(const int tn, const int k, const int j, const int i,
+void NumericalDiffusiveFluxY(const int tn, const int k, const int j, const int i,
         const int partn[restrict], const Real dd[restrict], const Node *const node, 
         const Model *model, Real Fvhat[restrict])
 {
@@ -482,7 +650,7 @@ static void NumericalDiffusiveFluxY(const int tn, const int k, const int j, cons
     Fvhat[4] = heatK * dT_dy + Fvhat[1] * uhat + Fvhat[2] * vhat + Fvhat[3] * what;
     return ;
 }
-static void NumericalDiffusiveFluxZ(const int tn, const int k, const int j, const int i,
+void NumericalDiffusiveFluxZ(const int tn, const int k, const int j, const int i,
         const int partn[restrict], const Real dd[restrict], const Node *const node, 
         const Model *model, Real Fvhat[restrict])
 {
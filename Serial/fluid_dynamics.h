@@ -30,6 +30,24 @@
  *      Evolve fluid dynamics.
  */
 extern void FluidDynamics(const Real dt, Space *, const Model *);
+/*
+ * Numerical diffusive fluxes
+ *
+ * Function
+ *      Compute the viscous and heat fluxes at the interface between node i
+ *      and its positive neighbour in the X, Y, or Z direction. These are
+ *      per interface references, the solver evaluates the same fluxes from
+ *      primitives that are converted once per line.
+ */
+extern void NumericalDiffusiveFluxX(const int tn, const int k, const int j, const int i,
+        const int partn[restrict], const Real dd[restrict], const Node *const, 
+        const Model *, Real Fvhat[restrict]);
+extern void NumericalDiffusiveFluxY(const int tn, const int k, const int j, const int i,
+        const int partn[restrict], const Real dd[restrict], const Node *const, 
+        const Model *, Real Fvhat[restrict]);
+extern void NumericalDiffusiveFluxZ(const int tn, const int k, const int j, const int i,
+        const int partn[restrict], const Real dd[restrict], const Node *const, 
+        const Model *, Real Fvhat[restrict]);
 #endif
 /* a good practice: end file with a newline */
 
@@ -18,6 +18,9 @@
 #include <float.h> /* size of floating point values */
 #include <string.h> /* manipulating strings */
 #include "computational_geometry.h"
+#include "particle_bin.h"
+#include "primitive_cache.h"
+#include "trace.h"
 #include "cfd_commons.h"
 #include "commons.h"
 /****************************************************************************
@@ -31,18 +34,19 @@ typedef enum {
  ****************************************************************************/
 static void InitializeGeometryDomain(Space *);
 static void IdentifyGeometryNode(Space *);
-static void IdentifyInterfacialNode(Space *, const Model *);
+static int IdentifyInterfacialNode(Space *, const Model *);
+static void GrowNodeList(const int, Geometry *);
+static void BuildNodeList(const int, Space *);
 static int InterfacialState(const int, const int, const int, const int, const int,
         const int [restrict][DIMS], const Node *const, const Partition *);
 static int GhostState(const int, const int, const int, const int, const int,
         const int [restrict][DIMS], const Node *const, const Partition *);
+static void TreatGeometry(const int, const int, Space *, const Model *);
 static void ApplyWeighting(const Real [restrict], const Real, Real, 
         Real [restrict], Real [restrict]);
-static Real InverseDistanceWeighting(const int, const int [restrict], const Real [restrict],
-        const int, const int, const int, const Partition *, const Node *const, const Model *, Real [restrict]);
 static void FlowReconstruction(const int, const int [restrict], const Real [restrict], const int,
-        const int, const int, const Polyhedron *, const Partition *, const Node *const, const Model *,
-        const Real [restrict], const Real [restrict], Real [restrict], Real [restrict]);
+        const int, const int, const Polyhedron *, const Partition *, const Node *const, const Cache *,
+        const Model *, const Real [restrict], const Real [restrict], Real [restrict], Real [restrict]);
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
@@ -55,11 +59,30 @@ static void FlowReconstruction(const int, const int [restrict], const Real [rest
  */
 void ComputeGeometryDomain(Space *space, const Model *model)
 {
+    space->cache.tn = NONE; /* node types and newly joined nodes are changed */
     InitializeGeometryDomain(space);
+    BinParticle(&(space->part), &(space->geo));
     IdentifyGeometryNode(space);
-    IdentifyInterfacialNode(space, model);
+    const int scanN = IdentifyInterfacialNode(space, model);
+    BuildNodeList(scanN, space);
     return;
 }
+void ReleaseGeometryDomain(Space *space)
+{
+    Geometry *geo = &(space->geo);
+    RetrieveStorage(geo->listSep);
+    RetrieveStorage(geo->list);
+    RetrieveStorage(geo->scan);
+    geo->listSep = NULL;
+    geo->list = NULL;
+    geo->scan = NULL;
+    geo->listMax = 0;
+    return;
+}
+const int *NodeListSeparator(const int n, const int type, const Geometry *geo)
+{
+    return geo->listSep + n * NLIST + type * NLAYER;
+}
 static void InitializeGeometryDomain(Space *space)
 {
     const Partition *restrict part = &(space->part);
@@ -110,6 +133,8 @@ static void IdentifyGeometryNode(Space *space)
     int fid = 0;
     int idx = 0; /* linear array index math variable */
     int box[DIMS][LIMIT] = {{0}}; /* bounding box in node space */
+    int span[LIMIT][LIMIT] = {{0}}; /* node ranges of a row */
+    int spanN = 0;
     RealVec p = {0.0}; /* node point */
     for (int n = 0; n < geo->totN; ++n) {
         poly = geo->poly + n;
@@ -124,23 +149,26 @@ static void IdentifyGeometryNode(Space *space)
         /* find nodes in geometry, then flag and link to geometry. */
         for (int k = box[Z][MIN]; k < box[Z][MAX]; ++k) {
             for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
-                for (int i = box[X][MIN]; i < box[X][MAX]; ++i) {
-                    idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                    if (0 != node[idx].gid) { /* already classified */
-                        continue;
-                    }
-                    p[X] = PointSpace(i, sMin[X], d[X], ng);
-                    p[Y] = PointSpace(j, sMin[Y], d[Y], ng);
-                    p[Z] = PointSpace(k, sMin[Z], d[Z], ng);
-                    if (0 == poly->faceN) { /* analytical sphere */
-                        if (poly->r * poly->r >= Dist2(poly->O, p)) {
-                            node[idx].gid = n + 1;
-                            node[idx].fid = 0;
+                spanN = NodeRowSpan(k, j, 0, n, geo, box, part, span);
+                for (int m = 0; m < spanN; ++m) {
+                    for (int i = span[m][MIN]; i < span[m][MAX]; ++i) {
+                        idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                        if (0 != node[idx].gid) { /* already classified */
+                            continue;
                         }
-                    } else { /* triangulated polyhedron */
-                        if (PointInPolyhedron(p, poly, &fid)) {
-                            node[idx].gid = n + 1;
-                            node[idx].fid = fid;
+                        p[X] = PointSpace(i, sMin[X], d[X], ng);
+                        p[Y] = PointSpace(j, sMin[Y], d[Y], ng);
+                        p[Z] = PointSpace(k, sMin[Z], d[Z], ng);
+                        if (0 == poly->faceN) { /* analytical sphere */
+                            if (poly->r * poly->r >= Dist2(poly->O, p)) {
+                                node[idx].gid = n + 1;
+                                node[idx].fid = 0;
+                            }
+                        } else { /* triangulated polyhedron */
+                            if (PointInPolyhedron(p, poly, &fid)) {
+                                node[idx].gid = n + 1;
+                                node[idx].fid = fid;
+                            }
                         }
                     }
                 }
@@ -149,11 +177,17 @@ static void IdentifyGeometryNode(Space *space)
     }
     return;
 }
-static void IdentifyInterfacialNode(Space *space, const Model *model)
+/*
+ * Interfacial nodes of all geometries are collected in scan order, and the
+ * number of collected nodes is returned for building node lists.
+ */
+static int IdentifyInterfacialNode(Space *space, const Model *model)
 {
     const Partition *restrict part = &(space->part);
     Node *const node = space->node;
+    Geometry *geo = &(space->geo);
     int idx = 0; /* linear array index math variable */
+    int scanN = 0; /* count collected interfacial nodes */
     IntVec n = {0};
     RealVec p = {0.0};
     Real Uo[DIMUo] = {0.0};
@@ -170,7 +204,7 @@ static void IdentifyInterfacialNode(Space *space, const Model *model)
                     p[X] = PointSpace(i, part->domain[X][MIN], part->d[X], part->ng);
                     p[Y] = PointSpace(j, part->domain[Y][MIN], part->d[Y], part->ng);
                     p[Z] = PointSpace(k, part->domain[Z][MIN], part->d[Z], part->ng);
-                    weightSum = InverseDistanceWeighting(TO, n, p, R, NONE, 0, part, node, model, Uo);
+                    weightSum = InverseDistanceWeighting(TO, n, p, R, NONE, 0, part, node, &(space->cache), model, Uo);
                     Normalize(DIMUo, weightSum, Uo);
                     Uo[0] = Uo[4] / (Uo[5] * model->gasR); /* compute density */
                     ConservativeByPrimitive(model->gamma, Uo, node[idx].U[TO]);
@@ -191,9 +225,83 @@ static void IdentifyInterfacialNode(Space *space, const Model *model)
                     /* search neighbours to determine ghost state */
                     node[idx].gst = GhostState(k, j, i, 0, part->pathSep[0], part->path, node, part);
                 }
+                if (0 != node[idx].lid) {
+                    if (geo->listMax == scanN) {
+                        GrowNodeList(scanN, geo);
+                    }
+                    geo->scan[scanN][X] = i;
+                    geo->scan[scanN][Y] = j;
+                    geo->scan[scanN][Z] = k;
+                    ++scanN;
+                }
             }
         }
     }
+    return scanN;
+}
+/*
+ * Node list storage grows geometrically and is kept across calls. The list
+ * storage holds at most two entries of each collected node.
+ */
+static void GrowNodeList(const int scanN, Geometry *geo)
+{
+    const int listMax = (0 == geo->listMax) ? 1024 : 2 * geo->listMax;
+    int (*scan)[DIMS] = AssignStorage(listMax * sizeof(*scan));
+    if (0 < scanN) {
+        memcpy(scan, geo->scan, scanN * sizeof(*scan));
+    }
+    RetrieveStorage(geo->scan);
+    RetrieveStorage(geo->list);
+    geo->scan = scan;
+    geo->list = AssignStorage(2 * listMax * sizeof(*geo->list));
+    geo->listMax = listMax;
+    return;
+}
+/*
+ * Collected nodes are counted into the separators and distributed with the
+ * separators as cursors, hence each list keeps the scan order.
+ */
+static void BuildNodeList(const int scanN, Space *space)
+{
+    const Partition *restrict part = &(space->part);
+    const Node *const node = space->node;
+    Geometry *geo = &(space->geo);
+    if (0 == geo->totN) {
+        return;
+    }
+    const int sepN = geo->totN * NLIST;
+    if (NULL == geo->listSep) {
+        geo->listSep = AssignStorage((sepN + 1) * sizeof(*geo->listSep));
+    }
+    int *restrict sep = geo->listSep;
+    int idx = 0; /* linear array index math variable */
+    int l = 0; /* list locator */
+    memset(sep, 0, (sepN + 1) * sizeof(*sep));
+    for (int m = 0; m < scanN; ++m) {
+        idx = IndexNode(geo->scan[m][Z], geo->scan[m][Y], geo->scan[m][X], part->n[Y], part->n[X]);
+        l = (node[idx].gid - 1) * NLIST;
+        ++sep[l + LISTLID * NLAYER + node[idx].lid + 1];
+        if (0 != node[idx].gst) {
+            ++sep[l + LISTGST * NLAYER + node[idx].gst + 1];
+        }
+    }
+    for (l = 0; l < sepN; ++l) {
+        sep[l + 1] = sep[l + 1] + sep[l];
+    }
+    for (int m = 0; m < scanN; ++m) {
+        idx = IndexNode(geo->scan[m][Z], geo->scan[m][Y], geo->scan[m][X], part->n[Y], part->n[X]);
+        l = (node[idx].gid - 1) * NLIST;
+        memcpy(geo->list[sep[l + LISTLID * NLAYER + node[idx].lid]], geo->scan[m], sizeof(*geo->list));
+        ++sep[l + LISTLID * NLAYER + node[idx].lid];
+        if (0 != node[idx].gst) {
+            memcpy(geo->list[sep[l + LISTGST * NLAYER + node[idx].gst]], geo->scan[m], sizeof(*geo->list));
+            ++sep[l + LISTGST * NLAYER + node[idx].gst];
+        }
+    }
+    for (l = sepN; l > 0; --l) { /* cursors end at the next separators */
+        sep[l] = sep[l - 1];
+    }
+    sep[0] = 0;
     return;
 }
 static int InterfacialState(const int k, const int j, const int i, const int gid, const int end,
@@ -248,20 +356,48 @@ static int GhostState(const int k, const int j, const int i, const int gid, cons
  * geometry. arXiv preprint arXiv:1602.06830.
  */
 void ImmersedBoundaryTreatment(const int tn, Space *space, const Model *model)
+{
+    /*
+     * Treatment of a geometry only writes its own ghost nodes and only reads
+     * fluid nodes and its own ghost nodes of lower layers. Since node-geometry
+     * links are fixed here, geometries are independent of each other and are
+     * scheduled dynamically to balance geometries of different sizes. The
+     * layer order within each geometry is preserved.
+     * Fluid nodes are cached before the treatment for reconstruction,
+     * ghost nodes are cached after it.
+     */
+    CachePrimitive(tn, CACHEFLUID, space, model);
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        TraceBegin("immersed boundary");
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 1) nowait
+#endif
+        for (int n = 0; n < space->geo.totN; ++n) {
+            TreatGeometry(tn, n, space, model);
+        }
+        TraceEnd("immersed boundary");
+    }
+    CachePrimitive(tn, CACHESOLID, space, model);
+    return;
+}
+static void TreatGeometry(const int tn, const int n, Space *space, const Model *model)
 {
     const Partition *restrict part = &(space->part);
-    Geometry *geo = &(space->geo);
-    Polyhedron *poly = NULL;
+    const Geometry *geo = &(space->geo);
+    const Polyhedron *poly = geo->poly + n;
     Node *const node = space->node;
+    const Cache *cache = &(space->cache);
+    const int *sep = NodeListSeparator(n, LISTGST, geo);
     int idx = 0; /* linear array index math variable */
-    const IntVec nMin = {part->ns[PIN][X][MIN], part->ns[PIN][Y][MIN], part->ns[PIN][Z][MIN]};
-    const IntVec nMax = {part->ns[PIN][X][MAX], part->ns[PIN][Y][MAX], part->ns[PIN][Z][MAX]};
     const RealVec sMin = {part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN]};
     const RealVec d = {part->d[X], part->d[Y], part->d[Z]};
     const RealVec dd = {part->dd[X], part->dd[Y], part->dd[Z]};
     const int ng = part->ng;
     IntVec nI = {0}; /* image node */
-    IntVec nG = {0}; /* ghost node */
+    const int *nG = NULL; /* ghost node */
     RealVec pG = {0.0}; /* ghost point */
     RealVec pO = {0.0}; /* boundary point */
     RealVec pI = {0.0}; /* image point */
@@ -270,44 +406,26 @@ void ImmersedBoundaryTreatment(const int tn, Space *space, const Model *model)
     Real UoO[DIMUo] = {0.0};
     Real UoI[DIMUo] = {0.0};
     Real weightSum = 0.0;
-    int box[DIMS][LIMIT] = {{0}}; /* bounding box in node space */
-    for (int n = 0; n < geo->totN; ++n) {
-        poly = geo->poly + n;
-        /* determine search range according to bounding box of polyhedron and valid node space */
-        for (int s = 0; s < DIMS; ++s) {
-            box[s][MIN] = ValidNodeSpace(NodeSpace(poly->box[s][MIN], sMin[s], dd[s], ng), nMin[s], nMax[s]);
-            box[s][MAX] = ValidNodeSpace(NodeSpace(poly->box[s][MAX], sMin[s], dd[s], ng), nMin[s], nMax[s]) + 1;
-        }
-        for (int r = 1; r <= part->gl; ++r) { /* layer by layer treatment */
-            for (int k = box[Z][MIN]; k < box[Z][MAX]; ++k) {
-                for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
-                    for (int i = box[X][MIN]; i < box[X][MAX]; ++i) {
-                        idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                        if ((r != node[idx].gst) || (n + 1 != node[idx].gid)) {
-                            continue;
-                        }
-                        pG[X] = PointSpace(i, sMin[X], d[X], ng);
-                        pG[Y] = PointSpace(j, sMin[Y], d[Y], ng);
-                        pG[Z] = PointSpace(k, sMin[Z], d[Z], ng);
-                        if (model->ibmLayer >= r) { /* immersed boundary treatment */
-                            ComputeGeometricData(node[idx].fid, poly, pG, pO, pI, N);
-                            nI[X] = NodeSpace(pI[X], sMin[X], dd[X], ng);
-                            nI[Y] = NodeSpace(pI[Y], sMin[Y], dd[Y], ng);
-                            nI[Z] = NodeSpace(pI[Z], sMin[Z], dd[Z], ng);
-                            FlowReconstruction(tn, nI, pI, R, NONE, 0, poly, part, node, model, pO, N, UoO, UoI);
-                            MethodOfImage(UoI, UoO, UoG);
-                        } else { /* inverse distance weighting */
-                            nG[X] = i;
-                            nG[Y] = j;
-                            nG[Z] = k;
-                            weightSum = InverseDistanceWeighting(tn, nG, pG, 1, r - 1, n + 1, part, node, model, UoG);
-                            Normalize(DIMUo, weightSum, UoG);
-                        }
-                        UoG[0] = UoG[4] / (UoG[5] * model->gasR); /* compute density */
-                        ConservativeByPrimitive(model->gamma, UoG, node[idx].U[tn]);
-                    }
-                }
+    for (int r = 1; r <= part->gl; ++r) { /* layer by layer treatment */
+        for (int m = sep[r]; m < sep[r + 1]; ++m) {
+            nG = geo->list[m];
+            idx = IndexNode(nG[Z], nG[Y], nG[X], part->n[Y], part->n[X]);
+            pG[X] = PointSpace(nG[X], sMin[X], d[X], ng);
+            pG[Y] = PointSpace(nG[Y], sMin[Y], d[Y], ng);
+            pG[Z] = PointSpace(nG[Z], sMin[Z], d[Z], ng);
+            if (model->ibmLayer >= r) { /* immersed boundary treatment */
+                ComputeGeometricData(node[idx].fid, poly, pG, pO, pI, N);
+                nI[X] = NodeSpace(pI[X], sMin[X], dd[X], ng);
+                nI[Y] = NodeSpace(pI[Y], sMin[Y], dd[Y], ng);
+                nI[Z] = NodeSpace(pI[Z], sMin[Z], dd[Z], ng);
+                FlowReconstruction(tn, nI, pI, R, NONE, 0, poly, part, node, cache, model, pO, N, UoO, UoI);
+                MethodOfImage(UoI, UoO, UoG);
+            } else { /* inverse distance weighting */
+                weightSum = InverseDistanceWeighting(tn, nG, pG, 1, r - 1, n + 1, part, node, cache, model, UoG);
+                Normalize(DIMUo, weightSum, UoG);
             }
+            UoG[0] = UoG[4] / (UoG[5] * model->gasR); /* compute density */
+            ConservativeByPrimitive(model->gamma, UoG, node[idx].U[tn]);
         }
     }
     return;
@@ -345,12 +463,13 @@ void ComputeGeometricData(const int fid, const Polyhedron *poly, const Real pG[r
 }
 static void FlowReconstruction(const int tn, const int n[restrict], const Real p[restrict], const int h,
         const int type, const int gid, const Polyhedron *poly, const Partition *part, const Node *const node, 
-        const Model *model, const Real pO[restrict], const Real N[restrict], Real UoO[restrict], Real UoI[restrict])
+        const Cache *cache, const Model *model, const Real pO[restrict], const Real N[restrict],
+        Real UoO[restrict], Real UoI[restrict])
 {
     const Real zero = 0.0;
     const Real one = 1.0;
     /* pre-estimate step */
-    Real weightSum = InverseDistanceWeighting(tn, n, p, h, type, gid, part, node, model, UoI);
+    Real weightSum = InverseDistanceWeighting(tn, n, p, h, type, gid, part, node, cache, model, UoI);
     const Real weight = one / weightSum;
     /* physical boundary condition enforcement step */
     RealVec Vs = {zero}; /* general motion of boundary point */
@@ -389,9 +508,9 @@ static void FlowReconstruction(const int tn, const int n[restrict], const Real p
     Normalize(DIMUo, weightSum, UoI);
     return;
 }
-static Real InverseDistanceWeighting(const int tn, const int n[restrict], const Real p[restrict], 
+Real InverseDistanceWeighting(const int tn, const int n[restrict], const Real p[restrict], 
         const int h, const int type, const int gid, const Partition *part, 
-        const Node *const node, const Model *model, Real Uo[restrict])
+        const Node *const node, const Cache *cache, const Model *model, Real Uo[restrict])
 {
     int idx = 0; /* linear array index math variable */
     const int idxMax = part->n[X] * part->n[Y] * part->n[Z];
@@ -426,7 +545,11 @@ static Real InverseDistanceWeighting(const int tn, const int n[restrict], const
                     ph[X] = PointSpace(n[X] + ih, sMin[X], d[X], ng);
                     ph[Y] = PointSpace(n[Y] + jh, sMin[Y], d[Y], ng);
                     ph[Z] = PointSpace(n[Z] + kh, sMin[Z], d[Z], ng);
-                    PrimitiveByConservative(model->gamma, model->gasR, node[idx].U[tn], Uoh);
+                    if (0 == gid) { /* fluid nodes are cached before treatments */
+                        NodePrimitive(tn, idx, node, cache, model, Uoh);
+                    } else {
+                        PrimitiveByConservative(model->gamma, model->gasR, node[idx].U[tn], Uoh);
+                    }
                     /* use distance square to avoid expensive sqrt */
                     ApplyWeighting(Uoh, part->tinyL, Dist2(p, ph), &weightSum, Uo);
                 }
@@ -28,9 +28,21 @@
  *
  * Function
  *      Employ node flagging algorithm to handle complex geometry that locates in
- *      the computational domain.
+ *      the computational domain, and collect the ghost nodes and interfacial
+ *      nodes of each geometry by layer into node lists.
  */
 extern void ComputeGeometryDomain(Space *, const Model *);
+extern void ReleaseGeometryDomain(Space *);
+/*
+ * Geometry node list
+ *
+ * Function
+ *      Get the node list separators of the specified list type of geometry n.
+ *      Nodes of layer r are geo->list[sep[r]] to geo->list[sep[r + 1] - 1]
+ *      in the order of node index. Lists are rebuilt by each computation of
+ *      the geometry domain.
+ */
+extern const int *NodeListSeparator(const int n, const int type, const Geometry *);
 /*
  * Compute geometric data
  */
@@ -43,6 +55,19 @@ extern void ComputeGeometricData(const int fid, const Polyhedron *, const Real p
  *      Apply boundary conditions and treatments for immersed boundaries.
  */
 extern void ImmersedBoundaryTreatment(const int tn, Space *, const Model *);
+/*
+ * Inverse distance weighting
+ *
+ * Function
+ *      Interpolate primitive variables at point p from the nodes around node n
+ *      that have the specified geometry identifier and node type. The search
+ *      range starts at h and grows until a valid node is found. The returned
+ *      value is the sum of weights and Uo is not normalized. Primitives of
+ *      fluid nodes are taken from the cache when it holds time level tn.
+ */
+extern Real InverseDistanceWeighting(const int tn, const int n[restrict], const Real p[restrict],
+        const int h, const int type, const int gid, const Partition *, const Node *const, 
+        const Cache *, const Model *, Real Uo[restrict]);
 extern void MethodOfImage(const Real UoI[restrict], const Real UoO[restrict], Real UoG[restrict]);
 #endif
 /* a good practice: end file with a newline */
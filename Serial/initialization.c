@@ -19,6 +19,8 @@
 #include "boundary_treatment.h"
 #include "data_stream.h"
 #include "data_probe.h"
+#include "statistics.h"
+#include "residual.h"
 #include "paraview.h"
 #include "stl.h"
 #include "cfd_commons.h"
@@ -29,22 +31,29 @@
 static int GlobalInitialization(Space *);
 static int InitializeFieldData(Space *, const Model *);
 static int ApplyRegionalInitializer(const int, Space *, const Model *);
-static int InitializeGeometryData(Geometry *);
 static int WritePolyhedronMassProperty(const Geometry *);
 static int IdentifyGeometryState(Geometry *);
+static int ResetPolyhedronTransform(Geometry *);
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
 int InitializeComputationalDomain(Time *time, Space *space, const Model *model)
 {
     GlobalInitialization(space);
+    InitializeProbes(time, space);
     if (0 == time->restart) { /* non restart */
         InitializeFieldData(space, model);
-        InitializeGeometryData(&(space->geo));
+        if (0 == space->geo.loaded) { /* geometries are not loaded by a parameter sweep */
+            InitializeGeometryData(&(space->geo));
+        }
+        ResetPolyhedronTransform(&(space->geo));
     } else {
         ReadFieldData(time, space, model);
+        ResetPolyhedronTransform(&(space->geo));
         ReadGeometryData(time, &(space->geo));
     }
+    InitializeStatistics(time, space);
+    InitializeResidualMonitor(time, space);
     ComputeGeometryParameters(space->part.collapse, &(space->geo));
     WritePolyhedronMassProperty(&(space->geo));
     ComputeGeometryDomain(space, model);
@@ -52,7 +61,12 @@ int InitializeComputationalDomain(Time *time, Space *space, const Model *model)
     IdentifyGeometryState(&(space->geo));
     if (0 == time->restart) { /* non restart */
         WriteSurfaceForceData(time, space);
+        for (int n = 0; n < time->outputN; ++n) {
+            WriteFieldDataOfRegion(n, time, space, model);
+            ++(time->output[n].writeC); /* export count increase */
+        }
         WriteFieldData(time, space, model);
+        WriteStatisticsCheckpoint(time, space);
         WriteGeometryData(time, &(space->geo));
         WriteFieldDataAtPointProbes(time, space, model);
     }
@@ -207,7 +221,7 @@ static int ApplyRegionalInitializer(const int n, Space *space, const Model *mode
     }
     return 0;
 }
-static int InitializeGeometryData(Geometry *geo)
+int InitializeGeometryData(Geometry *geo)
 {
     FILE *filePointer = fopen("artracfd.geo", "r");
     if (NULL == filePointer) {
@@ -233,7 +247,7 @@ static int InitializeGeometryData(Geometry *geo)
                 nscan = sscanf(currentLine, "%s", fileName);
                 VerifyReadConversion(nscan, 1);
                 ReadStlFile(fileName, geo->poly + n);
-                ConvertPolyhedron(geo->poly + n);
+                ConvertPolyhedron(&(geo->arena), geo->poly + n);
             }
             continue;
         }
@@ -321,5 +335,20 @@ static int IdentifyGeometryState(Geometry *geo)
     }
     return 0;
 }
+/*
+ * Polyhedra at initialization are the topology of geometry output, and
+ * their transforms are accumulated from identity thereafter.
+ */
+static int ResetPolyhedronTransform(Geometry *geo)
+{
+    for (int n = 0; n < geo->totN; ++n) {
+        for (int r = 0; r < DIMS; ++r) {
+            for (int c = 0; c <= DIMS; ++c) {
+                geo->poly[n].tf[r][c] = (r == c) ? 1.0 : 0.0;
+            }
+        }
+    }
+    return 0;
+}
 /* a good practice: end file with a newline */
 
@@ -30,6 +30,15 @@
  *      Initialize the computational domain.
  */
 extern int InitializeComputationalDomain(Time *, Space *, const Model *model);
+/*
+ * Geometry initializer
+ *
+ * Function
+ *      Read geometry states and triangulated polyhedrons of a non restart
+ *      case according to artracfd.geo. Storage of geometries should be
+ *      assigned according to the geometry counts.
+ */
+extern int InitializeGeometryData(Geometry *);
 #endif
 /* a good practice: end file with a newline */
 
@@ -0,0 +1,624 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include "mesh_refinement.h"
+#include <stdio.h> /* standard library for input and output */
+#include <stdlib.h> /* support for abs operation */
+#include <string.h> /* manipulating strings */
+#include <math.h> /* common mathematical functions */
+#include <limits.h> /* sizes of integral types */
+#include "fluid_dynamics.h"
+#include "boundary_treatment.h"
+#include "immersed_boundary.h"
+#include "domain_partition.h"
+#include "cfd_commons.h"
+#include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+typedef enum {
+    NPATCH = 64, /* maximum number of patches */
+    RATIO = 2, /* refinement ratio */
+    CELLMIN = 4, /* minimum number of base cells of a patch */
+} RefinementConstants;
+/****************************************************************************
+ * Static Function Declarations
+ ****************************************************************************/
+static void Regrid(Hierarchy *, Space *, const Model *);
+static void CollapsedDimension(const int, int [restrict]);
+static void FlagRefinement(char *, const Space *, const Model *);
+static void BufferFlag(char *, const Partition *);
+static int ClusterFlag(int [restrict][LIMIT], const int, const char *,
+        const Partition *, int, int [restrict][DIMS][LIMIT]);
+static void CreatePatch(int [restrict][LIMIT], const Space *, Patch *);
+static void UpdatePatchGeometry(const int, Patch *, const Space *, const Model *);
+static void Prolongation(const Real [restrict], const int, const Space *, Real [restrict]);
+static void ProlongatePatch(Patch *, const Space *);
+static void StoreInterfaceData(Patch *, const Space *);
+static void InterpolateInterfaceData(const Real, Patch *, const Space *);
+static void Restriction(const Patch *, Space *);
+static void ReleasePatch(Patch *);
+/****************************************************************************
+ * Function definitions
+ ****************************************************************************/
+/*
+ * Berger, M. J., & Colella, P. (1989). Local adaptive mesh refinement for
+ * shock hydrodynamics. Journal of Computational Physics, 82(1), 64-84.
+ *
+ * A single refined level is employed. The base grid is advanced first, then
+ * each patch is advanced with RATIO substeps, with its interface data
+ * interpolated in space and time from the base grid. Finally, the patch
+ * solution is restricted back to the covered base nodes.
+ */
+void AdaptiveFluidDynamics(const Real dt, Hierarchy *hier, Space *space, const Model *model)
+{
+    if (0 == (hier->stepC % model->amrN)) {
+        Regrid(hier, space, model);
+    }
+    ++(hier->stepC);
+    for (int n = 0; n < hier->patchN; ++n) {
+        StoreInterfaceData(hier->patch + n, space);
+    }
+    FluidDynamics(dt, space, model);
+    Patch *patch = NULL;
+    for (int n = 0; n < hier->patchN; ++n) {
+        patch = hier->patch + n;
+        UpdatePatchGeometry(0, patch, space, model);
+        for (int q = 0; q < RATIO; ++q) {
+            InterpolateInterfaceData(((Real)q + 0.5) / (Real)RATIO, patch, space);
+            BoundaryConditionsAndTreatments(TO, &(patch->space), model);
+            FluidDynamics(dt / (Real)RATIO, &(patch->space), model);
+        }
+        Restriction(patch, space);
+    }
+    if (0 != hier->patchN) {
+        BoundaryConditionsAndTreatments(TO, space, model);
+    }
+    return;
+}
+void ReleaseHierarchy(Hierarchy *hier)
+{
+    for (int n = 0; n < hier->patchN; ++n) {
+        ReleasePatch(hier->patch + n);
+    }
+    hier->patchN = 0;
+    RetrieveStorage(hier->patch);
+    hier->patch = NULL;
+    RetrieveStorage(hier->flag);
+    hier->flag = NULL;
+    return;
+}
+/*
+ * Regridding discards current patches and generates a new patch set
+ * from the base grid solution.
+ */
+static void Regrid(Hierarchy *hier, Space *space, const Model *model)
+{
+    const Partition *restrict part = &(space->part);
+    const int nodeN = part->n[X] * part->n[Y] * part->n[Z];
+    if (NULL == hier->patch) {
+        hier->patch = AssignStorage(NPATCH * sizeof(*hier->patch));
+    }
+    if (NULL == hier->flag) {
+        hier->flag = AssignStorage(2 * nodeN * sizeof(*hier->flag));
+    }
+    for (int n = 0; n < hier->patchN; ++n) {
+        ReleasePatch(hier->patch + n);
+    }
+    FlagRefinement(hier->flag, space, model);
+    BufferFlag(hier->flag, part);
+    int box[DIMS][LIMIT] = {{0}}; /* normal node range */
+    for (int s = 0; s < DIMS; ++s) {
+        box[s][MIN] = part->ng;
+        box[s][MAX] = part->n[s] - part->ng;
+    }
+    int boxList[NPATCH][DIMS][LIMIT] = {{{0}}};
+    hier->patchN = ClusterFlag(box, 0, hier->flag, part, 0, boxList);
+    for (int n = 0; n < hier->patchN; ++n) {
+        CreatePatch(boxList[n], space, hier->patch + n);
+        ProlongatePatch(hier->patch + n, space);
+        UpdatePatchGeometry(1, hier->patch + n, space, model);
+    }
+    fprintf(stdout, "  regridding: %d patches\n", hier->patchN);
+    return;
+}
+static void CollapsedDimension(const int collapse, int c[restrict])
+{
+    c[X] = (COLLAPSEX == collapse) || (COLLAPSEXY == collapse) ||
+        (COLLAPSEXZ == collapse) || (COLLAPSEXYZ == collapse);
+    c[Y] = (COLLAPSEY == collapse) || (COLLAPSEXY == collapse) ||
+        (COLLAPSEYZ == collapse) || (COLLAPSEXYZ == collapse);
+    c[Z] = (COLLAPSEZ == collapse) || (COLLAPSEXZ == collapse) ||
+        (COLLAPSEYZ == collapse) || (COLLAPSEXYZ == collapse);
+    return;
+}
+/*
+ * Nodes are flagged for refinement if they are interfacial nodes of
+ * immersed boundaries, or if the relative density variation across
+ * the node exceeds the given threshold.
+ */
+static void FlagRefinement(char *flag, const Space *space, const Model *model)
+{
+    const Partition *restrict part = &(space->part);
+    const Node *const node = space->node;
+    const int nodeN = part->n[X] * part->n[Y] * part->n[Z];
+    IntVec c = {0}; /* collapsed dimensions */
+    CollapsedDimension(part->collapse, c);
+    const IntVec h = {1, part->n[X], part->n[X] * part->n[Y]}; /* index stride */
+    int idx = 0; /* linear array index math variable */
+    int idxL = 0; /* index at left neighbour */
+    int idxR = 0; /* index at right neighbour */
+    memset(flag, 0, nodeN * sizeof(*flag));
+    for (int k = part->ns[PIN][Z][MIN]; k < part->ns[PIN][Z][MAX]; ++k) {
+        for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
+            for (int i = part->ns[PIN][X][MIN]; i < part->ns[PIN][X][MAX]; ++i) {
+                idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                if ((0 < node[idx].gst) || ((0 == node[idx].gid) && (0 < node[idx].lid))) {
+                    flag[idx] = 1;
+                    continue;
+                }
+                if (0 != node[idx].gid) {
+                    continue;
+                }
+                for (int s = 0; s < DIMS; ++s) {
+                    if (c[s]) {
+                        continue;
+                    }
+                    idxL = idx - h[s];
+                    idxR = idx + h[s];
+                    if (((0 < node[idxL].gid) && (0 >= node[idxL].gst)) ||
+                            ((0 < node[idxR].gid) && (0 >= node[idxR].gst))) {
+                        continue;
+                    }
+                    if (fabs(node[idxR].U[TO][0] - node[idxL].U[TO][0]) >
+                            2.0 * model->amrTol * node[idx].U[TO][0]) {
+                        flag[idx] = 1;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    return;
+}
+/*
+ * Extend flagged regions by the ghost layers required by the numerical
+ * scheme to keep moving features inside patches between regriddings.
+ */
+static void BufferFlag(char *flag, const Partition *part)
+{
+    const int nodeN = part->n[X] * part->n[Y] * part->n[Z];
+    char *swap = flag + nodeN;
+    IntVec c = {0}; /* collapsed dimensions */
+    CollapsedDimension(part->collapse, c);
+    const IntVec h = {1, part->n[X], part->n[X] * part->n[Y]}; /* index stride */
+    int idx = 0; /* linear array index math variable */
+    int ih[DIMS] = {0}; /* neighbour node index */
+    for (int s = 0; s < DIMS; ++s) {
+        if (c[s]) {
+            continue;
+        }
+        memcpy(swap, flag, nodeN * sizeof(*flag));
+        for (int k = part->ns[PIN][Z][MIN]; k < part->ns[PIN][Z][MAX]; ++k) {
+            for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
+                for (int i = part->ns[PIN][X][MIN]; i < part->ns[PIN][X][MAX]; ++i) {
+                    idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                    ih[X] = i;
+                    ih[Y] = j;
+                    ih[Z] = k;
+                    for (int r = -part->gl; r <= part->gl; ++r) {
+                        if ((ih[s] + r < part->ns[PIN][s][MIN]) || (ih[s] + r >= part->ns[PIN][s][MAX])) {
+                            continue;
+                        }
+                        if (0 != swap[idx + r * h[s]]) {
+                            flag[idx] = 1;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return;
+}
+/*
+ * Berger, M., & Rigoutsos, I. (1991). An algorithm for point clustering
+ * and grid generation. IEEE Transactions on Systems, Man, and
+ * Cybernetics, 21(5), 1278-1286.
+ *
+ * Boxes are shrunk to flagged nodes and accepted once the ratio of flagged
+ * nodes is high enough; otherwise split at a hole of the signature or at
+ * the middle of the longest dimension. Space for boxes of pending halves
+ * is reserved to respect the maximum number of patches.
+ */
+static int ClusterFlag(int box[restrict][LIMIT], const int pending, const char *flag,
+        const Partition *part, int boxN, int boxList[restrict][DIMS][LIMIT])
+{
+    const Real efficiency = 0.7;
+    IntVec c = {0}; /* collapsed dimensions */
+    CollapsedDimension(part->collapse, c);
+    int tight[DIMS][LIMIT] = {{INT_MAX, INT_MIN}, {INT_MAX, INT_MIN}, {INT_MAX, INT_MIN}};
+    int count = 0;
+    int idx = 0; /* linear array index math variable */
+    for (int k = box[Z][MIN]; k < box[Z][MAX]; ++k) {
+        for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
+            for (int i = box[X][MIN]; i < box[X][MAX]; ++i) {
+                idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                if (0 == flag[idx]) {
+                    continue;
+                }
+                ++count;
+                tight[X][MIN] = MinInt(tight[X][MIN], i);
+                tight[X][MAX] = MaxInt(tight[X][MAX], i + 1);
+                tight[Y][MIN] = MinInt(tight[Y][MIN], j);
+                tight[Y][MAX] = MaxInt(tight[Y][MAX], j + 1);
+                tight[Z][MIN] = MinInt(tight[Z][MIN], k);
+                tight[Z][MAX] = MaxInt(tight[Z][MAX], k + 1);
+            }
+        }
+    }
+    if (0 == count) {
+        return boxN;
+    }
+    int volume = 1;
+    int sMax = NONE; /* longest dimension */
+    for (int s = 0; s < DIMS; ++s) {
+        if (c[s]) { /* collapsed dimension is always fully covered */
+            tight[s][MIN] = part->ng;
+            tight[s][MAX] = part->n[s] - part->ng;
+            continue;
+        }
+        volume = volume * (tight[s][MAX] - tight[s][MIN]);
+        if ((NONE == sMax) || (tight[s][MAX] - tight[s][MIN] > tight[sMax][MAX] - tight[sMax][MIN])) {
+            sMax = s;
+        }
+    }
+    if ((NONE == sMax) || (efficiency * volume <= count) || (NPATCH < boxN + pending + 2) ||
+            (2 * CELLMIN >= tight[sMax][MAX] - tight[sMax][MIN])) {
+        memcpy(boxList[boxN], tight, sizeof(tight));
+        return boxN + 1;
+    }
+    /* find the hole of signature closest to the middle */
+    const int mid = (tight[sMax][MIN] + tight[sMax][MAX]) / 2;
+    int cut = mid;
+    int dist = INT_MAX;
+    int sub[DIMS][LIMIT] = {{0}};
+    memcpy(sub, tight, sizeof(sub));
+    for (int l = tight[sMax][MIN] + CELLMIN; l < tight[sMax][MAX] - CELLMIN; ++l) {
+        sub[sMax][MIN] = l;
+        sub[sMax][MAX] = l + 1;
+        count = 0;
+        for (int k = sub[Z][MIN]; k < sub[Z][MAX]; ++k) {
+            for (int j = sub[Y][MIN]; j < sub[Y][MAX]; ++j) {
+                for (int i = sub[X][MIN]; i < sub[X][MAX]; ++i) {
+                    count = count + flag[IndexNode(k, j, i, part->n[Y], part->n[X])];
+                }
+            }
+        }
+        if ((0 == count) && (abs(l - mid) < dist)) {
+            dist = abs(l - mid);
+            cut = l;
+        }
+    }
+    memcpy(sub, tight, sizeof(sub));
+    sub[sMax][MAX] = cut;
+    boxN = ClusterFlag(sub, pending + 1, flag, part, boxN, boxList);
+    memcpy(sub, tight, sizeof(sub));
+    sub[sMax][MIN] = cut;
+    boxN = ClusterFlag(sub, pending, flag, part, boxN, boxList);
+    return boxN;
+}
+/*
+ * A patch is organized as a complete space. Patch faces lying on the
+ * domain boundary inherit the physical boundary conditions, others are
+ * coarse-fine interfaces of which data are provided by the base grid.
+ */
+static void CreatePatch(int box[restrict][LIMIT], const Space *space, Patch *patch)
+{
+    const Partition *restrict base = &(space->part);
+    Partition *restrict part = &(patch->space.part);
+    IntVec c = {0}; /* collapsed dimensions */
+    CollapsedDimension(base->collapse, c);
+    *part = *base; /* inherit settings of the base grid */
+    for (int s = 0; s < DIMS; ++s) {
+        patch->r[s] = c[s] ? 1 : RATIO;
+        /* ensure a minimum patch size within the normal node range */
+        while ((!c[s]) && (CELLMIN > box[s][MAX] - 1 - box[s][MIN])) {
+            if (base->ng < box[s][MIN]) {
+                --box[s][MIN];
+            }
+            if (base->n[s] - base->ng > box[s][MAX]) {
+                ++box[s][MAX];
+            }
+            if ((base->ng == box[s][MIN]) && (base->n[s] - base->ng == box[s][MAX])) {
+                break;
+            }
+        }
+        patch->box[s][MIN] = box[s][MIN];
+        patch->box[s][MAX] = box[s][MAX];
+        part->m[s] = patch->r[s] * (box[s][MAX] - 1 - box[s][MIN]);
+        part->n[s] = part->m[s] + 1 + 2 * part->ng;
+        part->d[s] = base->d[s] / (Real)(patch->r[s]);
+        part->dd[s] = 1.0 / part->d[s];
+        part->domain[s][MIN] = PointSpace(box[s][MIN], base->domain[s][MIN], base->d[s], base->ng);
+        part->domain[s][MAX] = PointSpace(box[s][MAX] - 1, base->domain[s][MIN], base->d[s], base->ng);
+        for (int l = MIN; l < LIMIT; ++l) {
+            const int p = PWB + 2 * s + l;
+            const int onBoundary = (MIN == l) ? (base->ng == box[s][MIN]) :
+                (base->n[s] - base->ng == box[s][MAX]);
+            part->typeBC[p] = INTERFACE;
+            if ((onBoundary) && (PERIODIC != base->typeBC[p])) {
+                part->typeBC[p] = base->typeBC[p];
+            }
+        }
+    }
+    part->tinyL = 1.0e-6 * MinReal(part->d[X], MinReal(part->d[Y], part->d[Z]));
+    part->tinyL = part->tinyL * part->tinyL; /* distance square based comparison */
+    DomainPartition(&(patch->space));
+    const int nodeN = part->n[X] * part->n[Y] * part->n[Z];
+    patch->space.node = AssignStorage(nodeN * sizeof(*patch->space.node));
+    patch->Ut = AssignStorage(nodeN * sizeof(*patch->Ut));
+    for (int idx = 0; idx < nodeN; ++idx) {
+        patch->space.node[idx].gid = NONE;
+        patch->space.node[idx].fid = NONE;
+        patch->space.node[idx].lid = NONE;
+        patch->space.node[idx].gst = NONE;
+    }
+    /* geometries are shared, but state flags are maintained per patch */
+    Geometry *geo = &(patch->space.geo);
+    *geo = space->geo;
+    geo->poly = NULL;
+    memset(&(geo->bin), 0, sizeof(geo->bin)); /* particles are binned on the patch */
+    memset(&(geo->arena), 0, sizeof(geo->arena));
+    geo->listMax = 0; /* node lists are maintained on the patch */
+    geo->listSep = NULL;
+    geo->list = NULL;
+    geo->scan = NULL;
+    if (0 < geo->totN) {
+        geo->poly = AssignStorage(geo->totN * sizeof(*geo->poly));
+    }
+    return;
+}
+/*
+ * Stationary geometries are only flagged once by the node mapping, so
+ * they are treated as non-stationary when a patch is newly created.
+ */
+static void UpdatePatchGeometry(const int fresh, Patch *patch, const Space *space, const Model *model)
+{
+    Geometry *geo = &(patch->space.geo);
+    if (0 == geo->totN) {
+        return;
+    }
+    if ((0 == fresh) && (0 == model->fsi)) {
+        return;
+    }
+    memcpy(geo->poly, space->geo.poly, geo->totN * sizeof(*geo->poly));
+    if (0 != fresh) {
+        for (int n = 0; n < geo->totN; ++n) {
+            geo->poly[n].state = 0;
+        }
+    }
+    ComputeGeometryDomain(&(patch->space), model);
+    memcpy(geo->poly, space->geo.poly, geo->totN * sizeof(*geo->poly));
+    return;
+}
+/*
+ * Trilinear interpolation of conservative variables from the base grid.
+ * Nodes inside geometries are excluded and weights are renormalized.
+ */
+static void Prolongation(const Real p[restrict], const int tn, const Space *space, Real U[restrict])
+{
+    const Partition *restrict part = &(space->part);
+    const Node *const node = space->node;
+    const Real zero = 0.0;
+    const Real one = 1.0;
+    IntVec ic = {0}; /* lower corner node */
+    RealVec w = {zero}; /* interpolation weights */
+    Real c = zero;
+    for (int s = 0; s < DIMS; ++s) {
+        c = (p[s] - part->domain[s][MIN]) * part->dd[s] + part->ng;
+        ic[s] = MinInt(part->n[s] - 2, MaxInt(0, (int)floor(c)));
+        w[s] = MinReal(one, MaxReal(zero, c - ic[s]));
+    }
+    Real weight = zero;
+    Real weightSum = zero;
+    Real weightMax = zero;
+    int idx = 0; /* linear array index math variable */
+    int idxMax = IndexNode(ic[Z], ic[Y], ic[X], part->n[Y], part->n[X]);
+    for (int dim = 0; dim < DIMU; ++dim) {
+        U[dim] = zero;
+    }
+    for (int kk = 0; kk < 2; ++kk) {
+        for (int jj = 0; jj < 2; ++jj) {
+            for (int ii = 0; ii < 2; ++ii) {
+                idx = IndexNode(ic[Z] + kk, ic[Y] + jj, ic[X] + ii, part->n[Y], part->n[X]);
+                weight = (kk ? w[Z] : one - w[Z]) * (jj ? w[Y] : one - w[Y]) * (ii ? w[X] : one - w[X]);
+                if (weightMax < weight) {
+                    weightMax = weight;
+                    idxMax = idx;
+                }
+                if ((0 < node[idx].gid) && (0 >= node[idx].gst)) {
+                    continue;
+                }
+                weightSum = weightSum + weight;
+                for (int dim = 0; dim < DIMU; ++dim) {
+                    U[dim] = U[dim] + weight * node[idx].U[tn][dim];
+                }
+            }
+        }
+    }
+    if (zero == weightSum) { /* no valid node, use the closest one */
+        for (int dim = 0; dim < DIMU; ++dim) {
+            U[dim] = node[idxMax].U[tn][dim];
+        }
+        return;
+    }
+    for (int dim = 0; dim < DIMU; ++dim) {
+        U[dim] = U[dim] / weightSum;
+    }
+    return;
+}
+static void ProlongatePatch(Patch *patch, const Space *space)
+{
+    const Partition *restrict part = &(patch->space.part);
+    Node *const node = patch->space.node;
+    int idx = 0; /* linear array index math variable */
+    RealVec p = {0.0};
+    for (int k = 0; k < part->n[Z]; ++k) {
+        for (int j = 0; j < part->n[Y]; ++j) {
+            for (int i = 0; i < part->n[X]; ++i) {
+                idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                p[X] = PointSpace(i, part->domain[X][MIN], part->d[X], part->ng);
+                p[Y] = PointSpace(j, part->domain[Y][MIN], part->d[Y], part->ng);
+                p[Z] = PointSpace(k, part->domain[Z][MIN], part->d[Z], part->ng);
+                Prolongation(p, TO, space, node[idx].U[TO]);
+            }
+        }
+    }
+    return;
+}
+static void StoreInterfaceData(Patch *patch, const Space *space)
+{
+    const Partition *restrict part = &(patch->space.part);
+    int idx = 0; /* linear array index math variable */
+    RealVec p = {0.0};
+    for (int k = 0; k < part->n[Z]; ++k) {
+        for (int j = 0; j < part->n[Y]; ++j) {
+            for (int i = 0; i < part->n[X]; ++i) {
+                if ((part->ns[PIN][X][MIN] <= i) && (part->ns[PIN][X][MAX] > i) &&
+                        (part->ns[PIN][Y][MIN] <= j) && (part->ns[PIN][Y][MAX] > j) &&
+                        (part->ns[PIN][Z][MIN] <= k) && (part->ns[PIN][Z][MAX] > k)) {
+                    continue;
+                }
+                idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                p[X] = PointSpace(i, part->domain[X][MIN], part->d[X], part->ng);
+                p[Y] = PointSpace(j, part->domain[Y][MIN], part->d[Y], part->ng);
+                p[Z] = PointSpace(k, part->domain[Z][MIN], part->d[Z], part->ng);
+                Prolongation(p, TO, space, patch->Ut[idx]);
+            }
+        }
+    }
+    return;
+}
+/*
+ * Interface data are linearly interpolated in time between the stored
+ * data and the current base grid data, and are kept for all time levels
+ * during the substep.
+ */
+static void InterpolateInterfaceData(const Real theta, Patch *patch, const Space *space)
+{
+    const Partition *restrict part = &(patch->space.part);
+    Node *const node = patch->space.node;
+    int idx = 0; /* linear array index math variable */
+    RealVec p = {0.0};
+    Real U[DIMU] = {0.0};
+    for (int k = 0; k < part->n[Z]; ++k) {
+        for (int j = 0; j < part->n[Y]; ++j) {
+            for (int i = 0; i < part->n[X]; ++i) {
+                if ((part->ns[PIN][X][MIN] <= i) && (part->ns[PIN][X][MAX] > i) &&
+                        (part->ns[PIN][Y][MIN] <= j) && (part->ns[PIN][Y][MAX] > j) &&
+                        (part->ns[PIN][Z][MIN] <= k) && (part->ns[PIN][Z][MAX] > k)) {
+                    continue;
+                }
+                idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                p[X] = PointSpace(i, part->domain[X][MIN], part->d[X], part->ng);
+                p[Y] = PointSpace(j, part->domain[Y][MIN], part->d[Y], part->ng);
+                p[Z] = PointSpace(k, part->domain[Z][MIN], part->d[Z], part->ng);
+                Prolongation(p, TO, space, U);
+                for (int dim = 0; dim < DIMU; ++dim) {
+                    U[dim] = (1.0 - theta) * patch->Ut[idx][dim] + theta * U[dim];
+                    node[idx].U[TO][dim] = U[dim];
+                    node[idx].U[TN][dim] = U[dim];
+                    node[idx].U[TM][dim] = U[dim];
+                }
+            }
+        }
+    }
+    return;
+}
+/*
+ * Full weighting restriction, which is the conservative restriction for
+ * node-based control volumes. Injection is used where the weighting
+ * stencil touches geometries.
+ */
+static void Restriction(const Patch *patch, Space *space)
+{
+    const Partition *restrict part = &(space->part);
+    const Partition *restrict fine = &(patch->space.part);
+    Node *const node = space->node;
+    const Node *const nodeF = patch->space.node;
+    const Real wt[2][3] = {{0.0, 1.0, 0.0}, {0.25, 0.5, 0.25}};
+    int box[DIMS][LIMIT] = {{0}};
+    for (int s = 0; s < DIMS; ++s) {
+        box[s][MIN] = MaxInt(part->ns[PIN][s][MIN], patch->box[s][MIN] + (RATIO == patch->r[s]));
+        box[s][MAX] = MinInt(part->ns[PIN][s][MAX], patch->box[s][MAX] - (RATIO == patch->r[s]));
+    }
+    const IntVec h = {1, fine->n[X], fine->n[X] * fine->n[Y]}; /* index stride */
+    const IntVec rw = {RATIO == patch->r[X], RATIO == patch->r[Y], RATIO == patch->r[Z]};
+    int idx = 0; /* linear array index math variable */
+    int idxF = 0; /* index at fine node */
+    int idxH = 0; /* index at fine neighbour */
+    int inject = 0;
+    Real weight = 0.0;
+    Real U[DIMU] = {0.0};
+    for (int k = box[Z][MIN]; k < box[Z][MAX]; ++k) {
+        for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
+            for (int i = box[X][MIN]; i < box[X][MAX]; ++i) {
+                idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                if (0 != node[idx].gid) {
+                    continue;
+                }
+                idxF = IndexNode(fine->ng + patch->r[Z] * (k - patch->box[Z][MIN]),
+                        fine->ng + patch->r[Y] * (j - patch->box[Y][MIN]),
+                        fine->ng + patch->r[X] * (i - patch->box[X][MIN]), fine->n[Y], fine->n[X]);
+                inject = 0;
+                for (int dim = 0; dim < DIMU; ++dim) {
+                    U[dim] = 0.0;
+                }
+                for (int kk = -rw[Z]; kk <= rw[Z]; ++kk) {
+                    for (int jj = -rw[Y]; jj <= rw[Y]; ++jj) {
+                        for (int ii = -rw[X]; ii <= rw[X]; ++ii) {
+                            idxH = idxF + kk * h[Z] + jj * h[Y] + ii * h[X];
+                            if (0 != nodeF[idxH].gid) {
+                                inject = 1;
+                            }
+                            weight = wt[rw[Z]][kk+1] * wt[rw[Y]][jj+1] * wt[rw[X]][ii+1];
+                            for (int dim = 0; dim < DIMU; ++dim) {
+                                U[dim] = U[dim] + weight * nodeF[idxH].U[TO][dim];
+                            }
+                        }
+                    }
+                }
+                for (int dim = 0; dim < DIMU; ++dim) {
+                    node[idx].U[TO][dim] = inject ? nodeF[idxF].U[TO][dim] : U[dim];
+                }
+            }
+        }
+    }
+    return;
+}
+static void ReleasePatch(Patch *patch)
+{
+    RetrieveStorage(patch->space.node);
+    patch->space.node = NULL;
+    ReleaseDomainPartition(&(patch->space));
+    RetrieveStorage(patch->space.geo.poly);
+    patch->space.geo.poly = NULL;
+    RetrieveArenaStorage(&(patch->space.geo.arena));
+    memset(&(patch->space.geo.bin), 0, sizeof(patch->space.geo.bin));
+    ReleaseGeometryDomain(&(patch->space));
+    RetrieveStorage(patch->Ut);
+    patch->Ut = NULL;
+    return;
+}
+/* a good practice: end file with a newline */
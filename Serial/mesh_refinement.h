@@ -0,0 +1,65 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Header File Guards to Avoid Interdependence
+ ****************************************************************************/
+#ifndef ARTRACFD_MESH_REFINEMENT_H_ /* if this is the first definition */
+#define ARTRACFD_MESH_REFINEMENT_H_ /* a unique marker for this header file */
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+/*
+ * Refined patch structure
+ *
+ * A patch is a logically rectangular region of the base grid that is
+ * covered by a finer grid. The finer grid is organized as a complete
+ * space so that the base solver can be applied to it without change.
+ */
+typedef struct {
+    int box[DIMS][LIMIT]; /* covered node range of the base grid */
+    IntVec r; /* refinement ratio of each dimension */
+    Space space; /* refined space */
+    Real (*Ut)[DIMU]; /* interface data at the beginning of a base step */
+} Patch;
+/*
+ * Patch hierarchy structure
+ */
+typedef struct {
+    int patchN; /* number of patches */
+    int stepC; /* step count since last regridding */
+    char *flag; /* refinement flag of base grid nodes */
+    Patch *patch; /* patch list */
+} Hierarchy;
+/****************************************************************************
+ * Public Functions Declaration
+ ****************************************************************************/
+/*
+ * Adaptive fluid dynamics
+ *
+ * Function
+ *      Evolve fluid dynamics on the base grid and on the refined patches
+ *      with subcycling in time, then restrict the patch solution back to
+ *      the base grid. Patches are regenerated at the regridding frequency.
+ */
+extern void AdaptiveFluidDynamics(const Real dt, Hierarchy *, Space *, const Model *);
+/*
+ * Release hierarchy
+ *
+ * Function
+ *      Release the storage of refined patches.
+ */
+extern void ReleaseHierarchy(Hierarchy *);
+#endif
+/* a good practice: end file with a newline */
@@ -22,8 +22,7 @@
  * Data Structure Declarations
  ****************************************************************************/
 typedef enum {
-    CASEN = 2, /* total number of test cases */
-    CASE = 1, /* current case index */
+    CASE = TAYLORGREEN, /* current case index */
     CEN = 2, /* position index of center node in stencil */
     NSTENCIL = 5, /* number of nodes in a stencil */
 } CaseConstants;
@@ -39,16 +38,22 @@ static void VortexPreservation(const Real, const Real, const Real,
         const Model *, const Real [restrict], Real [restrict]);
 static void TaylorGreenVortex(const Real, const Real, const Real, 
         const Model *, const Real [restrict], Real [restrict]);
+static void ShockTube(const Real, const Real, const Real, 
+        const Model *, const Real [restrict], Real [restrict]);
+static void UniformFlow(const Real, const Real, const Real, 
+        const Model *, const Real [restrict], Real [restrict]);
 /****************************************************************************
  * Global Variables Definition with Private Scope
  ****************************************************************************/
 static TestCase SetCase[CASEN] = {
     VortexPreservation,
-    TaylorGreenVortex};
+    TaylorGreenVortex,
+    ShockTube,
+    UniformFlow};
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
-int SetField(const int tn, Space *space, const Model *model)
+int SetField(const int tn, const int c, Space *space, const Model *model)
 {
     const Partition *restrict part = &(space->part);
     Node *const node = space->node;
@@ -69,7 +74,7 @@ int SetField(const int tn, Space *space, const Model *model)
                 p[X] = PointSpace(i, part->domain[X][MIN], part->d[X], part->ng);
                 p[Y] = PointSpace(j, part->domain[Y][MIN], part->d[Y], part->ng);
                 p[Z] = PointSpace(k, part->domain[Z][MIN], part->d[Z], part->ng);
-                SetCase[CASE](p[X], p[Y], p[Z], model, Uo, Ue);
+                SetCase[c](p[X], p[Y], p[Z], model, Uo, Ue);
                 ConservativeByPrimitive(model->gamma, Ue, node[idx].U[tn]);
             }
         }
@@ -112,6 +117,34 @@ static void TaylorGreenVortex(const Real x, const Real y, const Real z,
     Ue[5] = Ue[4] / (Ue[0] * model->gasR);
     return;
 }
+static void ShockTube(const Real x, const Real y, const Real z, 
+        const Model *model, const Real Uo[restrict], Real Ue[restrict])
+{
+    /* left state is Sod's high pressure state, right state is the reference state */
+    Ue[0] = Uo[0];
+    Ue[1] = Uo[1];
+    Ue[2] = Uo[2];
+    Ue[3] = Uo[3];
+    Ue[4] = Uo[4];
+    if (0.0 > x + 0.0 * (y + z)) {
+        Ue[0] = 1.0;
+        Ue[1] = 0.0;
+        Ue[2] = 0.0;
+        Ue[3] = 0.0;
+        Ue[4] = 1.0;
+    }
+    Ue[5] = Ue[4] / (Ue[0] * model->gasR);
+    return;
+}
+static void UniformFlow(const Real x, const Real y, const Real z, 
+        const Model *model, const Real Uo[restrict], Real Ue[restrict])
+{
+    for (int dim = 0; dim < DIMUo - 1; ++dim) {
+        Ue[dim] = Uo[dim] + 0.0 * (x + y + z);
+    }
+    Ue[5] = Ue[4] / (Ue[0] * model->gasR);
+    return;
+}
 int ComputeSolutionError(Space *space, const Model *model)
 {
     FILE *filePointer = fopen("solution_error.csv", "w");
@@ -127,7 +160,7 @@ int ComputeSolutionError(Space *space, const Model *model)
     Real norm[3] = {0.0}; /* Lp norms */
     int N = 0; /* number of nodes */
     Real err = 0.0; /* solution error */
-    SetField(TN, space, model); /* compute exact solution field */
+    SetField(TN, CASE, space, model); /* compute exact solution field */
     for (int k = part->ns[PIN][Z][MIN]; k < part->ns[PIN][Z][MAX]; ++k) {
         for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
             for (int i = part->ns[PIN][X][MIN]; i < part->ns[PIN][X][MAX]; ++i) {
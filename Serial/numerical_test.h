@@ -20,13 +20,24 @@
 /****************************************************************************
  * Data Structure Declarations
  ****************************************************************************/
+typedef enum {
+    VORTEX = 0, /* isentropic vortex preservation */
+    TAYLORGREEN = 1, /* Taylor-Green vortex */
+    SHOCKTUBE = 2, /* Sod shock tube */
+    UNIFORM = 3, /* uniform flow */
+    CASEN = 4, /* total number of test cases */
+} TestCases;
 /****************************************************************************
  * Public Functions Declaration
  ****************************************************************************/
 /*
  * Case Field Settings
+ *
+ * Function
+ *      Set the field of the specified test case, the global initial values
+ *      are used as the reference state of the case.
  */
-extern int SetField(const int tn, Space *, const Model *);
+extern int SetField(const int tn, const int c, Space *, const Model *);
 /*
  * Compute Solution Error and Functional
  */
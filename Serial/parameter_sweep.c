@@ -0,0 +1,489 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#define _POSIX_C_SOURCE 200112L /* process and directory interface */
+#include "parameter_sweep.h"
+#include <stdio.h> /* standard library for input and output */
+#include <stdlib.h> /* dynamic memory allocation and exit */
+#include <string.h> /* manipulating strings */
+#include <limits.h> /* sizes of integral types */
+#include <errno.h> /* error numbers */
+#include <unistd.h> /* process creation and working directory */
+#include <sys/types.h> /* process identifier type */
+#include <sys/stat.h> /* directory creation */
+#include <sys/wait.h> /* process termination */
+#include "case_loader.h"
+#include "cfd_parameters.h"
+#include "initialization.h"
+#include "preprocess.h"
+#include "solve.h"
+#include "postprocess.h"
+#include "cfd_commons.h"
+#include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+/*
+ * Swept entry of the case file
+ */
+typedef struct {
+    String section; /* section name */
+    int occur; /* occurrence of the section */
+    int line; /* line of the entry in the section */
+    int target; /* line of the entry in the case file */
+    int valueN; /* number of values */
+    String text; /* values of the entry, split in place */
+    char **value; /* value list */
+} Entry;
+/*
+ * Parameter sweep
+ */
+typedef struct {
+    int entryN; /* number of swept entries */
+    int caseN; /* number of variants */
+    int lineN; /* number of lines of the case file */
+    Entry *entry; /* swept entries */
+    String *line; /* lines of the case file */
+} Sweep;
+/****************************************************************************
+ * Static Function Declarations
+ ****************************************************************************/
+static void ReadSweepData(Sweep *);
+static void ReadEntryData(FILE *, Entry *);
+static void ReadCaseLines(Sweep *);
+static void LocateEntry(const Sweep *, Entry *);
+static int SectionLine(const char *, const char *, const char *);
+static void LoadSharedGeometry(Time *, Space *, Model *);
+static void ReleaseSharedGeometry(Time *, Space *);
+static void RunVariant(const int, const Sweep *, const Geometry *);
+static void VariantIndex(const int, const Sweep *, int [restrict]);
+static void WriteVariantCase(const char *, const int [restrict], const Sweep *);
+static void CopyFile(const char *, const char *);
+static int WaitVariant(const int, const pid_t [restrict], int [restrict]);
+static void WriteSweepSummary(const Sweep *, const int [restrict]);
+static void ReleaseSweep(Sweep *);
+/****************************************************************************
+ * Function definitions
+ ****************************************************************************/
+/*
+ * Geometries are loaded once before variants are forked, hence each variant
+ * starts with a private copy of the loaded geometries without reading the
+ * geometry files again.
+ */
+int ParameterSweep(const int procN)
+{
+    Sweep sweep = {0};
+    Time time = {0};
+    Space space = {0};
+    Model model = {0};
+    ShowInformation("Session End");
+    ShowInformation("Parameter sweep...");
+    fprintf(stdout, "  loading sweep data...\n");
+    ReadSweepData(&sweep);
+    fprintf(stdout, "  loading shared geometry...\n");
+    LoadSharedGeometry(&time, &space, &model);
+    fprintf(stdout, "  running %d variants...\n", sweep.caseN);
+    pid_t *pid = AssignStorage(sweep.caseN * sizeof(*pid));
+    int *status = AssignStorage(sweep.caseN * sizeof(*status));
+    int runN = 0; /* number of running variants */
+    for (int v = 0; v < sweep.caseN; ++v) {
+        if (MaxInt(procN, 1) <= runN) {
+            runN = runN - WaitVariant(sweep.caseN, pid, status);
+        }
+        fflush(stdout); /* avoid duplicating buffered output in variants */
+        fflush(stderr);
+        pid[v] = fork();
+        if (0 > pid[v]) {
+            FatalError("failed to create variant process...");
+        }
+        if (0 == pid[v]) {
+            RunVariant(v, &sweep, &(space.geo));
+            RetrieveStorage(pid);
+            RetrieveStorage(status);
+            ReleaseSharedGeometry(&time, &space);
+            ReleaseSweep(&sweep);
+            exit(EXIT_SUCCESS);
+        }
+        ++runN;
+    }
+    while (0 < runN) {
+        runN = runN - WaitVariant(sweep.caseN, pid, status);
+    }
+    WriteSweepSummary(&sweep, status);
+    int failN = 0; /* number of failed variants */
+    for (int v = 0; v < sweep.caseN; ++v) {
+        if (0 != status[v]) {
+            ++failN;
+        }
+    }
+    fprintf(stdout, "  %d of %d variants succeeded\n", sweep.caseN - failN, sweep.caseN);
+    RetrieveStorage(pid);
+    RetrieveStorage(status);
+    ReleaseSharedGeometry(&time, &space);
+    ReleaseSweep(&sweep);
+    ShowInformation("Session End");
+    return failN;
+}
+static void ReadSweepData(Sweep *sweep)
+{
+    FILE *filePointer = fopen("artracfd.sweep", "r");
+    if (NULL == filePointer) {
+        FatalError("failed to open file: artracfd.sweep...");
+    }
+    /* read and process file line by line */
+    String currentLine = {'\0'}; /* store the current read line */
+    int nscan = 0; /* read conversion count */
+    int sweepCount = 0; /* sweep section count */
+    int entryCount = 0; /* entry section count */
+    while (NULL != fgets(currentLine, sizeof currentLine, filePointer)) {
+        CommandLineProcessor(currentLine); /* process current line */
+        if (0 == strncmp(currentLine, "sweep begin", sizeof currentLine)) {
+            ++sweepCount;
+            if ((1 != sweepCount) || (0 != entryCount)) {
+                FatalError("missing or repeated sections in sweep file");
+            }
+            Fgets(currentLine, sizeof currentLine, filePointer);
+            nscan = sscanf(currentLine, "%d", &(sweep->entryN));
+            VerifyReadConversion(nscan, 1);
+            if (0 >= sweep->entryN) {
+                FatalError("no swept entry in sweep file...");
+            }
+            sweep->entry = AssignStorage(sweep->entryN * sizeof(*sweep->entry));
+            continue;
+        }
+        if (0 == strncmp(currentLine, "entry begin", sizeof currentLine)) {
+            if (sweep->entryN <= entryCount) {
+                FatalError("missing or repeated sections in sweep file");
+            }
+            ReadEntryData(filePointer, sweep->entry + entryCount);
+            ++entryCount;
+            continue;
+        }
+    }
+    fclose(filePointer); /* close current opened file */
+    /* check missing information section in configuration */
+    if ((1 != sweepCount) || (sweep->entryN != entryCount)) {
+        FatalError("missing or repeated sections in sweep file");
+    }
+    /* locate swept entries in the case file and count variants */
+    ReadCaseLines(sweep);
+    sweep->caseN = 1;
+    for (int n = 0; n < sweep->entryN; ++n) {
+        LocateEntry(sweep, sweep->entry + n);
+        for (int m = 0; m < n; ++m) {
+            if (sweep->entry[m].target == sweep->entry[n].target) {
+                FatalError("repeated swept entries in sweep file...");
+            }
+        }
+        if (INT_MAX / sweep->entry[n].valueN < sweep->caseN) {
+            FatalError("too many variants in sweep file...");
+        }
+        sweep->caseN = sweep->caseN * sweep->entry[n].valueN;
+    }
+    return;
+}
+static void ReadEntryData(FILE *filePointer, Entry *entry)
+{
+    String currentLine = {'\0'}; /* store the current read line */
+    int nscan = 0; /* read conversion count */
+    Fgets(entry->section, sizeof entry->section, filePointer);
+    CommandLineProcessor(entry->section);
+    Fgets(currentLine, sizeof currentLine, filePointer);
+    nscan = sscanf(currentLine, "%d", &(entry->occur));
+    VerifyReadConversion(nscan, 1);
+    Fgets(currentLine, sizeof currentLine, filePointer);
+    nscan = sscanf(currentLine, "%d", &(entry->line));
+    VerifyReadConversion(nscan, 1);
+    Fgets(entry->text, sizeof entry->text, filePointer);
+    CommandLineProcessor(entry->text);
+    if ((1 > entry->occur) || (1 > entry->line)) {
+        FatalError("invalid swept entry in sweep file...");
+    }
+    /* split values at commas and trim spaces around each value */
+    entry->valueN = 1;
+    for (char *scanner = entry->text; '\0' != *scanner; ++scanner) {
+        if (',' == *scanner) {
+            ++(entry->valueN);
+        }
+    }
+    entry->value = AssignStorage(entry->valueN * sizeof(*entry->value));
+    char *scanner = entry->text;
+    for (int n = 0; n < entry->valueN; ++n) {
+        while (' ' == *scanner) {
+            ++scanner;
+        }
+        entry->value[n] = scanner;
+        while ((',' != *scanner) && ('\0' != *scanner)) {
+            ++scanner;
+        }
+        char *end = scanner;
+        if (',' == *scanner) {
+            ++scanner;
+        }
+        while ((entry->value[n] < end) && (' ' == *(end - 1))) {
+            --end;
+        }
+        *end = '\0';
+        if ('\0' == *(entry->value[n])) {
+            FatalError("empty value of swept entry in sweep file...");
+        }
+    }
+    return;
+}
+static void ReadCaseLines(Sweep *sweep)
+{
+    FILE *filePointer = fopen("artracfd.case", "r");
+    if (NULL == filePointer) {
+        FatalError("failed to open file: artracfd.case...");
+    }
+    String currentLine = {'\0'}; /* store the current read line */
+    sweep->lineN = 0;
+    while (NULL != fgets(currentLine, sizeof currentLine, filePointer)) {
+        ++(sweep->lineN);
+    }
+    if (0 == sweep->lineN) {
+        FatalError("empty case file: artracfd.case...");
+    }
+    sweep->line = AssignStorage(sweep->lineN * sizeof(*sweep->line));
+    rewind(filePointer); /* seek to the beginning of the file stream */
+    for (int l = 0; l < sweep->lineN; ++l) {
+        Fgets(sweep->line[l], sizeof sweep->line[l], filePointer);
+    }
+    fclose(filePointer); /* close current opened file */
+    return;
+}
+/*
+ * The entry line should be inside the section, that is, before the line
+ * ending the section.
+ */
+static void LocateEntry(const Sweep *sweep, Entry *entry)
+{
+    String currentLine = {'\0'}; /* store the current read line */
+    int occur = 0; /* occurrence count of the section */
+    for (int l = 0; l < sweep->lineN; ++l) {
+        memcpy(currentLine, sweep->line[l], sizeof currentLine);
+        CommandLineProcessor(currentLine);
+        if (0 == SectionLine(currentLine, entry->section, " begin")) {
+            continue;
+        }
+        ++occur;
+        if (entry->occur != occur) {
+            continue;
+        }
+        entry->target = l + entry->line;
+        for (int m = l + 1; m <= entry->target; ++m) {
+            if (sweep->lineN <= m) {
+                FatalError("swept entry out of section in case file...");
+            }
+            memcpy(currentLine, sweep->line[m], sizeof currentLine);
+            CommandLineProcessor(currentLine);
+            if (0 != SectionLine(currentLine, entry->section, " end")) {
+                FatalError("swept entry out of section in case file...");
+            }
+        }
+        return;
+    }
+    FatalError("swept section not found in case file...");
+    return;
+}
+static int SectionLine(const char *currentLine, const char *section, const char *tag)
+{
+    const size_t length = strlen(section);
+    if (0 != strncmp(currentLine, section, length)) {
+        return 0;
+    }
+    return (0 == strcmp(currentLine + length, tag));
+}
+/*
+ * Only the geometry counts of the case data are required to load geometries.
+ */
+static void LoadSharedGeometry(Time *time, Space *space, Model *model)
+{
+    LoadCaseData(time, space, model);
+    ComputeParameters(time, space, model);
+    if (0 != time->restart) {
+        FatalError("parameter sweep requires a non restart case...");
+    }
+    Geometry *geo = &(space->geo);
+    if (0 != geo->totN) {
+        geo->poly = AssignStorage(geo->totN * sizeof(*geo->poly));
+        InitializeGeometryData(geo);
+    }
+    return;
+}
+static void ReleaseSharedGeometry(Time *time, Space *space)
+{
+    RetrieveArenaStorage(&(space->geo.arena));
+    RetrieveStorage(space->geo.poly);
+    space->geo.poly = NULL;
+    RetrieveArenaStorage(&(time->arena));
+    time->pp = NULL;
+    time->lp = NULL;
+    return;
+}
+/*
+ * A variant runs in its own directory with the standard output and the
+ * standard error redirected to its log file. Failures exit the variant
+ * process only.
+ */
+static void RunVariant(const int v, const Sweep *sweep, const Geometry *shared)
+{
+    String dirName = {'\0'};
+    int *index = AssignStorage(sweep->entryN * sizeof(*index));
+    snprintf(dirName, sizeof(dirName), "sweep_%04d", v + 1);
+    if ((0 != mkdir(dirName, 0755)) && (EEXIST != errno)) {
+        FatalError("failed to create variant directory...");
+    }
+    if (0 != chdir(dirName)) {
+        FatalError("failed to enter variant directory...");
+    }
+    if (NULL == freopen("artracfd.log", "w", stdout)) {
+        FatalError("failed to write variant log...");
+    }
+    setvbuf(stdout, NULL, _IOLBF, BUFSIZ); /* keep the order of output and errors */
+    if (0 > dup2(STDOUT_FILENO, STDERR_FILENO)) {
+        FatalError("failed to write variant log...");
+    }
+    VariantIndex(v, sweep, index);
+    WriteVariantCase("artracfd.case", index, sweep);
+    CopyFile("../artracfd.geo", "artracfd.geo");
+    RetrieveStorage(index);
+    Time time = {0};
+    Space space = {0};
+    Model model = {0};
+    Preprocess(&time, &space, &model);
+    if ((0 != time.restart) || (shared->totN != space.geo.totN)) {
+        FatalError("variant does not match the shared geometry...");
+    }
+    if (0 != shared->totN) {
+        memcpy(space.geo.poly, shared->poly, shared->totN * sizeof(*shared->poly));
+    }
+    space.geo.loaded = 1;
+    Solve(&time, &space, &model);
+    Postprocess(&time, &space);
+    return;
+}
+/*
+ * Values of the last entry vary fastest.
+ */
+static void VariantIndex(const int v, const Sweep *sweep, int index[restrict])
+{
+    int rest = v;
+    for (int n = sweep->entryN - 1; 0 <= n; --n) {
+        index[n] = rest % sweep->entry[n].valueN;
+        rest = rest / sweep->entry[n].valueN;
+    }
+    return;
+}
+static void WriteVariantCase(const char *fileName, const int index[restrict], const Sweep *sweep)
+{
+    FILE *filePointer = fopen(fileName, "w");
+    if (NULL == filePointer) {
+        FatalError("failed to write case data file: artracfd.case...");
+    }
+    int swept = 0; /* whether current line is swept */
+    for (int l = 0; l < sweep->lineN; ++l) {
+        swept = 0;
+        for (int n = 0; n < sweep->entryN; ++n) {
+            if (sweep->entry[n].target == l) {
+                fprintf(filePointer, "%-18s # swept entry %d\n", sweep->entry[n].value[index[n]], n + 1);
+                swept = 1;
+                break;
+            }
+        }
+        if (0 == swept) {
+            fputs(sweep->line[l], filePointer);
+        }
+    }
+    fclose(filePointer); /* close current opened file */
+    return;
+}
+static void CopyFile(const char *source, const char *target)
+{
+    FILE *sourcePointer = fopen(source, "rb");
+    if (NULL == sourcePointer) {
+        FatalError("failed to open file to copy...");
+    }
+    FILE *targetPointer = fopen(target, "wb");
+    if (NULL == targetPointer) {
+        FatalError("failed to write file to copy...");
+    }
+    char buffer[BUFSIZ] = {'\0'};
+    size_t size = 0;
+    while (0 < (size = fread(buffer, 1, sizeof buffer, sourcePointer))) {
+        if (size != fwrite(buffer, 1, size, targetPointer)) {
+            FatalError("failed to write file to copy...");
+        }
+    }
+    fclose(sourcePointer); /* close current opened file */
+    fclose(targetPointer); /* close current opened file */
+    return;
+}
+/*
+ * Wait for any variant to terminate and record its exit status, a variant
+ * terminated by a signal is recorded as -1. Return the number of finished
+ * variants.
+ */
+static int WaitVariant(const int caseN, const pid_t pid[restrict], int status[restrict])
+{
+    int state = 0;
+    const pid_t done = wait(&state);
+    if (0 > done) {
+        FatalError("failed to wait for variant process...");
+    }
+    for (int v = 0; v < caseN; ++v) {
+        if (done != pid[v]) {
+            continue;
+        }
+        status[v] = WIFEXITED(state) ? WEXITSTATUS(state) : -1;
+        fprintf(stdout, "  variant %04d %s\n", v + 1, (0 == status[v]) ? "finished" : "failed");
+        return 1;
+    }
+    return 0;
+}
+static void WriteSweepSummary(const Sweep *sweep, const int status[restrict])
+{
+    FILE *filePointer = fopen("sweep.csv", "w");
+    if (NULL == filePointer) {
+        FatalError("failed to write sweep summary...");
+    }
+    int *index = AssignStorage(sweep->entryN * sizeof(*index));
+    fprintf(filePointer, "# variant, directory");
+    for (int n = 0; n < sweep->entryN; ++n) {
+        fprintf(filePointer, ", %s %d:%d", sweep->entry[n].section, sweep->entry[n].occur, sweep->entry[n].line);
+    }
+    fprintf(filePointer, ", status\n");
+    for (int v = 0; v < sweep->caseN; ++v) {
+        VariantIndex(v, sweep, index);
+        fprintf(filePointer, "%d, sweep_%04d", v + 1, v + 1);
+        for (int n = 0; n < sweep->entryN; ++n) {
+            fprintf(filePointer, ", %s", sweep->entry[n].value[index[n]]);
+        }
+        fprintf(filePointer, ", %d\n", status[v]);
+    }
+    RetrieveStorage(index);
+    fclose(filePointer); /* close current opened file */
+    return;
+}
+static void ReleaseSweep(Sweep *sweep)
+{
+    for (int n = 0; n < sweep->entryN; ++n) {
+        RetrieveStorage(sweep->entry[n].value);
+    }
+    RetrieveStorage(sweep->entry);
+    RetrieveStorage(sweep->line);
+    sweep->entry = NULL;
+    sweep->line = NULL;
+    return;
+}
+/* a good practice: end file with a newline */
@@ -0,0 +1,51 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Header File Guards to Avoid Interdependence
+ ****************************************************************************/
+#ifndef ARTRACFD_PARAMETER_SWEEP_H_ /* if this is the first definition */
+#define ARTRACFD_PARAMETER_SWEEP_H_ /* a unique marker for this header file */
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+/****************************************************************************
+ * Public Functions Declaration
+ ****************************************************************************/
+/*
+ * Parameter sweep
+ *
+ * Function
+ *      Run variants of the current case that differ in entries of the case
+ *      file. Entries and their values are specified in artracfd.sweep:
+ *
+ *      sweep begin
+ *      2                  # number of swept entries
+ *      sweep end
+ *      entry begin
+ *      west boundary      # section of the entry in artracfd.case
+ *      1                  # occurrence of the section (integer; from 1)
+ *      3                  # line of the entry in the section (integer; from 1)
+ *      1.5, 2, 2.5        # values of the entry
+ *      entry end
+ *
+ *      Variants are all combinations of entry values, the last entry varies
+ *      fastest. Geometries are loaded once and shared by all variants. Each
+ *      variant runs in a separate process in directory sweep_NNNN with its
+ *      own case file and log, at most procN variants run concurrently. The
+ *      values and exit status of variants are written to sweep.csv.
+ */
+extern int ParameterSweep(const int procN);
+#endif
+/* a good practice: end file with a newline */
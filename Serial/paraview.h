@@ -25,6 +25,9 @@
  */
 typedef char ParaviewString[80]; /* string data */
 typedef double ParaviewReal; /* real data */
+typedef enum {
+    PIECEMAX = 1000, /* limit of pieces, piece numbers have three digits */
+} ParaviewConstants;
 /*
  * Paraview configuration structure
  */
@@ -36,6 +39,9 @@ typedef struct {
     ParaviewString intType; /* Paraview int type */
     ParaviewString floatType; /* Paraview float type */
     ParaviewString byteOrder; /* byte order of data */
+    int range[DIMS][LIMIT]; /* node range of the output region */
+    int stride[DIMS]; /* sub-sampling stride of the output region */
+    int var; /* bit mask of output variables */
 }ParaviewSet;
 /****************************************************************************
  * Public Functions Declaration
@@ -50,6 +56,44 @@ extern int ReadStructuredDataParaview(Time *, Space *, const Model *);
  */
 extern int WritePolyDataParaview(const Time *, const Geometry *);
 extern int ReadPolyDataParaview(const Time *, Geometry *);
+/*
+ * Partitioned structured data and poly data writer and reader
+ *
+ * Function
+ *      Field data is split into slabs along the outermost dimension that
+ *      has cells, one piece per OpenMP thread, and each piece is written to
+ *      its own .vts file concurrently. A .pvts file that lists the piece
+ *      extents is referenced from the .pvd collection. Polygon geometries
+ *      are split likewise into .vtp pieces listed in a .pvtp file, analytical
+ *      spheres remain in a single .vtp file. Readers follow the piece lists,
+ *      thus a restart does not depend on the number of threads.
+ */
+extern int WriteStructuredDataParaviewPieces(const Time *, const Space *, const Model *);
+extern int ReadStructuredDataParaviewPieces(Time *, Space *, const Model *);
+extern int WritePolyDataParaviewPieces(const Time *, const Geometry *);
+extern int ReadPolyDataParaviewPieces(const Time *, Geometry *);
+/*
+ * Poly data writer and reader of polyhedron transforms
+ *
+ * Function
+ *      Polygon geometries are written once at initialization to the topology
+ *      file geo_stl_topo.vtp. Each output then writes geo_stlNNNNN.tf that
+ *      lists gid and the rows of the affine transform [A b] of each moving
+ *      polyhedron, which maps topology vertices x0 to x = A x0 + b, followed
+ *      by the state data of all polyhedra. Stationary polyhedra are skipped.
+ *      Analytical spheres are written as in full output.
+ */
+extern int WritePolyDataParaviewTransform(const Time *, const Geometry *);
+extern int ReadPolyDataParaviewTransform(const Time *, Geometry *);
+/*
+ * Region output writer
+ *
+ * Function
+ *      Write the n-th region output of time to a single file or to pieces.
+ *      Each region is a separate transient series with root name regionN_.
+ */
+extern int WriteRegionDataParaview(const int n, const Time *, const Space *, const Model *);
+extern int WriteRegionDataParaviewPieces(const int n, const Time *, const Space *, const Model *);
 /*
  * Polyhedron status writer and reader
  */
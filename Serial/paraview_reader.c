@@ -13,6 +13,7 @@
  ****************************************************************************/
 #include "paraview.h"
 #include <stdio.h> /* standard library for input and output */
+#include <stdlib.h> /* dynamic memory allocation and exit */
 #include <string.h> /* manipulating strings */
 #include <float.h> /* size of floating point values */
 #include "computational_geometry.h"
@@ -22,11 +23,17 @@
  * Static Function Declarations
  ****************************************************************************/
 static int ReadCaseFile(Time *, ParaviewSet *);
-static int ReadStructuredData(Space *, const Model *, ParaviewSet *);
+static int ReadStructuredData(int [DIMS][LIMIT], Space *, const Model *, ParaviewSet *);
+static int ReadDataArray(FILE *, const int, ParaviewReal *);
+static int ReadStructuredPieces(Space *, const Model *, ParaviewSet *);
 static int PointPolyDataReader(const Time *, Geometry *);
 static int ReadPointPolyData(const int, const int, Geometry *, ParaviewSet *);
 static int PolygonPolyDataReader(const Time *, Geometry *);
 static int ReadPolygonPolyData(const int, const int, Geometry *, ParaviewSet *);
+static int PolygonPolyDataPiecesReader(const Time *, Geometry *);
+static int ReadPolygonPieces(const int, const int, Geometry *, ParaviewSet *);
+static int PolygonTransformReader(const Time *, Geometry *);
+static int ReadPolygonTransform(const int, const int, Geometry *, ParaviewSet *);
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
@@ -44,7 +51,29 @@ int ReadStructuredDataParaview(Time *time, Space *space, const Model *model)
     snprintf(paraSet.baseName, sizeof(ParaviewString), "%s%05d", 
             paraSet.rootName, time->writeC); 
     ReadCaseFile(time, &paraSet);
-    ReadStructuredData(space, model, &paraSet);
+    int range[DIMS][LIMIT] = {{0}}; /* node range of the piece */
+    for (int s = 0; s < DIMS; ++s) {
+        range[s][MIN] = space->part.ns[PIN][s][MIN];
+        range[s][MAX] = space->part.ns[PIN][s][MAX];
+    }
+    ReadStructuredData(range, space, model, &paraSet);
+    return 0;
+}
+int ReadStructuredDataParaviewPieces(Time *time, Space *space, const Model *model)
+{
+    ParaviewSet paraSet = { /* initialize environment */
+        .rootName = "field", /* data file root name */
+        .baseName = {'\0'}, /* data file base name */
+        .fileName = {'\0'}, /* data file name */
+        .fileExt = ".pvts", /* data file extension */
+        .intType = "Int32", /* paraview int type */
+        .floatType = "Float32", /* paraview float type */
+        .byteOrder = "LittleEndian" /* byte order of data */
+    };
+    snprintf(paraSet.baseName, sizeof(ParaviewString), "%s%05d", 
+            paraSet.rootName, time->writeC); 
+    ReadCaseFile(time, &paraSet);
+    ReadStructuredPieces(space, model, &paraSet);
     return 0;
 }
 static int ReadCaseFile(Time *time, ParaviewSet *paraSet)
@@ -74,63 +103,128 @@ static int ReadCaseFile(Time *time, ParaviewSet *paraSet)
     fclose(filePointer); /* close current opened file */
     return 0;
 }
-static int ReadStructuredData(Space *space, const Model *model, ParaviewSet *paraSet)
+static int ReadStructuredData(int range[DIMS][LIMIT], Space *space, const Model *model, ParaviewSet *paraSet)
 {
     snprintf(paraSet->fileName, sizeof(ParaviewString), "%s%s", paraSet->baseName, paraSet->fileExt); 
-    FILE *filePointer = fopen(paraSet->fileName, "r");
+    FILE *filePointer = fopen(paraSet->fileName, "rb"); /* binary stream for repositioning */
     if (NULL == filePointer) {
         FatalError("failed to open data file...");
     }
-    int nscan = 0; /* read conversion count */
-    ParaviewReal data = 0.0; /* paraview scalar data */
-    /* set format specifier according to the type of Real */
-    char format[5] = "%lg"; /* default is double type */
-    if (sizeof(ParaviewReal) == sizeof(float)) {
-        strncpy(format, "%g", sizeof format); /* float type */
-    }
     const Partition *restrict part = &(space->part);
     Node *const node = space->node;
-    Real *restrict U = NULL;
-    int idx = 0; /* linear array index math variable */
+    const int totN = (range[X][MAX] - range[X][MIN]) * (range[Y][MAX] - range[Y][MIN]) *
+        (range[Z][MAX] - range[Z][MIN]);
+    /* primitive variables are staged in bulk before conversion */
+    ParaviewReal *data = AssignStorage(DIMU * totN * sizeof(*data));
     /* get rid of redundant lines */
     String currentLine = {'\0'}; /* store current line */
     ReadInLine(filePointer, "<PointData>");
     for (int count = 0; count < DIMU; ++count) {
         Fgets(currentLine, sizeof currentLine, filePointer);
-        for (int k = part->ns[PIN][Z][MIN]; k < part->ns[PIN][Z][MAX]; ++k) {
-            for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
-                for (int i = part->ns[PIN][X][MIN]; i < part->ns[PIN][X][MAX]; ++i) {
-                    idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                    U = node[idx].U[TO];
-                    nscan = fscanf(filePointer, format, &data);
-                    VerifyReadConversion(nscan, 1);
-                    switch (count) {
-                        case 0: /* rho */
-                            U[0] = data;
-                            break;
-                        case 1: /* u */
-                            U[1] = U[0] * data;
-                            break;
-                        case 2: /* v */
-                            U[2] = U[0] * data;
-                            break;
-                        case 3: /* w */
-                            U[3] = U[0] * data;
-                            break;
-                        case 4: /* p */
-                            U[4] = 0.5 * (U[1] * U[1] + U[2] * U[2] + U[3] * U[3]) / U[0] + 
-                                data / (model->gamma - 1.0);
-                            break;
-                        default:
-                            break;
-                    }
-                }
-            }
-        }
+        ReadDataArray(filePointer, totN, data + count * totN);
         Fgets(currentLine, sizeof currentLine, filePointer); /* get rid of the end of line of data */
         Fgets(currentLine, sizeof currentLine, filePointer);
     }
     fclose(filePointer); /* close current opened file */
+    const ParaviewReal *rho = data;
+    const ParaviewReal *u = data + totN;
+    const ParaviewReal *v = data + 2 * totN;
+    const ParaviewReal *w = data + 3 * totN;
+    const ParaviewReal *p = data + 4 * totN;
+    for (int k = range[Z][MIN], m = 0; k < range[Z][MAX]; ++k) {
+        for (int j = range[Y][MIN]; j < range[Y][MAX]; ++j) {
+            for (int i = range[X][MIN]; i < range[X][MAX]; ++i, ++m) {
+                Real *restrict U = node[IndexNode(k, j, i, part->n[Y], part->n[X])].U[TO];
+                U[0] = rho[m];
+                U[1] = U[0] * u[m];
+                U[2] = U[0] * v[m];
+                U[3] = U[0] * w[m];
+                U[4] = 0.5 * (U[1] * U[1] + U[2] * U[2] + U[3] * U[3]) / U[0] + 
+                    p[m] / (model->gamma - 1.0);
+            }
+        }
+    }
+    RetrieveStorage(data);
+    return 0;
+}
+/*
+ * Read n ASCII values of a data array through large block reads, and leave
+ * the file position right after the last value as fscanf does. The stream
+ * is binary so that the position is restored by an offset from the start.
+ */
+static int ReadDataArray(FILE *filePointer, const int n, ParaviewReal *value)
+{
+    const size_t chunk = 1 << 24; /* size of a block read */
+    const size_t margin = 64; /* no value token is longer than the margin */
+    char *buffer = AssignStorage(chunk + 1);
+    size_t size = 0; /* number of valid characters in buffer */
+    size_t at = 0; /* parsing position */
+    int eof = 0; /* end of file is reached */
+    long start = ftell(filePointer); /* file position of buffer[0] */
+    for (int m = 0; m < n; ++m) {
+        if ((!eof) && (margin > size - at)) {
+            memmove(buffer, buffer + at, size - at);
+            start = start + (long)at;
+            size = size - at;
+            at = 0;
+            const size_t got = fread(buffer + size, sizeof(char), chunk - size, filePointer);
+            eof = (chunk - size > got);
+            size = size + got;
+            buffer[size] = '\0';
+        }
+        char *tail = NULL;
+        value[m] = strtod(buffer + at, &tail);
+        if (buffer + at == tail) {
+            FatalError("reading information failed...");
+        }
+        at = tail - buffer;
+    }
+    fseek(filePointer, start + (long)at, SEEK_SET);
+    RetrieveStorage(buffer);
+    return 0;
+}
+static int ReadStructuredPieces(Space *space, const Model *model, ParaviewSet *paraSet)
+{
+    snprintf(paraSet->fileName, sizeof(ParaviewString), "%s%s", paraSet->baseName, paraSet->fileExt); 
+    FILE *filePointer = fopen(paraSet->fileName, "r");
+    if (NULL == filePointer) {
+        FatalError("failed to open data file...");
+    }
+    const Partition *restrict part = &(space->part);
+    String currentLine = {'\0'}; /* store current line */
+    int nscan = 0; /* read conversion count */
+    int pieceN = 0; /* piece count */
+    IntVec extent[LIMIT] = {{0}}; /* extent of a piece */
+    int range[DIMS][LIMIT] = {{0}}; /* node range of the piece */
+    ParaviewSet pieceSet = *paraSet;
+    snprintf(pieceSet.fileExt, sizeof(ParaviewString), ".vts"); 
+    /* pieces are read in sequence since neighbouring pieces share nodes */
+    while (NULL != fgets(currentLine, sizeof currentLine, filePointer)) {
+        nscan = sscanf(currentLine, " <Piece Extent=\"%d %d %d %d %d %d\"", 
+                &(extent[MIN][X]), &(extent[MAX][X]), &(extent[MIN][Y]), &(extent[MAX][Y]), 
+                &(extent[MIN][Z]), &(extent[MAX][Z])); 
+        if (6 != nscan) {
+            continue;
+        }
+        for (int s = 0; s < DIMS; ++s) {
+            range[s][MIN] = part->ns[PIN][s][MIN] + extent[MIN][s];
+            range[s][MAX] = part->ns[PIN][s][MIN] + extent[MAX][s] + 1;
+            if ((extent[MIN][s] < 0) || (range[s][MIN] >= range[s][MAX]) ||
+                    (range[s][MAX] > part->ns[PIN][s][MAX])) {
+                FatalError("piece extent exceeds the domain...");
+            }
+        }
+        if (PIECEMAX <= pieceN) {
+            FatalError("too many pieces in data file...");
+        }
+        snprintf(pieceSet.baseName, sizeof(ParaviewString), "%.70s_%03d", paraSet->baseName, pieceN % PIECEMAX); 
+        ReadStructuredData(range, space, model, &pieceSet);
+        ++pieceN;
+    }
+    fclose(filePointer); /* close current opened file */
+    if (0 == pieceN) {
+        FatalError("no piece found in data file...");
+    }
     return 0;
 }
 int ReadPolyDataParaview(const Time *time, Geometry *geo)
@@ -143,6 +237,26 @@ int ReadPolyDataParaview(const Time *time, Geometry *geo)
     }
     return 0;
 }
+int ReadPolyDataParaviewPieces(const Time *time, Geometry *geo)
+{
+    if (0 != geo->sphN) {
+        PointPolyDataReader(time, geo);
+    }
+    if (0 != geo->stlN) {
+        PolygonPolyDataPiecesReader(time, geo);
+    }
+    return 0;
+}
+int ReadPolyDataParaviewTransform(const Time *time, Geometry *geo)
+{
+    if (0 != geo->sphN) {
+        PointPolyDataReader(time, geo);
+    }
+    if (0 != geo->stlN) {
+        PolygonTransformReader(time, geo);
+    }
+    return 0;
+}
 static int PointPolyDataReader(const Time *time, Geometry *geo)
 {
     ParaviewSet paraSet = { /* initialize environment */
@@ -219,7 +333,7 @@ static int ReadPolygonPolyData(const int start, const int end, Geometry *geo, Pa
         nscan = sscanf(currentLine, "%*s %*s %d", &(poly->faceN)); 
         VerifyReadConversion(nscan, 1);
         Fgets(currentLine, sizeof currentLine, filePointer);
-        AllocatePolyhedronMemory(poly->vertN, poly->edgeN, poly->faceN, poly);
+        AllocatePolyhedronMemory(poly->vertN, poly->edgeN, poly->faceN, &(geo->arena), poly);
         poly->edgeN = 0; /* reset edge count before applying edge adding */
         Fgets(currentLine, sizeof currentLine, filePointer);
         Fgets(currentLine, sizeof currentLine, filePointer);
@@ -258,6 +372,135 @@ static int ReadPolygonPolyData(const int start, const int end, Geometry *geo, Pa
     fclose(filePointer); /* close current opened file */
     return 0;
 }
+static int PolygonPolyDataPiecesReader(const Time *time, Geometry *geo)
+{
+    ParaviewSet paraSet = { /* initialize environment */
+        .rootName = "geo_stl", /* data file root name */
+        .baseName = {'\0'}, /* data file base name */
+        .fileName = {'\0'}, /* data file name */
+        .fileExt = ".pvtp", /* data file extension */
+        .intType = "Int32", /* paraview int type */
+        .floatType = "Float32", /* paraview float type */
+        .byteOrder = "LittleEndian" /* byte order of data */
+    };
+    snprintf(paraSet.baseName, sizeof(ParaviewString), "%s%05d", 
+            paraSet.rootName, time->writeC); 
+    ReadPolygonPieces(geo->sphN, geo->totN, geo, &paraSet);
+    return 0;
+}
+static int ReadPolygonPieces(const int start, const int end, Geometry *geo, ParaviewSet *paraSet)
+{
+    snprintf(paraSet->fileName, sizeof(ParaviewString), "%s%s", paraSet->baseName, paraSet->fileExt); 
+    FILE *filePointer = fopen(paraSet->fileName, "r");
+    if (NULL == filePointer) {
+        FatalError("failed to open data file...");
+    }
+    String currentLine = {'\0'}; /* store current line */
+    int nscan = 0; /* read conversion count */
+    int pieceN = 0; /* piece count */
+    int pieceRange[LIMIT] = {0}; /* polyhedron range of a piece */
+    int next = start; /* first polyhedron not read yet */
+    ParaviewSet pieceSet = *paraSet;
+    snprintf(pieceSet.fileExt, sizeof(ParaviewString), ".vtp"); 
+    /* pieces are read in sequence since polyhedra share the storage arena */
+    ReadInLine(filePointer, "<!--");
+    while (NULL != fgets(currentLine, sizeof currentLine, filePointer)) {
+        nscan = sscanf(currentLine, "%*s %d %d", &(pieceRange[MIN]), &(pieceRange[MAX])); 
+        if (2 != nscan) {
+            break;
+        }
+        if ((next != pieceRange[MIN]) || (pieceRange[MIN] > pieceRange[MAX]) || (end < pieceRange[MAX])) {
+            FatalError("piece range mismatches the geometries...");
+        }
+        if (PIECEMAX <= pieceN) {
+            FatalError("too many pieces in data file...");
+        }
+        snprintf(pieceSet.baseName, sizeof(ParaviewString), "%.70s_%03d", paraSet->baseName, pieceN % PIECEMAX); 
+        ReadPolygonPolyData(pieceRange[MIN], pieceRange[MAX], geo, &pieceSet);
+        next = pieceRange[MAX];
+        ++pieceN;
+    }
+    fclose(filePointer); /* close current opened file */
+    if (end != next) {
+        FatalError("piece range mismatches the geometries...");
+    }
+    return 0;
+}
+static int PolygonTransformReader(const Time *time, Geometry *geo)
+{
+    ParaviewSet paraSet = { /* initialize environment */
+        .rootName = "geo_stl", /* data file root name */
+        .baseName = {'\0'}, /* data file base name */
+        .fileName = {'\0'}, /* data file name */
+        .fileExt = ".tf", /* data file extension */
+        .intType = "Int32", /* paraview int type */
+        .floatType = "Float32", /* paraview float type */
+        .byteOrder = "LittleEndian" /* byte order of data */
+    };
+    ParaviewSet topoSet = paraSet;
+    snprintf(topoSet.baseName, sizeof(ParaviewString), "%s_topo", paraSet.rootName); 
+    snprintf(topoSet.fileExt, sizeof(ParaviewString), ".vtp"); 
+    ReadPolygonPolyData(geo->sphN, geo->totN, geo, &topoSet);
+    snprintf(paraSet.baseName, sizeof(ParaviewString), "%s%05d", 
+            paraSet.rootName, time->writeC); 
+    ReadPolygonTransform(geo->sphN, geo->totN, geo, &paraSet);
+    return 0;
+}
+/*
+ * Polyhedra not listed are stationary and keep the topology.
+ */
+static int ReadPolygonTransform(const int start, const int end, Geometry *geo, ParaviewSet *paraSet)
+{
+    snprintf(paraSet->fileName, sizeof(ParaviewString), "%s%s", paraSet->baseName, paraSet->fileExt); 
+    FILE *filePointer = fopen(paraSet->fileName, "r");
+    if (NULL == filePointer) {
+        FatalError("failed to open data file...");
+    }
+    String currentLine = {'\0'}; /* store current line */
+    int nscan = 0; /* read conversion count */
+    int gid = 0; /* geometry identifier */
+    Real tf[DIMS][DIMS + 1] = {{0.0}}; /* affine transform */
+    /* set format specifier according to the type of Real */
+    char format[100] = "%d, %lg, %lg, %lg, %lg, %lg, %lg, %lg, %lg, %lg, %lg, %lg, %lg";
+    if (sizeof(Real) == sizeof(float)) { /* if set Real as float */
+        strncpy(format, "%d, %g, %g, %g, %g, %g, %g, %g, %g, %g, %g, %g, %g", sizeof format);
+    }
+    while (NULL != fgets(currentLine, sizeof currentLine, filePointer)) {
+        CommandLineProcessor(currentLine); /* process current line */
+        if (0 == strncmp(currentLine, "<!--", sizeof currentLine)) {
+            break;
+        }
+        if ('\0' == currentLine[0]) {
+            continue;
+        }
+        nscan = sscanf(currentLine, format, &gid,
+                tf[X] + 0, tf[X] + 1, tf[X] + 2, tf[X] + 3,
+                tf[Y] + 0, tf[Y] + 1, tf[Y] + 2, tf[Y] + 3,
+                tf[Z] + 0, tf[Z] + 1, tf[Z] + 2, tf[Z] + 3);
+        VerifyReadConversion(nscan, 13);
+        if ((start >= gid) || (end < gid)) {
+            FatalError("transform mismatches the geometries...");
+        }
+        memcpy(geo->poly[gid - 1].tf, tf, sizeof tf);
+    }
+    ReadPolyhedronStateData(start, end, filePointer, geo);
+    fclose(filePointer); /* close current opened file */
+    /* move vertices from the topology */
+    RealVec v = {0.0};
+    for (int m = start; m < end; ++m) {
+        Polyhedron *poly = geo->poly + m;
+        for (int n = 0; n < poly->vertN; ++n) {
+            for (int s = 0; s < DIMS; ++s) {
+                v[s] = poly->v[n][s];
+            }
+            for (int s = 0; s < DIMS; ++s) {
+                poly->v[n][s] = poly->tf[s][X] * v[X] + poly->tf[s][Y] * v[Y] + 
+                    poly->tf[s][Z] * v[Z] + poly->tf[s][DIMS];
+            }
+        }
+    }
+    return 0;
+}
 int ReadPolyhedronStateData(const int start, const int end, FILE *filePointer, Geometry *geo)
 {
     String currentLine = {'\0'}; /* store the current read line */
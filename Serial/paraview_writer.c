@@ -14,22 +14,56 @@
 #include "paraview.h"
 #include <stdio.h> /* standard library for input and output */
 #include <string.h> /* manipulating strings */
+#ifdef _OPENMP
+#include <omp.h> /* OpenMP runtime */
+#endif
 #include "cfd_commons.h"
 #include "commons.h"
 /****************************************************************************
  * Static Function Declarations
  ****************************************************************************/
+static int WriteFieldOutput(const int, const int, const Time *, const Space *, const Model *);
 static int InitializeTransientCaseFile(ParaviewSet *);
 static int WriteCaseFile(const Time *, ParaviewSet *);
-static int WriteStructuredData(const Space *, const Model *, ParaviewSet *);
+static int WriteStructuredData(int [DIMS][LIMIT], const Space *, const Model *, ParaviewSet *);
+static int WriteStructuredPieces(const Space *, const Model *, ParaviewSet *);
+static int PieceCount(const int);
 static int PointPolyDataWriter(const Time *, const Geometry *);
 static int WritePointPolyData(const int, const int, const Geometry *, ParaviewSet *);
 static int PolygonPolyDataWriter(const Time *, const Geometry *);
 static int WritePolygonPolyData(const int, const int, const Geometry *, ParaviewSet *);
+static int PolygonPolyDataPiecesWriter(const Time *, const Geometry *);
+static int WritePolygonPieces(const int, const int, const Geometry *, ParaviewSet *);
+static int PolygonTransformWriter(const Time *, const Geometry *);
+static int WritePolygonTransform(const int, const int, const Time *, const Geometry *, ParaviewSet *);
+/****************************************************************************
+ * Global Variables Definition with Private Scope
+ ****************************************************************************/
+static const char scalar[VAROUT-1][5] = {"rho", "u", "v", "w", "p", "T", "gid", "fid", "lid", "gst"};
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
 int WriteStructuredDataParaview(const Time *time, const Space *space, const Model *model)
+{
+    return WriteFieldOutput(NONE, 0, time, space, model);
+}
+int WriteStructuredDataParaviewPieces(const Time *time, const Space *space, const Model *model)
+{
+    return WriteFieldOutput(NONE, 1, time, space, model);
+}
+int WriteRegionDataParaview(const int n, const Time *time, const Space *space, const Model *model)
+{
+    return WriteFieldOutput(n, 0, time, space, model);
+}
+int WriteRegionDataParaviewPieces(const int n, const Time *time, const Space *space, const Model *model)
+{
+    return WriteFieldOutput(n, 1, time, space, model);
+}
+/*
+ * Write the n-th region output, or field data of the whole interior domain
+ * if n is NONE, to a single file or to pieces.
+ */
+static int WriteFieldOutput(const int n, const int pieces, const Time *time, const Space *space, const Model *model)
 {
     ParaviewSet paraSet = { /* initialize environment */
         .rootName = "field", /* data file root name */
@@ -38,15 +72,45 @@ int WriteStructuredDataParaview(const Time *time, const Space *space, const Mode
         .fileExt = ".vts", /* data file extension */
         .intType = "Int32", /* paraview int type */
         .floatType = "Float32", /* paraview float type */
-        .byteOrder = "LittleEndian" /* byte order of data */
+        .byteOrder = "LittleEndian", /* byte order of data */
+        .var = (1 << VAROUT) - 1 /* all variables */
     };
+    const Partition *restrict part = &(space->part);
+    int writeC = time->writeC; /* writing count */
+    int init = (0 == time->stepC); /* this is the initialization step */
+    for (int s = 0; s < DIMS; ++s) {
+        paraSet.range[s][MIN] = part->ns[PIN][s][MIN];
+        paraSet.range[s][MAX] = part->ns[PIN][s][MAX];
+        paraSet.stride[s] = 1;
+    }
+    if (NONE != n) {
+        const FieldOutput *out = time->output + n;
+        snprintf(paraSet.rootName, sizeof(ParaviewString), "region%d_", n + 1); 
+        writeC = out->writeC;
+        init = (0 == writeC); /* a region series continues across restarts */
+        for (int s = 0; s < DIMS; ++s) {
+            paraSet.range[s][MIN] = ValidNodeSpace(NodeSpace(out->box[s][MIN], part->domain[s][MIN], 
+                        part->dd[s], part->ng), part->ns[PIN][s][MIN], part->ns[PIN][s][MAX]);
+            paraSet.range[s][MAX] = ValidNodeSpace(NodeSpace(out->box[s][MAX], part->domain[s][MIN], 
+                        part->dd[s], part->ng), part->ns[PIN][s][MIN], part->ns[PIN][s][MAX]) + 1;
+            paraSet.stride[s] = out->stride[s];
+        }
+        paraSet.var = out->var;
+    }
+    if (pieces) {
+        snprintf(paraSet.fileExt, sizeof(ParaviewString), ".pvts"); 
+    }
     snprintf(paraSet.baseName, sizeof(ParaviewString), "%s%05d", 
-            paraSet.rootName, time->writeC); 
-    if (0 == time->stepC) { /* this is the initialization step */
+            paraSet.rootName, writeC); 
+    if (init) {
         InitializeTransientCaseFile(&paraSet);
     }
     WriteCaseFile(time, &paraSet);
-    WriteStructuredData(space, model, &paraSet);
+    if (pieces) {
+        WriteStructuredPieces(space, model, &paraSet);
+    } else {
+        WriteStructuredData(paraSet.range, space, model, &paraSet);
+    }
     return 0;
 }
 static int InitializeTransientCaseFile(ParaviewSet *paraSet)
@@ -108,7 +172,7 @@ static int WriteCaseFile(const Time *time, ParaviewSet *paraSet)
     fclose(filePointer); /* close current opened file */
     return 0;
 }
-static int WriteStructuredData(const Space *space, const Model *model, ParaviewSet *paraSet)
+static int WriteStructuredData(int range[DIMS][LIMIT], const Space *space, const Model *model, ParaviewSet *paraSet)
 {
     snprintf(paraSet->fileName, sizeof(ParaviewString), "%s%s", paraSet->baseName, paraSet->fileExt); 
     FILE *filePointer = fopen(paraSet->fileName, "w");
@@ -117,30 +181,35 @@ static int WriteStructuredData(const Space *space, const Model *model, ParaviewS
     }
     ParaviewReal data = 0.0; /* paraview scalar data */
     ParaviewReal Vec[3] = {0.0}; /* paraview vector data */
-    const char scalar[10][5] = {"rho", "u", "v", "w", "p", "T", "gid", "fid", "lid", "gst"};
     const Partition *restrict part = &(space->part);
     const Node *const node = space->node;
     const Real *restrict U = NULL;
+    const int *stride = paraSet->stride;
     int idx = 0; /* linear array index math variable */
     IntVec nodeCount = {0}; /* i, j, k node number in each part */
-    nodeCount[X] = part->ns[PIN][X][MAX] - part->ns[PIN][X][MIN] - 1; 
-    nodeCount[Y] = part->ns[PIN][Y][MAX] - part->ns[PIN][Y][MIN] - 1; 
-    nodeCount[Z] = part->ns[PIN][Z][MAX] - part->ns[PIN][Z][MIN] - 1; 
+    nodeCount[X] = (paraSet->range[X][MAX] - paraSet->range[X][MIN] - 1) / stride[X]; 
+    nodeCount[Y] = (paraSet->range[Y][MAX] - paraSet->range[Y][MIN] - 1) / stride[Y]; 
+    nodeCount[Z] = (paraSet->range[Z][MAX] - paraSet->range[Z][MIN] - 1) / stride[Z]; 
     fprintf(filePointer, "<?xml version=\"1.0\"?>\n");
     fprintf(filePointer, "<VTKFile type=\"StructuredGrid\" version=\"1.0\"\n");
     fprintf(filePointer, "         byte_order=\"%s\">\n", paraSet->byteOrder);
     fprintf(filePointer, "  <StructuredGrid WholeExtent=\"%d %d %d %d %d %d\">\n", 
             0, nodeCount[X], 0, nodeCount[Y], 0, nodeCount[Z]);
     fprintf(filePointer, "    <Piece Extent=\"%d %d %d %d %d %d\">\n", 
-            0, nodeCount[X], 0, nodeCount[Y], 0, nodeCount[Z]);
+            (range[X][MIN] - paraSet->range[X][MIN]) / stride[X], (range[X][MAX] - paraSet->range[X][MIN] - 1) / stride[X],
+            (range[Y][MIN] - paraSet->range[Y][MIN]) / stride[Y], (range[Y][MAX] - paraSet->range[Y][MIN] - 1) / stride[Y],
+            (range[Z][MIN] - paraSet->range[Z][MIN]) / stride[Z], (range[Z][MAX] - paraSet->range[Z][MIN] - 1) / stride[Z]);
     fprintf(filePointer, "      <PointData>\n");
-    for (int count = 0; count < 10; ++count) {
+    for (int count = 0; count < (VAROUT - 1); ++count) {
+        if (!(paraSet->var & (1 << count))) {
+            continue;
+        }
         fprintf(filePointer, "        <DataArray type=\"%s\" Name=\"%s\" format=\"ascii\">\n", 
                 paraSet->floatType, scalar[count]);
         fprintf(filePointer, "          ");
-        for (int k = part->ns[PIN][Z][MIN]; k < part->ns[PIN][Z][MAX]; ++k) {
-            for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
-                for (int i = part->ns[PIN][X][MIN]; i < part->ns[PIN][X][MAX]; ++i) {
+        for (int k = range[Z][MIN]; k < range[Z][MAX]; k += stride[Z]) {
+            for (int j = range[Y][MIN]; j < range[Y][MAX]; j += stride[Y]) {
+                for (int i = range[X][MIN]; i < range[X][MAX]; i += stride[X]) {
                     idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
                     U = node[idx].U[TO];
                     switch (count) {
@@ -183,22 +252,24 @@ static int WriteStructuredData(const Space *space, const Model *model, ParaviewS
         }
         fprintf(filePointer, "\n        </DataArray>\n");
     }
-    fprintf(filePointer, "        <DataArray type=\"%s\" Name=\"Vel\"\n", paraSet->floatType);
-    fprintf(filePointer, "                   NumberOfComponents=\"3\" format=\"ascii\">\n");
-    fprintf(filePointer, "          ");
-    for (int k = part->ns[PIN][Z][MIN]; k < part->ns[PIN][Z][MAX]; ++k) {
-        for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
-            for (int i = part->ns[PIN][X][MIN]; i < part->ns[PIN][X][MAX]; ++i) {
-                idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                U = node[idx].U[TO];
-                Vec[X] = U[1] / U[0];
-                Vec[Y] = U[2] / U[0];
-                Vec[Z] = U[3] / U[0];
-                fprintf(filePointer, "%.6g %.6g %.6g ", Vec[X], Vec[Y], Vec[Z]);
+    if (paraSet->var & (1 << (VAROUT - 1))) {
+        fprintf(filePointer, "        <DataArray type=\"%s\" Name=\"Vel\"\n", paraSet->floatType);
+        fprintf(filePointer, "                   NumberOfComponents=\"3\" format=\"ascii\">\n");
+        fprintf(filePointer, "          ");
+        for (int k = range[Z][MIN]; k < range[Z][MAX]; k += stride[Z]) {
+            for (int j = range[Y][MIN]; j < range[Y][MAX]; j += stride[Y]) {
+                for (int i = range[X][MIN]; i < range[X][MAX]; i += stride[X]) {
+                    idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                    U = node[idx].U[TO];
+                    Vec[X] = U[1] / U[0];
+                    Vec[Y] = U[2] / U[0];
+                    Vec[Z] = U[3] / U[0];
+                    fprintf(filePointer, "%.6g %.6g %.6g ", Vec[X], Vec[Y], Vec[Z]);
+                }
             }
         }
+        fprintf(filePointer, "\n        </DataArray>\n");
     }
-    fprintf(filePointer, "\n        </DataArray>\n");
     fprintf(filePointer, "      </PointData>\n");
     fprintf(filePointer, "      <CellData>\n");
     fprintf(filePointer, "      </CellData>\n");
@@ -206,9 +277,9 @@ static int WriteStructuredData(const Space *space, const Model *model, ParaviewS
     fprintf(filePointer, "        <DataArray type=\"%s\" Name=\"points\"\n", paraSet->floatType);
     fprintf(filePointer, "                   NumberOfComponents=\"3\" format=\"ascii\">\n");
     fprintf(filePointer, "          ");
-    for (int k = part->ns[PIN][Z][MIN]; k < part->ns[PIN][Z][MAX]; ++k) {
-        for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
-            for (int i = part->ns[PIN][X][MIN]; i < part->ns[PIN][X][MAX]; ++i) {
+    for (int k = range[Z][MIN]; k < range[Z][MAX]; k += stride[Z]) {
+        for (int j = range[Y][MIN]; j < range[Y][MAX]; j += stride[Y]) {
+            for (int i = range[X][MIN]; i < range[X][MAX]; i += stride[X]) {
                 Vec[X] = PointSpace(i, part->domain[X][MIN], part->d[X], part->ng);
                 Vec[Y] = PointSpace(j, part->domain[Y][MIN], part->d[Y], part->ng);
                 Vec[Z] = PointSpace(k, part->domain[Z][MIN], part->d[Z], part->ng);
@@ -224,6 +295,92 @@ static int WriteStructuredData(const Space *space, const Model *model, ParaviewS
     fclose(filePointer); /* close current opened file */
     return 0;
 }
+static int WriteStructuredPieces(const Space *space, const Model *model, ParaviewSet *paraSet)
+{
+    snprintf(paraSet->fileName, sizeof(ParaviewString), "%s%s", paraSet->baseName, paraSet->fileExt); 
+    FILE *filePointer = fopen(paraSet->fileName, "w");
+    if (NULL == filePointer) {
+        FatalError("failed to open data file...");
+    }
+    const int *stride = paraSet->stride;
+    IntVec nodeCount = {0}; /* i, j, k node number in each part */
+    nodeCount[X] = (paraSet->range[X][MAX] - paraSet->range[X][MIN] - 1) / stride[X]; 
+    nodeCount[Y] = (paraSet->range[Y][MAX] - paraSet->range[Y][MIN] - 1) / stride[Y]; 
+    nodeCount[Z] = (paraSet->range[Z][MAX] - paraSet->range[Z][MIN] - 1) / stride[Z]; 
+    /*
+     * Pieces are slabs normal to the outermost dimension that has cells,
+     * which are contiguous in memory. Neighbouring pieces share their
+     * interface node plane to keep cells between pieces.
+     */
+    int split = Z;
+    while ((X < split) && (0 == nodeCount[split])) {
+        --split;
+    }
+    const int pieceN = PieceCount(nodeCount[split]);
+    fprintf(filePointer, "<?xml version=\"1.0\"?>\n");
+    fprintf(filePointer, "<VTKFile type=\"PStructuredGrid\" version=\"1.0\"\n");
+    fprintf(filePointer, "         byte_order=\"%s\">\n", paraSet->byteOrder);
+    fprintf(filePointer, "  <PStructuredGrid WholeExtent=\"%d %d %d %d %d %d\" GhostLevel=\"0\">\n", 
+            0, nodeCount[X], 0, nodeCount[Y], 0, nodeCount[Z]);
+    fprintf(filePointer, "    <PPointData>\n");
+    for (int count = 0; count < (VAROUT - 1); ++count) {
+        if (paraSet->var & (1 << count)) {
+            fprintf(filePointer, "      <PDataArray type=\"%s\" Name=\"%s\"/>\n", 
+                    paraSet->floatType, scalar[count]);
+        }
+    }
+    if (paraSet->var & (1 << (VAROUT - 1))) {
+        fprintf(filePointer, "      <PDataArray type=\"%s\" Name=\"Vel\" NumberOfComponents=\"3\"/>\n",
+                paraSet->floatType);
+    }
+    fprintf(filePointer, "    </PPointData>\n");
+    fprintf(filePointer, "    <PPoints>\n");
+    fprintf(filePointer, "      <PDataArray type=\"%s\" Name=\"points\" NumberOfComponents=\"3\"/>\n",
+            paraSet->floatType);
+    fprintf(filePointer, "    </PPoints>\n");
+    IntVec extent[LIMIT] = {{0}}; /* extent of a piece */
+    for (int p = 0; p < pieceN; ++p) {
+        extent[MAX][X] = nodeCount[X];
+        extent[MAX][Y] = nodeCount[Y];
+        extent[MAX][Z] = nodeCount[Z];
+        extent[MIN][split] = nodeCount[split] * p / pieceN;
+        extent[MAX][split] = nodeCount[split] * (p + 1) / pieceN;
+        fprintf(filePointer, "    <Piece Extent=\"%d %d %d %d %d %d\"\n", 
+                extent[MIN][X], extent[MAX][X], extent[MIN][Y], extent[MAX][Y], extent[MIN][Z], extent[MAX][Z]);
+        fprintf(filePointer, "           Source=\"%s_%03d.vts\"/>\n", paraSet->baseName, p);
+    }
+    fprintf(filePointer, "  </PStructuredGrid>\n");
+    fprintf(filePointer, "</VTKFile>\n");
+    fclose(filePointer); /* close current opened file */
+    /*
+     * Each piece is an independent file written by its own thread
+     */
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1)
+#endif
+    for (int p = 0; p < pieceN; ++p) {
+        ParaviewSet pieceSet = *paraSet;
+        int range[DIMS][LIMIT] = {{0}}; /* node range of the piece */
+        for (int s = 0; s < DIMS; ++s) {
+            range[s][MIN] = paraSet->range[s][MIN];
+            range[s][MAX] = paraSet->range[s][MAX];
+        }
+        range[split][MIN] = paraSet->range[split][MIN] + stride[split] * (nodeCount[split] * p / pieceN);
+        range[split][MAX] = paraSet->range[split][MIN] + stride[split] * (nodeCount[split] * (p + 1) / pieceN) + 1;
+        snprintf(pieceSet.baseName, sizeof(ParaviewString), "%.70s_%03d", paraSet->baseName, p % PIECEMAX); 
+        snprintf(pieceSet.fileExt, sizeof(ParaviewString), ".vts"); 
+        WriteStructuredData(range, space, model, &pieceSet);
+    }
+    return 0;
+}
+static int PieceCount(const int itemN)
+{
+    int pieceN = 1; /* one piece per thread */
+#ifdef _OPENMP
+    pieceN = omp_get_max_threads();
+#endif
+    return MaxInt(1, MinInt(MinInt(pieceN, PIECEMAX - 1), itemN));
+}
 int WritePolyDataParaview(const Time *time, const Geometry *geo)
 {
     if (0 != geo->sphN) {
@@ -234,6 +391,26 @@ int WritePolyDataParaview(const Time *time, const Geometry *geo)
     }
     return 0;
 }
+int WritePolyDataParaviewPieces(const Time *time, const Geometry *geo)
+{
+    if (0 != geo->sphN) {
+        PointPolyDataWriter(time, geo);
+    }
+    if (0 != geo->stlN) {
+        PolygonPolyDataPiecesWriter(time, geo);
+    }
+    return 0;
+}
+int WritePolyDataParaviewTransform(const Time *time, const Geometry *geo)
+{
+    if (0 != geo->sphN) {
+        PointPolyDataWriter(time, geo);
+    }
+    if (0 != geo->stlN) {
+        PolygonTransformWriter(time, geo);
+    }
+    return 0;
+}
 static int PointPolyDataWriter(const Time *time, const Geometry *geo)
 {
     ParaviewSet paraSet = { /* initialize environment */
@@ -415,6 +592,123 @@ static int WritePolygonPolyData(const int start, const int end, const Geometry *
     fclose(filePointer); /* close current opened file */
     return 0;
 }
+static int PolygonPolyDataPiecesWriter(const Time *time, const Geometry *geo)
+{
+    ParaviewSet paraSet = { /* initialize environment */
+        .rootName = "geo_stl", /* data file root name */
+        .baseName = {'\0'}, /* data file base name */
+        .fileName = {'\0'}, /* data file name */
+        .fileExt = ".pvtp", /* data file extension */
+        .intType = "Int32", /* paraview int type */
+        .floatType = "Float32", /* paraview float type */
+        .byteOrder = "LittleEndian" /* byte order of data */
+    };
+    snprintf(paraSet.baseName, sizeof(ParaviewString), "%s%05d", 
+            paraSet.rootName, time->writeC); 
+    if (0 == time->stepC) { /* this is the initialization step */
+        InitializeTransientCaseFile(&paraSet);
+    }
+    WriteCaseFile(time, &paraSet);
+    WritePolygonPieces(geo->sphN, geo->totN, geo, &paraSet);
+    return 0;
+}
+static int WritePolygonPieces(const int start, const int end, const Geometry *geo, ParaviewSet *paraSet)
+{
+    snprintf(paraSet->fileName, sizeof(ParaviewString), "%s%s", paraSet->baseName, paraSet->fileExt); 
+    FILE *filePointer = fopen(paraSet->fileName, "w");
+    if (NULL == filePointer) {
+        FatalError("failed to open data file...");
+    }
+    const int pieceN = PieceCount(end - start);
+    fprintf(filePointer, "<?xml version=\"1.0\"?>\n");
+    fprintf(filePointer, "<VTKFile type=\"PPolyData\" version=\"1.0\"\n");
+    fprintf(filePointer, "         byte_order=\"%s\">\n", paraSet->byteOrder);
+    fprintf(filePointer, "  <PPolyData GhostLevel=\"0\">\n");
+    fprintf(filePointer, "    <PPointData>\n");
+    fprintf(filePointer, "    </PPointData>\n");
+    fprintf(filePointer, "    <PPoints>\n");
+    fprintf(filePointer, "      <PDataArray type=\"%s\" Name=\"points\" NumberOfComponents=\"3\"/>\n",
+            paraSet->floatType);
+    fprintf(filePointer, "    </PPoints>\n");
+    for (int p = 0; p < pieceN; ++p) {
+        fprintf(filePointer, "    <Piece Source=\"%s_%03d.vtp\"/>\n", paraSet->baseName, p);
+    }
+    fprintf(filePointer, "  </PPolyData>\n");
+    fprintf(filePointer, "</VTKFile>\n");
+    /* polyhedron range of each piece */
+    fprintf(filePointer, "<!--\n");
+    for (int p = 0; p < pieceN; ++p) {
+        fprintf(filePointer, "  Piece %d %d\n", start + (end - start) * p / pieceN,
+                start + (end - start) * (p + 1) / pieceN);
+    }
+    fprintf(filePointer, "-->\n");
+    fclose(filePointer); /* close current opened file */
+    /*
+     * Each piece is an independent file written by its own thread
+     */
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1)
+#endif
+    for (int p = 0; p < pieceN; ++p) {
+        ParaviewSet pieceSet = *paraSet;
+        snprintf(pieceSet.baseName, sizeof(ParaviewString), "%.70s_%03d", paraSet->baseName, p % PIECEMAX); 
+        snprintf(pieceSet.fileExt, sizeof(ParaviewString), ".vtp"); 
+        WritePolygonPolyData(start + (end - start) * p / pieceN, 
+                start + (end - start) * (p + 1) / pieceN, geo, &pieceSet);
+    }
+    return 0;
+}
+static int PolygonTransformWriter(const Time *time, const Geometry *geo)
+{
+    ParaviewSet paraSet = { /* initialize environment */
+        .rootName = "geo_stl", /* data file root name */
+        .baseName = {'\0'}, /* data file base name */
+        .fileName = {'\0'}, /* data file name */
+        .fileExt = ".tf", /* data file extension */
+        .intType = "Int32", /* paraview int type */
+        .floatType = "Float32", /* paraview float type */
+        .byteOrder = "LittleEndian" /* byte order of data */
+    };
+    if (0 == time->stepC) { /* topology is written at the initialization step */
+        ParaviewSet topoSet = paraSet;
+        snprintf(topoSet.baseName, sizeof(ParaviewString), "%s_topo", paraSet.rootName); 
+        snprintf(topoSet.fileExt, sizeof(ParaviewString), ".vtp"); 
+        WritePolygonPolyData(geo->sphN, geo->totN, geo, &topoSet);
+    }
+    snprintf(paraSet.baseName, sizeof(ParaviewString), "%s%05d", 
+            paraSet.rootName, time->writeC); 
+    WritePolygonTransform(geo->sphN, geo->totN, time, geo, &paraSet);
+    return 0;
+}
+static int WritePolygonTransform(const int start, const int end, const Time *time, 
+        const Geometry *geo, ParaviewSet *paraSet)
+{
+    snprintf(paraSet->fileName, sizeof(ParaviewString), "%s%s", paraSet->baseName, paraSet->fileExt); 
+    FILE *filePointer = fopen(paraSet->fileName, "w");
+    if (NULL == filePointer) {
+        FatalError("failed to open data file...");
+    }
+    const char format[100] = "  %d, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g\n";
+    fprintf(filePointer, "# polyhedron transforms x = A x0 + b relative to %s_topo.vtp\n", paraSet->rootName);
+    fprintf(filePointer, "# time: %.6g, step: %d\n", time->now, time->stepC);
+    fprintf(filePointer, "# gid, A[X][X], A[X][Y], A[X][Z], b[X], A[Y][X], ..., b[Z]\n");
+    const Polyhedron *poly = NULL;
+    for (int n = start; n < end; ++n) {
+        poly = geo->poly + n;
+        if (1 == poly->state) { /* stationary object keeps the identity */
+            continue;
+        }
+        fprintf(filePointer, format, n + 1,
+                poly->tf[X][0], poly->tf[X][1], poly->tf[X][2], poly->tf[X][3],
+                poly->tf[Y][0], poly->tf[Y][1], poly->tf[Y][2], poly->tf[Y][3],
+                poly->tf[Z][0], poly->tf[Z][1], poly->tf[Z][2], poly->tf[Z][3]);
+    }
+    fprintf(filePointer, "<!--\n");
+    WritePolyhedronStateData(start, end, filePointer, geo);
+    fprintf(filePointer, "-->\n");
+    fclose(filePointer); /* close current opened file */
+    return 0;
+}
 int WritePolyhedronStateData(const int start, const int end, FILE *filePointer, const Geometry *geo)
 {
     const char formatI[100] = "  %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %d\n";
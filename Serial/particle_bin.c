@@ -0,0 +1,208 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include "particle_bin.h"
+#include <math.h> /* common mathematical functions */
+#include "cfd_commons.h"
+#include "commons.h"
+/****************************************************************************
+ * Static Function Declarations
+ ****************************************************************************/
+static void InitializeBin(const Partition *, Geometry *);
+static int CellSpace(const Real, const Real, const Real, const int);
+static int IsolationState(const int, const Partition *, const Geometry *);
+/****************************************************************************
+ * Function definitions
+ ****************************************************************************/
+void BinParticle(const Partition *part, Geometry *geo)
+{
+    Bin *bin = &(geo->bin);
+    IntVec c = {0}; /* cell space */
+    int idx = 0; /* linear array index math variable */
+    if (0 == geo->sphN) {
+        return;
+    }
+    if (NULL == bin->r) {
+        InitializeBin(part, geo);
+    }
+    /* gather sphere centroids into structure of arrays */
+    for (int m = 0; m < geo->sphN; ++m) {
+        bin->O[X][m] = geo->poly[m].O[X];
+        bin->O[Y][m] = geo->poly[m].O[Y];
+        bin->O[Z][m] = geo->poly[m].O[Z];
+    }
+    /* rebuild the cell list */
+    for (int n = 0; n < bin->cellN; ++n) {
+        bin->head[n] = NONE;
+    }
+    for (int m = 0; m < geo->sphN; ++m) {
+        for (int s = 0; s < DIMS; ++s) {
+            c[s] = CellSpace(bin->O[s][m], part->domain[s][MIN], bin->dd[s], bin->n[s]);
+        }
+        idx = IndexNode(c[Z], c[Y], c[X], bin->n[Y], bin->n[X]);
+        bin->next[m] = bin->head[idx];
+        bin->head[idx] = m;
+    }
+    for (int m = 0; m < geo->sphN; ++m) {
+        bin->iso[m] = IsolationState(m, part, geo);
+    }
+    return;
+}
+/*
+ * The reach covers the interfacial layers of the searching path with
+ * a safety margin. Cells are no smaller than the maximum diameter plus
+ * the reach, so any two spheres within reach are in neighbouring cells.
+ * Spheres outside the domain are clamped into boundary cells.
+ */
+static void InitializeBin(const Partition *part, Geometry *geo)
+{
+    Bin *bin = &(geo->bin);
+    const int sphN = geo->sphN;
+    const int cellMax = 8 * sphN + 64; /* limit of total number of cells */
+    Real rMax = 0.0;
+    Real dMax = 0.0;
+    Real size = 0.0; /* cell size */
+    for (int s = 0; s < DIMS; ++s) {
+        if (1 < part->ns[PIN][s][MAX] - part->ns[PIN][s][MIN]) { /* not a collapsed dimension */
+            dMax = MaxReal(dMax, part->d[s]);
+        }
+    }
+    for (int m = 0; m < sphN; ++m) {
+        rMax = MaxReal(rMax, geo->poly[m].r);
+    }
+    bin->reach = (part->gl + 2) * dMax;
+    size = 2.0 * rMax + bin->reach;
+    do {
+        bin->cellN = 1;
+        for (int s = 0; s < DIMS; ++s) {
+            bin->n[s] = MaxInt((int)((part->domain[s][MAX] - part->domain[s][MIN]) / size), 1);
+            bin->dd[s] = bin->n[s] / (part->domain[s][MAX] - part->domain[s][MIN]);
+            bin->cellN = bin->cellN * bin->n[s];
+        }
+        size = 2.0 * size;
+    } while (cellMax < bin->cellN);
+    for (int s = 0; s < DIMS; ++s) {
+        bin->O[s] = AssignArenaStorage(&(geo->arena), sphN * sizeof(*bin->O[s]));
+    }
+    bin->r = AssignArenaStorage(&(geo->arena), sphN * sizeof(*bin->r));
+    bin->iso = AssignArenaStorage(&(geo->arena), sphN * sizeof(*bin->iso));
+    bin->next = AssignArenaStorage(&(geo->arena), sphN * sizeof(*bin->next));
+    bin->head = AssignArenaStorage(&(geo->arena), bin->cellN * sizeof(*bin->head));
+    for (int m = 0; m < sphN; ++m) {
+        bin->r[m] = geo->poly[m].r;
+    }
+    return;
+}
+static int CellSpace(const Real s, const Real sMin, const Real dd, const int n)
+{
+    /* bounded before conversion, a NaN coordinate goes to the first cell */
+    return (int)MinReal(MaxReal(floor((s - sMin) * dd), 0.0), n - 1);
+}
+static int IsolationState(const int m, const Partition *part, const Geometry *geo)
+{
+    const Bin *bin = &(geo->bin);
+    const Polyhedron *poly = NULL;
+    const Real *restrict Ox = bin->O[X];
+    const Real *restrict Oy = bin->O[Y];
+    const Real *restrict Oz = bin->O[Z];
+    const Real *restrict r = bin->r;
+    const RealVec O = {Ox[m], Oy[m], Oz[m]};
+    int cell[DIMS][LIMIT] = {{0}}; /* neighbouring cells */
+    Real dist = 0.0;
+    Real reach = 0.0;
+    for (int s = 0; s < DIMS; ++s) {
+        cell[s][MIN] = MaxInt(CellSpace(O[s], part->domain[s][MIN], bin->dd[s], bin->n[s]) - 1, 0);
+        cell[s][MAX] = MinInt(CellSpace(O[s], part->domain[s][MIN], bin->dd[s], bin->n[s]) + 1, bin->n[s] - 1) + 1;
+    }
+    /* spheres in neighbouring cells */
+    for (int k = cell[Z][MIN]; k < cell[Z][MAX]; ++k) {
+        for (int j = cell[Y][MIN]; j < cell[Y][MAX]; ++j) {
+            for (int i = cell[X][MIN]; i < cell[X][MAX]; ++i) {
+                for (int q = bin->head[IndexNode(k, j, i, bin->n[Y], bin->n[X])]; NONE != q; q = bin->next[q]) {
+                    if (m == q) {
+                        continue;
+                    }
+                    dist = (Ox[q] - O[X]) * (Ox[q] - O[X]) + (Oy[q] - O[Y]) * (Oy[q] - O[Y]) +
+                        (Oz[q] - O[Z]) * (Oz[q] - O[Z]);
+                    reach = r[m] + r[q] + bin->reach;
+                    if (reach * reach > dist) {
+                        return 0;
+                    }
+                }
+            }
+        }
+    }
+    /* bounding boxes of triangulated polyhedrons */
+    reach = r[m] + bin->reach;
+    for (int n = geo->sphN; n < geo->totN; ++n) {
+        poly = geo->poly + n;
+        if ((O[X] - reach < poly->box[X][MAX]) && (O[X] + reach > poly->box[X][MIN]) &&
+                (O[Y] - reach < poly->box[Y][MAX]) && (O[Y] + reach > poly->box[Y][MIN]) &&
+                (O[Z] - reach < poly->box[Z][MAX]) && (O[Z] + reach > poly->box[Z][MIN])) {
+            return 0;
+        }
+    }
+    return 1;
+}
+int IsolatedGeometry(const int n, const Geometry *geo)
+{
+    if ((geo->sphN <= n) || (NULL == geo->bin.iso)) {
+        return 0;
+    }
+    return geo->bin.iso[n];
+}
+/*
+ * Row coordinates are transformed into node space, where the node index
+ * equals the coordinate. Ranges are enlarged by one node on each side to
+ * be robust to round-off errors, the exact test is left to the caller.
+ * Node space coordinates are bounded around the box before the integer
+ * conversion, which leaves the spans unchanged.
+ */
+int NodeRowSpan(const int k, const int j, const int shell, const int n, const Geometry *geo,
+        int box[restrict][LIMIT], const Partition *part, int span[restrict][LIMIT])
+{
+    const Polyhedron *poly = geo->poly + n;
+    span[0][MIN] = box[X][MIN];
+    span[0][MAX] = box[X][MAX];
+    if (0 != poly->faceN) { /* triangulated polyhedron */
+        return 1;
+    }
+    const Real y = PointSpace(j, part->domain[Y][MIN], part->d[Y], part->ng) - poly->O[Y];
+    const Real z = PointSpace(k, part->domain[Z][MIN], part->d[Z], part->ng) - poly->O[Z];
+    const Real rho2 = y * y + z * z; /* distance square to the axis of the row */
+    const Real x = (poly->O[X] - part->domain[X][MIN]) * part->dd[X] + part->ng;
+    const Real rIn = poly->r - geo->bin.reach;
+    Real w = poly->r * poly->r - rho2; /* half chord square */
+    if (0.0 > w) {
+        return 0;
+    }
+    w = sqrt(w) * part->dd[X];
+    const Real lo = box[X][MIN] - 2; /* lower bound of node space */
+    const Real hi = box[X][MAX] + 2; /* upper bound of node space */
+    span[0][MIN] = MaxInt((int)MinReal(MaxReal(floor(x - w), lo), hi) - 1, box[X][MIN]);
+    span[0][MAX] = MinInt((int)MinReal(MaxReal(ceil(x + w), lo), hi) + 2, box[X][MAX]);
+    if ((0 == shell) || (0.0 >= rIn) || (rIn * rIn <= rho2) || (0 == IsolatedGeometry(n, geo))) {
+        return 1;
+    }
+    w = sqrt(rIn * rIn - rho2) * part->dd[X];
+    const int iMin = (int)MinReal(MaxReal(ceil(x - w), lo), hi) + 1; /* first excluded node */
+    const int iMax = (int)MinReal(MaxReal(floor(x + w), lo), hi); /* end of excluded nodes */
+    if (iMin >= iMax) {
+        return 1;
+    }
+    span[1][MIN] = MaxInt(iMax, span[0][MIN]);
+    span[1][MAX] = span[0][MAX];
+    span[0][MAX] = MinInt(iMin, span[0][MAX]);
+    return 2;
+}
+/* a good practice: end file with a newline */
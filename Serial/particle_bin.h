@@ -0,0 +1,56 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Header File Guards to Avoid Interdependence
+ ****************************************************************************/
+#ifndef ARTRACFD_PARTICLE_BIN_H_ /* if this is the first definition */
+#define ARTRACFD_PARTICLE_BIN_H_ /* a unique marker for this header file */
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+/****************************************************************************
+ * Public Functions Declaration
+ ****************************************************************************/
+/*
+ * Bin particles
+ *
+ * Function
+ *      Gather analytical spheres into structure of arrays, bin them into
+ *      the uniform cell list, and determine the isolation state of each
+ *      sphere by searching neighbouring cells and triangulated polyhedrons.
+ */
+extern void BinParticle(const Partition *, Geometry *);
+/*
+ * Isolated geometry
+ *
+ * Function
+ *      Return 1 if the geometry is an analytical sphere that has no other
+ *      geometry within the interaction reach, otherwise return 0.
+ */
+extern int IsolatedGeometry(const int n, const Geometry *);
+/*
+ * Node row span
+ *
+ * Function
+ *      Determine the node ranges of row (k, j) in the bounding box that
+ *      need to be scanned for geometry n, and return the number of ranges.
+ *      For analytical sphere, ranges are restricted to the nodes covered by
+ *      the sphere. If shell is set and the sphere is isolated, the nodes that
+ *      are deeper than the interaction reach are excluded as well.
+ */
+extern int NodeRowSpan(const int k, const int j, const int shell, const int n, const Geometry *,
+        int box[restrict][LIMIT], const Partition *, int span[restrict][LIMIT]);
+#endif
+/* a good practice: end file with a newline */
@@ -0,0 +1,236 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#if defined(PERFCOUNT) && defined(__linux__)
+#define _GNU_SOURCE /* system call interface */
+#endif
+#include "perf_counter.h"
+#include <stdio.h> /* standard library for input and output */
+#include <string.h> /* manipulating strings */
+#include "timer.h"
+#if defined(PERFCOUNT) && defined(__linux__)
+#include <stdint.h> /* fixed width integer types */
+#include <errno.h> /* error numbers */
+#include <unistd.h> /* system call and file descriptor */
+#include <sys/ioctl.h> /* device control */
+#include <sys/syscall.h> /* system call numbers */
+#include <linux/perf_event.h> /* performance event interface */
+#endif
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+typedef enum {
+    CYCLES = 0, /* core cycles */
+    INSTRUCTIONS = 1, /* retired instructions */
+    LLCREF = 2, /* last level cache references */
+    LLCMISS = 3, /* last level cache misses */
+    FPSCALAR = 4, /* scalar double precision arithmetic */
+    FPPACKED2 = 5, /* 128 bits packed double precision arithmetic */
+    FPPACKED4 = 6, /* 256 bits packed double precision arithmetic */
+    COUNTERN = 7, /* number of counters */
+    LINEBYTE = 64, /* bytes of a cache line */
+} CounterConstants;
+/*
+ * Phase record
+ */
+typedef struct {
+    long callN; /* number of calls */
+    double time; /* accumulated wall time */
+    double count[COUNTERN]; /* accumulated counts */
+    double start[COUNTERN]; /* counts at the start */
+    Timer timer; /* wall time at the start */
+} PhaseRecord;
+/****************************************************************************
+ * Static Function Declarations
+ ****************************************************************************/
+#if defined(PERFCOUNT) && defined(__linux__)
+static int OpenCounter(const unsigned int, const unsigned long long);
+static int IntelProcessor(void);
+static double ReadCounter(const int);
+#endif
+static void ReadCounters(double [restrict]);
+static void PrintRatio(const double, const double, const int);
+/****************************************************************************
+ * Global Variables Definition with Private Scope
+ ****************************************************************************/
+static const char *phaseName[PHASEN] = {
+    "step", "solid", "fluid", "output", "sweep x", "sweep y", "sweep z"};
+static const double fpWidth[COUNTERN] = {0.0, 0.0, 0.0, 0.0, 1.0, 2.0, 4.0};
+static int openState = 0; /* whether counters have been opened */
+static int fd[COUNTERN] = {-1, -1, -1, -1, -1, -1, -1}; /* counter file descriptors */
+static PhaseRecord record[PHASEN];
+/****************************************************************************
+ * Function definitions
+ ****************************************************************************/
+/*
+ * Counters are opened for the calling thread on any processor, user space
+ * only, so they can be opened with the default paranoid level. Each counter
+ * is opened separately, and counts are scaled by the running fraction in
+ * case that the kernel multiplexes counters.
+ * Floating point operations use the raw FP_ARITH_INST_RETIRED events of
+ * Intel processors, which have no generic equivalent. Other processors
+ * report them as unavailable.
+ */
+void OpenCounters(void)
+{
+#if defined(PERFCOUNT) && defined(__linux__)
+    memset(record, 0, sizeof(record));
+    openState = 1;
+    fd[CYCLES] = OpenCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    if (0 > fd[CYCLES]) {
+        fprintf(stdout, "  performance counters unavailable: %s\n", strerror(errno));
+    }
+    fd[INSTRUCTIONS] = OpenCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    fd[LLCREF] = OpenCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES);
+    fd[LLCMISS] = OpenCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    if (0 != IntelProcessor()) {
+        fd[FPSCALAR] = OpenCounter(PERF_TYPE_RAW, 0x01C7);
+        fd[FPPACKED2] = OpenCounter(PERF_TYPE_RAW, 0x04C7);
+        fd[FPPACKED4] = OpenCounter(PERF_TYPE_RAW, 0x10C7);
+    }
+#endif
+    return;
+}
+void StartCounters(const int phase)
+{
+    if (0 == openState) {
+        return;
+    }
+    ReadCounters(record[phase].start);
+    TickTime(&(record[phase].timer));
+    return;
+}
+void StopCounters(const int phase)
+{
+    if (0 == openState) {
+        return;
+    }
+    PhaseRecord *rec = record + phase;
+    double now[COUNTERN] = {0.0};
+    rec->time = rec->time + TockTime(&(rec->timer));
+    ReadCounters(now);
+    for (int n = 0; n < COUNTERN; ++n) {
+        rec->count[n] = rec->count[n] + now[n] - rec->start[n];
+    }
+    ++(rec->callN);
+    return;
+}
+/*
+ * Arithmetic intensity is estimated by the floating point operations per
+ * byte of last level cache miss traffic, with one cache line per miss.
+ */
+void ReportCounters(void)
+{
+    if (0 == openState) {
+        return;
+    }
+    fprintf(stdout, "  performance counters:\n");
+    fprintf(stdout, "  %-8s %10s %12s %10s %10s %10s %10s\n",
+            "phase", "calls", "time", "IPC", "LLC miss", "GFLOP/s", "flop/byte");
+    for (int p = 0; p < PHASEN; ++p) {
+        const PhaseRecord *rec = record + p;
+        if (0 == rec->callN) {
+            continue;
+        }
+        double flop = 0.0;
+        int fpState = 0;
+        for (int n = FPSCALAR; n <= FPPACKED4; ++n) {
+            if (0 <= fd[n]) {
+                flop = flop + fpWidth[n] * rec->count[n];
+                fpState = 1;
+            }
+        }
+        fprintf(stdout, "  %-8s %10ld %12.6g", phaseName[p], rec->callN, rec->time);
+        PrintRatio(rec->count[INSTRUCTIONS], rec->count[CYCLES], (0 <= fd[INSTRUCTIONS]) && (0 <= fd[CYCLES]));
+        PrintRatio(rec->count[LLCMISS], rec->count[LLCREF], (0 <= fd[LLCMISS]) && (0 <= fd[LLCREF]));
+        PrintRatio(flop * 1.0e-9, rec->time, fpState);
+        PrintRatio(flop, rec->count[LLCMISS] * LINEBYTE, fpState && (0 <= fd[LLCMISS]));
+        fprintf(stdout, "\n");
+    }
+#if defined(PERFCOUNT) && defined(__linux__)
+    for (int n = 0; n < COUNTERN; ++n) {
+        if (0 <= fd[n]) {
+            close(fd[n]);
+        }
+        fd[n] = -1;
+    }
+#endif
+    openState = 0;
+    return;
+}
+static void PrintRatio(const double num, const double den, const int state)
+{
+    if ((0 == state) || (0.0 >= den)) {
+        fprintf(stdout, " %10s", "n/a");
+        return;
+    }
+    fprintf(stdout, " %10.4g", num / den);
+    return;
+}
+static void ReadCounters(double count[restrict])
+{
+#if defined(PERFCOUNT) && defined(__linux__)
+    for (int n = 0; n < COUNTERN; ++n) {
+        count[n] = ReadCounter(fd[n]);
+    }
+#else
+    memset(count, 0, COUNTERN * sizeof(*count));
+#endif
+    return;
+}
+#if defined(PERFCOUNT) && defined(__linux__)
+static int OpenCounter(const unsigned int type, const unsigned long long config)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    const int id = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+    if (0 > id) {
+        return -1;
+    }
+    ioctl(id, PERF_EVENT_IOC_RESET, 0);
+    ioctl(id, PERF_EVENT_IOC_ENABLE, 0);
+    return id;
+}
+static double ReadCounter(const int id)
+{
+    uint64_t value[3] = {0}; /* count, time enabled, time running */
+    if ((0 > id) || (sizeof(value) != read(id, value, sizeof(value))) || (0 == value[2])) {
+        return 0.0;
+    }
+    return (double)value[0] * ((double)value[1] / (double)value[2]);
+}
+static int IntelProcessor(void)
+{
+    char str[200] = {'\0'};
+    int state = 0;
+    FILE *filePointer = fopen("/proc/cpuinfo", "r");
+    if (NULL == filePointer) {
+        return 0;
+    }
+    while (NULL != fgets(str, sizeof(str), filePointer)) {
+        if (0 == strncmp(str, "vendor_id", strlen("vendor_id"))) {
+            state = (NULL != strstr(str, "GenuineIntel"));
+            break;
+        }
+    }
+    fclose(filePointer);
+    return state;
+}
+#endif
+/* a good practice: end file with a newline */
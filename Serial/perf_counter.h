@@ -0,0 +1,58 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Header File Guards to Avoid Interdependence
+ ****************************************************************************/
+#ifndef ARTRACFD_PERF_COUNTER_H_ /* if this is the first definition */
+#define ARTRACFD_PERF_COUNTER_H_ /* a unique marker for this header file */
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+/*
+ * Instrumented phases
+ */
+typedef enum {
+    PHASESTEP = 0, /* time step computation */
+    PHASESOLID = 1, /* solid dynamics */
+    PHASEFLUID = 2, /* fluid dynamics */
+    PHASEOUTPUT = 3, /* data output */
+    PHASESWEEPX = 4, /* spatial operator sweep in x direction */
+    PHASESWEEPY = 5, /* spatial operator sweep in y direction */
+    PHASESWEEPZ = 6, /* spatial operator sweep in z direction */
+    PHASEN = 7, /* number of phases */
+} CounterPhase;
+/****************************************************************************
+ * Public Functions Declaration
+ ****************************************************************************/
+/*
+ * Hardware performance counters
+ *
+ * Function
+ *      Open cycles, instructions, last level cache references and misses,
+ *      and floating point operation counters of the calling thread through
+ *      Linux perf_event_open. Counters are only compiled in when the program
+ *      is built with PERFCOUNT defined, otherwise all calls do nothing.
+ *      Counters that cannot be opened are reported as unavailable, and the
+ *      program runs as usual.
+ *      Start and stop accumulate counts and wall time of a phase, phases
+ *      may be nested.
+ *      Report prints the accumulated counts with derived ratios of each
+ *      phase and closes the counters.
+ */
+extern void OpenCounters(void);
+extern void StartCounters(const int phase);
+extern void StopCounters(const int phase);
+extern void ReportCounters(void);
+#endif
+/* a good practice: end file with a newline */
@@ -14,6 +14,11 @@
 #include "postprocess.h"
 #include <stdio.h> /* standard library for input and output */
 #include <stdlib.h> /* dynamic memory allocation and exit */
+#include "domain_partition.h"
+#include "primitive_cache.h"
+#include "statistics.h"
+#include "residual.h"
+#include "immersed_boundary.h"
 #include "commons.h"
 /****************************************************************************
  * Static Function Declarations
@@ -35,23 +40,20 @@ static int ProgramMemoryRelease(Time *time, Space *space)
 {
     /* geometry related */
     Geometry *geo = &(space->geo);
-    Polyhedron *poly = NULL;
-    for (int n = geo->sphN; n < geo->totN; ++n) {
-        poly = geo->poly + n;
-        RetrieveStorage(poly->f);
-        RetrieveStorage(poly->Nf);
-        RetrieveStorage(poly->e);
-        RetrieveStorage(poly->Ne);
-        RetrieveStorage(poly->v);
-        RetrieveStorage(poly->Nv);
-    }
+    RetrieveArenaStorage(&(geo->arena));
     RetrieveStorage(geo->poly);
     RetrieveStorage(geo->col);
+    ReleaseGeometryDomain(space);
     /* field variable related */
     RetrieveStorage(space->node);
+    ReleasePrimitiveCache(space);
+    ReleaseStatistics(space);
+    ReleaseResidualMonitor(space);
+    ReleaseDomainPartition(space);
     /* time related */
-    RetrieveStorage(time->lp);
-    RetrieveStorage(time->pp);
+    RetrieveArenaStorage(&(time->arena));
+    time->lp = NULL;
+    time->pp = NULL;
     return 0;
 }
 /* a good practice: end file with a newline */
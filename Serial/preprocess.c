@@ -17,11 +17,12 @@
 #include "case_loader.h"
 #include "cfd_parameters.h"
 #include "domain_partition.h"
+#include "primitive_cache.h"
 #include "commons.h"
 /****************************************************************************
  * Static Function Declarations
  ****************************************************************************/
-static int ProgramMemoryAllocate(Space *);
+static int ProgramMemoryAllocate(Space *, const Model *);
 /****************************************************************************
  * Function Definitions
  ****************************************************************************/
@@ -39,7 +40,7 @@ int Preprocess(Time *time, Space *space, Model *model)
     fprintf(stdout, "  partitioning domain...\n");
     DomainPartition(space);
     fprintf(stdout, "  allocating memory...\n");
-    ProgramMemoryAllocate(space);
+    ProgramMemoryAllocate(space, model);
     ShowInformation("Session End");
     return 0;
 }
@@ -47,12 +48,13 @@ int Preprocess(Time *time, Space *space, Model *model)
  * This function allocates memory for field data. The storage retrieving
  * need to be done in the postprocessor.
  */
-static int ProgramMemoryAllocate(Space *space)
+static int ProgramMemoryAllocate(Space *space, const Model *model)
 {
     Partition *part = &(space->part);
     Geometry *geo = &(space->geo);
     const int totN = part->n[X] * part->n[Y] * part->n[Z];
     space->node = AssignStorage(totN * sizeof(*space->node));
+    AllocatePrimitiveCache(space, model);
     if (0 != geo->totN) {
         geo->col = AssignStorage(geo->totN * sizeof(*geo->col));
         geo->poly = AssignStorage(geo->totN * sizeof(*geo->poly));
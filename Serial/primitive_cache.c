@@ -0,0 +1,135 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include "primitive_cache.h"
+#include "cfd_commons.h"
+#include "commons.h"
+/****************************************************************************
+ * Static Function Declarations
+ ****************************************************************************/
+static void CacheNode(const int, const Real [restrict], Cache *, const Model *);
+/****************************************************************************
+ * Function definitions
+ ****************************************************************************/
+void AllocatePrimitiveCache(Space *space, const Model *model)
+{
+    const Partition *restrict part = &(space->part);
+    Cache *cache = &(space->cache);
+    const int totN = part->n[X] * part->n[Y] * part->n[Z];
+    cache->tn = NONE;
+    if (0 < model->cache) {
+        cache->V = AssignStorage(totN * sizeof(*cache->V));
+    }
+    if (1 < model->cache) {
+        cache->P = AssignStorage(totN * sizeof(*cache->P));
+    }
+    return;
+}
+void ReleasePrimitiveCache(Space *space)
+{
+    Cache *cache = &(space->cache);
+    RetrieveStorage(cache->V);
+    RetrieveStorage(cache->P);
+    cache->V = NULL;
+    cache->P = NULL;
+    cache->tn = NONE;
+    return;
+}
+void CachePrimitive(const int tn, const int region, Space *space, const Model *model)
+{
+    Cache *cache = &(space->cache);
+    if (NULL == cache->V) {
+        return;
+    }
+    const Partition *restrict part = &(space->part);
+    const Node *const node = space->node;
+    const int fluid = (CACHEFLUID == region);
+    int idx = 0; /* linear array index math variable */
+    for (int k = part->ns[PIN][Z][MIN]; k < part->ns[PIN][Z][MAX]; ++k) {
+        for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
+            for (int i = part->ns[PIN][X][MIN]; i < part->ns[PIN][X][MAX]; ++i) {
+                idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                if (fluid != (0 == node[idx].gid)) {
+                    continue;
+                }
+                CacheNode(idx, node[idx].U[tn], cache, model);
+            }
+        }
+    }
+    if (fluid) {
+        cache->tn = tn;
+    }
+    return;
+}
+void CacheBoxPrimitive(const int tn, const int box[restrict][LIMIT], Space *space, const Model *model)
+{
+    Cache *cache = &(space->cache);
+    if (NULL == cache->V) {
+        return;
+    }
+    const Partition *restrict part = &(space->part);
+    const Node *const node = space->node;
+    int idx = 0; /* linear array index math variable */
+    for (int k = box[Z][MIN]; k < box[Z][MAX]; ++k) {
+        for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
+            for (int i = box[X][MIN]; i < box[X][MAX]; ++i) {
+                idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                CacheNode(idx, node[idx].U[tn], cache, model);
+            }
+        }
+    }
+    return;
+}
+/*
+ * The cached values are computed by the same expressions as the ones used
+ * by the readers without cache, hence results do not depend on the cache.
+ */
+static void CacheNode(const int idx, const Real U[restrict], Cache *cache, const Model *model)
+{
+    Real *restrict V = cache->V[idx];
+    V[0] = U[1] / U[0];
+    V[1] = U[2] / U[0];
+    V[2] = U[3] / U[0];
+    V[3] = ComputeTemperature(model->cv, U);
+    if (NULL != cache->P) {
+        cache->P[idx][0] = U[0];
+        cache->P[idx][1] = ComputePressure(model->gamma, U);
+    }
+    return;
+}
+int CacheState(const int tn, const Cache *cache)
+{
+    if ((NULL == cache->V) || (tn != cache->tn)) {
+        return 0;
+    }
+    if (NULL == cache->P) {
+        return 1;
+    }
+    return 2;
+}
+void NodePrimitive(const int tn, const int idx, const Node *const node,
+        const Cache *cache, const Model *model, Real Uo[restrict])
+{
+    if (2 != CacheState(tn, cache)) {
+        PrimitiveByConservative(model->gamma, model->gasR, node[idx].U[tn], Uo);
+        return;
+    }
+    Uo[0] = cache->P[idx][0];
+    Uo[1] = cache->V[idx][0];
+    Uo[2] = cache->V[idx][1];
+    Uo[3] = cache->V[idx][2];
+    Uo[4] = cache->P[idx][1];
+    Uo[5] = Uo[4] / (Uo[0] * model->gasR);
+    return;
+}
+/* a good practice: end file with a newline */
@@ -0,0 +1,78 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Header File Guards to Avoid Interdependence
+ ****************************************************************************/
+#ifndef ARTRACFD_PRIMITIVE_CACHE_H_ /* if this is the first definition */
+#define ARTRACFD_PRIMITIVE_CACHE_H_ /* a unique marker for this header file */
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+/*
+ * Node regions filled separately
+ */
+typedef enum {
+    CACHEFLUID = 0, /* fluid nodes */
+    CACHESOLID = 1, /* nodes of geometries */
+} CacheRegion;
+/****************************************************************************
+ * Public Functions Declaration
+ ****************************************************************************/
+/*
+ * Primitive cache storage
+ *
+ * Function
+ *      Allocate the primitive cache of a space according to the cache
+ *      level of the model: 0 for no cache, 1 for velocity and temperature,
+ *      2 for all primitives. Release is safe for a space without cache.
+ */
+extern void AllocatePrimitiveCache(Space *, const Model *);
+extern void ReleasePrimitiveCache(Space *);
+/*
+ * Fill primitive cache
+ *
+ * Function
+ *      Convert the field data of time level tn into the primitive cache.
+ *      Fluid nodes of the inner region are filled before the immersed
+ *      boundary treatment, which only reads fluid nodes through the cache,
+ *      and the cache holds time level tn from then on. Nodes of geometries
+ *      are filled after the immersed boundary treatment. Nodes of the
+ *      boundary layer and the first ghost layer are filled box by box after
+ *      the domain boundary treatment of each box, outer ghost layers are
+ *      not cached.
+ *      Do nothing if the space has no cache.
+ */
+extern void CachePrimitive(const int tn, const int region, Space *, const Model *);
+extern void CacheBoxPrimitive(const int tn, const int box[restrict][LIMIT], Space *, const Model *);
+/*
+ * Cache state
+ *
+ * Function
+ *      Return 0 if time level tn is not cached, 1 if velocity and
+ *      temperature are cached, 2 if all primitives are cached.
+ */
+extern int CacheState(const int tn, const Cache *);
+/*
+ * Node primitive
+ *
+ * Function
+ *      Get the primitive vector of a node at time level tn from the cache
+ *      if all primitives are cached, otherwise convert the field data. The
+ *      result is identical to PrimitiveByConservative.
+ */
+extern void NodePrimitive(const int tn, const int idx, const Node *const node,
+        const Cache *, const Model *, Real Uo[restrict]);
+#endif
+/* a good practice: end file with a newline */
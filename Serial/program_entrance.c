@@ -17,6 +17,10 @@
 #include <string.h> /* manipulating strings */
 #include "calculator.h"
 #include "case_generator.h"
+#include "benchmark.h"
+#include "parameter_sweep.h"
+#include "compressed.h"
+#include "trace.h"
 #include "commons.h"
 /****************************************************************************
  * Static Function Declarations
@@ -40,7 +44,7 @@ int ProgramEntrance(int argc, char *argv[], Control *control)
         }
         switch (argv[1][1]) { /* argv[1][1] is the actual option character */
             /*
-             * run mode: -m [interact], [serial], [threaded], [mpi], [gpu]
+             * run mode: -m [interact], [serial], [threaded], [mpi], [gpu], [bench], [sweep], [convert]
              */
             case 'm':
                 ++argv;
@@ -65,6 +69,18 @@ int ProgramEntrance(int argc, char *argv[], Control *control)
                     control->runMode = 'g';
                     break;
                 }
+                if (0 == strcmp(argv[1], "bench")) {
+                    control->runMode = 'b';
+                    break;
+                }
+                if (0 == strcmp(argv[1], "sweep")) {
+                    control->runMode = 'w';
+                    break;
+                }
+                if (0 == strcmp(argv[1], "convert")) {
+                    control->runMode = 'c';
+                    break;
+                }
                 fprintf(stderr,"error, bad option %s\n", argv[1]);
                 exit(EXIT_FAILURE);
                 /*
@@ -76,6 +92,14 @@ int ProgramEntrance(int argc, char *argv[], Control *control)
                 nscan = sscanf(argv[1], "%d", &(control->procN));
                 VerifyReadConversion(nscan, 1);
                 break;
+                /*
+                 * execution trace: -t file
+                 */
+            case 't':
+                ++argv;
+                --argc;
+                control->trace = argv[1];
+                break;
             default: 
                 fprintf(stderr,"error, bad option %s\n", argv[1]);
                 exit(EXIT_FAILURE);
@@ -101,6 +125,10 @@ int ProgramEntrance(int argc, char *argv[], Control *control)
 }
 static int ConfigureProgram(Control *control)
 {
+    if (NULL != control->trace) {
+        OpenTrace(control->trace);
+    }
+    int status = NONE; /* exit status of modes completed here */
     switch (control->runMode) {
         case 'i': /* interaction mode */
             Preamble(control);
@@ -113,9 +141,25 @@ static int ConfigureProgram(Control *control)
             break;
         case 'g': /* gpu mode */
             break;
+        case 'b': /* benchmark mode */
+            Benchmark();
+            status = EXIT_SUCCESS;
+            break;
+        case 'w': /* parameter sweep mode */
+            status = (0 != ParameterSweep(control->procN)) ? EXIT_FAILURE : EXIT_SUCCESS;
+            break;
+        case 'c': /* quantized data conversion mode */
+            ConvertCompressedData();
+            status = EXIT_SUCCESS;
+            break;
         default:
             break;
     }
+    /* modes completed here write the trace, solving modes write it in Solve */
+    if (NONE != status) {
+        CloseTrace();
+        exit(status);
+    }
     return 0;
 }
 static int Preamble(Control *control)
@@ -176,12 +220,15 @@ static int ProgramManual(void)
 {
     fprintf(stdout, "\n            ArtraCFD User Manual\n\n");
     fprintf(stdout, "SYSNOPSIS:\n");
-    fprintf(stdout, "        artracfd [-m runmode] [-n nprocessors]\n");
+    fprintf(stdout, "        artracfd [-m runmode] [-n nprocessors] [-t tracefile]\n");
     fprintf(stdout, "OPTIONS:\n");
-    fprintf(stdout, "        -m runmode        run mode: interact, serial, threaded, mpi, gpu\n");
-    fprintf(stdout, "        -n nprocessors    number of processors\n");
+    fprintf(stdout, "        -m runmode        run mode: interact, serial, threaded, mpi, gpu, bench, sweep, convert\n");
+    fprintf(stdout, "        -n nprocessors    number of processors, concurrent variants of sweep\n");
+    fprintf(stdout, "        -t tracefile      write execution trace in Chrome trace event format\n");
     fprintf(stdout, "NOTES:\n");
     fprintf(stdout, "        default run mode is 'interact'\n");
+    fprintf(stdout, "        'sweep' runs the variants specified in artracfd.sweep\n");
+    fprintf(stdout, "        'convert' converts quantized field data to ParaView data\n");
     return 0;
 }
 /* a good practice: end file with a newline */
@@ -0,0 +1,376 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include "quantizer.h"
+#include <stdlib.h> /* dynamic memory allocation and exit */
+#include <string.h> /* manipulating strings */
+#include <stdint.h> /* fixed width integer types */
+#include <math.h> /* common mathematical functions */
+#include <limits.h> /* sizes of integral types */
+#include "cfd_commons.h"
+#include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+typedef struct {
+    int w; /* weight */
+    int sym; /* symbol */
+} Leaf;
+/****************************************************************************
+ * Static Function Declarations
+ ****************************************************************************/
+static Real LorenzoPredictor(const Real *, const int [DIMS], const int, const int, const int);
+static int CompareLeaf(const void *, const void *);
+static int HuffmanCodeLength(const int *, unsigned char *);
+static void CanonicalCode(const unsigned char *, uint64_t *);
+static int PutVarint(unsigned char *, unsigned int);
+/****************************************************************************
+ * Function definitions
+ ****************************************************************************/
+/*
+ * Stream layout: number of used codes, number of unpredictable values,
+ * code table of (code increment as varint, code length) in ascending code
+ * order, unpredictable values as double, and the Huffman bit stream.
+ */
+unsigned char *EncodeQuantizedBlock(const Real *data, const int n[DIMS], const Real eb, int *size)
+{
+    const int valueN = n[X] * n[Y] * n[Z];
+    const int half = QUANTN / 2;
+    Real *rec = AssignStorage(valueN * sizeof(*rec)); /* decoded values */
+    int *code = AssignStorage(valueN * sizeof(*code)); /* quantization codes */
+    int *freq = AssignStorage(QUANTN * sizeof(*freq)); /* code histogram */
+    int outN = 0; /* number of unpredictable values */
+    for (int k = 0, idx = 0; k < n[Z]; ++k) {
+        for (int j = 0; j < n[Y]; ++j) {
+            for (int i = 0; i < n[X]; ++i, ++idx) {
+                const Real pred = LorenzoPredictor(rec, n, k, j, i);
+                const Real q = (data[idx] - pred) / (2.0 * eb);
+                if (fabs(q) < half - 1) {
+                    const int c = (int)floor(q + 0.5);
+                    rec[idx] = pred + 2.0 * eb * c;
+                    if (fabs(rec[idx] - data[idx]) <= eb) {
+                        code[idx] = c + half;
+                    }
+                }
+                if (0 == code[idx]) {
+                    rec[idx] = data[idx];
+                    ++outN;
+                }
+                ++freq[code[idx]];
+            }
+        }
+    }
+    unsigned char *len = AssignStorage(QUANTN * sizeof(*len));
+    uint64_t *word = AssignStorage(QUANTN * sizeof(*word));
+    const int symN = HuffmanCodeLength(freq, len);
+    CanonicalCode(len, word);
+    size_t bitN = 0;
+    for (int s = 0; s < QUANTN; ++s) {
+        bitN += (size_t)freq[s] * len[s];
+    }
+    const size_t capacity = 2 * sizeof(int) + (size_t)symN * 4 + (size_t)outN * sizeof(double) + (bitN + 7) / 8;
+    if (INT_MAX < capacity) {
+        FatalError("quantized block exceeds the size limit...");
+    }
+    unsigned char *stream = AssignStorage(capacity);
+    size_t at = 0; /* stream position */
+    memcpy(stream + at, &symN, sizeof(int));
+    at += sizeof(int);
+    memcpy(stream + at, &outN, sizeof(int));
+    at += sizeof(int);
+    for (int s = 0, last = 0; s < QUANTN; ++s) {
+        if (0 == freq[s]) {
+            continue;
+        }
+        at += PutVarint(stream + at, s - last);
+        stream[at] = len[s];
+        ++at;
+        last = s;
+    }
+    for (int idx = 0; idx < valueN; ++idx) {
+        if (0 == code[idx]) {
+            const double value = data[idx];
+            memcpy(stream + at, &value, sizeof(double));
+            at += sizeof(double);
+        }
+    }
+    /* codes are packed most significant bit first */
+    uint64_t acc = 0; /* bit accumulator */
+    int accN = 0; /* number of pending bits in the accumulator */
+    for (int idx = 0; idx < valueN; ++idx) {
+        const int L = len[code[idx]];
+        if (0 == L) {
+            continue;
+        }
+        acc = (acc << L) | word[code[idx]];
+        accN += L;
+        while (8 <= accN) {
+            accN -= 8;
+            stream[at] = (unsigned char)(acc >> accN);
+            ++at;
+        }
+    }
+    if (0 < accN) {
+        stream[at] = (unsigned char)(acc << (8 - accN));
+        ++at;
+    }
+    *size = (int)at;
+    RetrieveStorage(rec);
+    RetrieveStorage(code);
+    RetrieveStorage(freq);
+    RetrieveStorage(len);
+    RetrieveStorage(word);
+    return stream;
+}
+int DecodeQuantizedBlock(const unsigned char *stream, const int size, const int n[DIMS],
+        const Real eb, Real *data)
+{
+    const int valueN = n[X] * n[Y] * n[Z];
+    const int half = QUANTN / 2;
+    int symN = 0; /* number of used codes */
+    int outN = 0; /* number of unpredictable values */
+    size_t at = 0; /* stream position */
+    if ((int)(2 * sizeof(int)) > size) {
+        FatalError("corrupted quantized data...");
+    }
+    memcpy(&symN, stream + at, sizeof(int));
+    at += sizeof(int);
+    memcpy(&outN, stream + at, sizeof(int));
+    at += sizeof(int);
+    if ((1 > symN) || (QUANTN < symN) || (0 > outN) || (valueN < outN)) {
+        FatalError("corrupted quantized data...");
+    }
+    int *sym = AssignStorage(symN * sizeof(*sym)); /* used codes in ascending order */
+    int *len = AssignStorage(symN * sizeof(*len)); /* code lengths */
+    int *sorted = AssignStorage(symN * sizeof(*sorted)); /* used codes sorted by length */
+    int count[QUANTL + 1] = {0}; /* number of codes of each length */
+    int offset[QUANTL + 1] = {0}; /* position of the first code of each length in sorted */
+    for (int m = 0, last = 0; m < symN; ++m) {
+        unsigned int delta = 0;
+        for (int shift = 0; ; shift += 7) {
+            if (((size_t)size <= at) || (28 < shift)) {
+                FatalError("corrupted quantized data...");
+            }
+            delta |= (unsigned int)(stream[at] & 0x7F) << shift;
+            ++at;
+            if (!(stream[at - 1] & 0x80)) {
+                break;
+            }
+        }
+        if (((size_t)size <= at) || ((unsigned int)(QUANTN - 1 - last) < delta) || (QUANTL < stream[at]) ||
+                ((0 < m) && (0 == delta)) || ((1 < symN) == (0 == stream[at]))) {
+            FatalError("corrupted quantized data...");
+        }
+        last = last + (int)delta;
+        sym[m] = last;
+        len[m] = stream[at];
+        ++at;
+        ++count[len[m]];
+    }
+    for (int L = 2; L <= QUANTL; ++L) {
+        offset[L] = offset[L - 1] + count[L - 1];
+    }
+    for (int m = 0; (1 < symN) && (m < symN); ++m) {
+        sorted[offset[len[m]]] = sym[m];
+        ++offset[len[m]];
+    }
+    for (int L = 1; L <= QUANTL; ++L) {
+        offset[L] = offset[L] - count[L]; /* restore to the first code of the length */
+    }
+    uint64_t first[QUANTL + 1] = {0}; /* first canonical code of each length */
+    uint64_t word = 0;
+    for (int L = 1; L <= QUANTL; ++L) {
+        word = (word + count[L - 1]) << 1;
+        first[L] = word;
+    }
+    const size_t bitBegin = at + (size_t)outN * sizeof(double); /* start of the bit stream */
+    if ((size_t)size < bitBegin) {
+        FatalError("corrupted quantized data...");
+    }
+    const size_t bitEnd = 8 * ((size_t)size - bitBegin); /* end of the bit stream in bits */
+    size_t bit = 0; /* bit position */
+    for (int k = 0, idx = 0; k < n[Z]; ++k) {
+        for (int j = 0; j < n[Y]; ++j) {
+            for (int i = 0; i < n[X]; ++i, ++idx) {
+                const Real pred = LorenzoPredictor(data, n, k, j, i);
+                int c = sym[0];
+                if (1 < symN) {
+                    word = 0;
+                    for (int L = 1; ; ++L) {
+                        if ((QUANTL < L) || (bitEnd <= bit)) {
+                            FatalError("corrupted quantized data...");
+                        }
+                        word = (word << 1) | ((stream[bitBegin + bit / 8] >> (7 - bit % 8)) & 1);
+                        ++bit;
+                        if (word - first[L] < (uint64_t)count[L]) {
+                            c = sorted[offset[L] + (int)(word - first[L])];
+                            break;
+                        }
+                    }
+                }
+                if (0 == c) {
+                    double value = 0.0;
+                    if (bitBegin < at + sizeof(double)) {
+                        FatalError("corrupted quantized data...");
+                    }
+                    memcpy(&value, stream + at, sizeof(double));
+                    at += sizeof(double);
+                    data[idx] = value;
+                } else {
+                    data[idx] = pred + 2.0 * eb * (c - half);
+                }
+            }
+        }
+    }
+    RetrieveStorage(sym);
+    RetrieveStorage(len);
+    RetrieveStorage(sorted);
+    return 0;
+}
+/*
+ * Lorenzo predictor on decoded values, neighbours outside the block are zero.
+ */
+static Real LorenzoPredictor(const Real *rec, const int n[DIMS], const int k, const int j, const int i)
+{
+    const int idx = IndexNode(k, j, i, n[Y], n[X]);
+    const int dj = n[X]; /* index offset of j - 1 */
+    const int dk = n[X] * n[Y]; /* index offset of k - 1 */
+    Real pred = 0.0;
+    if (0 < i) {
+        pred = pred + rec[idx - 1];
+    }
+    if (0 < j) {
+        pred = pred + rec[idx - dj];
+        if (0 < i) {
+            pred = pred - rec[idx - dj - 1];
+        }
+    }
+    if (0 < k) {
+        pred = pred + rec[idx - dk];
+        if (0 < i) {
+            pred = pred - rec[idx - dk - 1];
+        }
+        if (0 < j) {
+            pred = pred - rec[idx - dk - dj];
+            if (0 < i) {
+                pred = pred + rec[idx - dk - dj - 1];
+            }
+        }
+    }
+    return pred;
+}
+static int CompareLeaf(const void *a, const void *b)
+{
+    const Leaf *la = a;
+    const Leaf *lb = b;
+    if (la->w != lb->w) {
+        return (la->w < lb->w) ? -1 : 1;
+    }
+    return (la->sym < lb->sym) ? -1 : (la->sym > lb->sym);
+}
+/*
+ * Huffman code lengths of used codes by merging the sorted leaf queue and
+ * the queue of internal nodes. A single used code takes no bits.
+ */
+static int HuffmanCodeLength(const int *freq, unsigned char *len)
+{
+    int symN = 0;
+    for (int s = 0; s < QUANTN; ++s) {
+        symN = symN + (0 < freq[s]);
+    }
+    if (1 == symN) {
+        return symN;
+    }
+    Leaf *leaf = AssignStorage(symN * sizeof(*leaf));
+    for (int s = 0, m = 0; s < QUANTN; ++s) {
+        if (0 < freq[s]) {
+            leaf[m].w = freq[s];
+            leaf[m].sym = s;
+            ++m;
+        }
+    }
+    qsort(leaf, symN, sizeof(*leaf), CompareLeaf);
+    /* nodes 0 to symN - 1 are leaves, the others are internal nodes */
+    const int nodeN = 2 * symN - 1;
+    int *w = AssignStorage(nodeN * sizeof(*w));
+    int *parent = AssignStorage(nodeN * sizeof(*parent));
+    for (int m = 0; m < symN; ++m) {
+        w[m] = leaf[m].w;
+    }
+    for (int node = symN, lq = 0, iq = symN; node < nodeN; ++node) {
+        for (int pick = 0; pick < 2; ++pick) {
+            int m = 0;
+            if ((lq < symN) && ((iq >= node) || (w[lq] <= w[iq]))) {
+                m = lq;
+                ++lq;
+            } else {
+                m = iq;
+                ++iq;
+            }
+            parent[m] = node;
+            w[node] = w[node] + w[m];
+        }
+    }
+    /* node depth reuses the weight storage */
+    w[nodeN - 1] = 0;
+    for (int m = nodeN - 2; m >= 0; --m) {
+        w[m] = w[parent[m]] + 1;
+    }
+    for (int m = 0; m < symN; ++m) {
+        if (QUANTL < w[m]) {
+            FatalError("Huffman code exceeds the length limit...");
+        }
+        len[leaf[m].sym] = (unsigned char)w[m];
+    }
+    RetrieveStorage(leaf);
+    RetrieveStorage(w);
+    RetrieveStorage(parent);
+    return symN;
+}
+/*
+ * Canonical Huffman codes: codes of the same length are consecutive in
+ * ascending code order, shorter codes come first.
+ */
+static void CanonicalCode(const unsigned char *len, uint64_t *word)
+{
+    int count[QUANTL + 1] = {0}; /* number of codes of each length */
+    uint64_t next[QUANTL + 1] = {0}; /* next canonical code of each length */
+    for (int s = 0; s < QUANTN; ++s) {
+        ++count[len[s]];
+    }
+    count[0] = 0;
+    uint64_t code = 0;
+    for (int L = 1; L <= QUANTL; ++L) {
+        code = (code + count[L - 1]) << 1;
+        next[L] = code;
+    }
+    for (int s = 0; s < QUANTN; ++s) {
+        if (0 < len[s]) {
+            word[s] = next[len[s]];
+            ++next[len[s]];
+        }
+    }
+    return;
+}
+static int PutVarint(unsigned char *stream, unsigned int value)
+{
+    int at = 0;
+    while (0x80 <= value) {
+        stream[at] = (unsigned char)((value & 0x7F) | 0x80);
+        value >>= 7;
+        ++at;
+    }
+    stream[at] = (unsigned char)value;
+    return at + 1;
+}
+/* a good practice: end file with a newline */
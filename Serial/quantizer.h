@@ -0,0 +1,43 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Header File Guards to Avoid Interdependence
+ ****************************************************************************/
+#ifndef ARTRACFD_QUANTIZER_H_ /* if this is the first definition */
+#define ARTRACFD_QUANTIZER_H_ /* a unique marker for this header file */
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+/****************************************************************************
+ * Public Functions Declaration
+ ****************************************************************************/
+/*
+ * Error-bounded quantization codec
+ *
+ * Function
+ *      Encode a block of n[X] x n[Y] x n[Z] values stored with x fastest,
+ *      such that each decoded value differs from the original value by no
+ *      more than the error bound eb. Each value is predicted by the Lorenzo
+ *      predictor from decoded neighbours in the block, the prediction error
+ *      is quantized to an integer multiple of 2 eb, and the quantization
+ *      codes are Huffman coded. Values that can not be predicted within the
+ *      quantization range are stored exactly. The encoded stream is assigned
+ *      storage, its size in bytes is returned by size.
+ */
+extern unsigned char *EncodeQuantizedBlock(const Real *data, const int n[DIMS], const Real eb, int *size);
+extern int DecodeQuantizedBlock(const unsigned char *stream, const int size, const int n[DIMS],
+        const Real eb, Real *data);
+#endif
+/* a good practice: end file with a newline */
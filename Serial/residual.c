@@ -0,0 +1,89 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include "residual.h"
+#include <stdio.h> /* standard library for input and output */
+#include <math.h> /* common mathematical functions */
+#include "commons.h"
+/****************************************************************************
+ * Function definitions
+ ****************************************************************************/
+void InitializeResidualMonitor(const Time *time, Space *space)
+{
+    if (0 == time->resInterval) {
+        return;
+    }
+    const Partition *restrict part = &(space->part);
+    Residual *res = &(space->res);
+    res->U = AssignStorage(part->n[X] * part->n[Y] * part->n[Z] * sizeof(*res->U));
+    res->stage = RESOFF;
+    /* a new run starts the residual history */
+    if (0 != time->restart) {
+        return;
+    }
+    FILE *filePointer = fopen("residual.csv", "w");
+    if (NULL == filePointer) {
+        FatalError("failed to write residual data...");
+    }
+    fprintf(filePointer, "# step, time, L2 rho, L2 rho_u, L2 rho_v, L2 rho_w, L2 rho_eT, "
+            "Linf rho, Linf rho_u, Linf rho_v, Linf rho_w, Linf rho_eT\n");
+    fclose(filePointer); /* close current opened file */
+    return;
+}
+void ReleaseResidualMonitor(Space *space)
+{
+    Residual *res = &(space->res);
+    RetrieveStorage(res->U);
+    res->U = NULL;
+    res->stage = RESOFF;
+    return;
+}
+void StartResidualMonitor(const Time *time, Space *space)
+{
+    Residual *res = &(space->res);
+    res->stage = RESOFF;
+    if ((NULL != res->U) && (0 == time->stepC % time->resInterval)) {
+        res->stage = RESSAVE;
+    }
+    return;
+}
+int StopResidualMonitor(const Real dt, const Time *time, Space *space)
+{
+    Residual *res = &(space->res);
+    const int measured = (RESMEASURE == res->stage) && (0 < res->nodeN);
+    res->stage = RESOFF;
+    if (!measured) {
+        return 0;
+    }
+    Real L2[DIMU] = {0.0};
+    Real Linf[DIMU] = {0.0};
+    int converged = (0.0 < time->resTol);
+    for (int dim = 0; dim < DIMU; ++dim) {
+        L2[dim] = sqrt(res->L2[dim] / res->nodeN) / dt;
+        Linf[dim] = res->Linf[dim] / dt;
+        if (L2[dim] > time->resTol) {
+            converged = 0;
+        }
+    }
+    FILE *filePointer = fopen("residual.csv", "a");
+    if (NULL == filePointer) {
+        FatalError("failed to write residual data...");
+    }
+    fprintf(filePointer, "%d, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g\n",
+            time->stepC, time->now, L2[0], L2[1], L2[2], L2[3], L2[4],
+            Linf[0], Linf[1], Linf[2], Linf[3], Linf[4]);
+    fclose(filePointer); /* close current opened file */
+    fprintf(stdout, "  residual: L2=%.6g, %.6g, %.6g, %.6g, %.6g;\n", L2[0], L2[1], L2[2], L2[3], L2[4]);
+    return converged;
+}
+/* a good practice: end file with a newline */
@@ -0,0 +1,58 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Header File Guards to Avoid Interdependence
+ ****************************************************************************/
+#ifndef ARTRACFD_RESIDUAL_H_ /* if this is the first definition */
+#define ARTRACFD_RESIDUAL_H_ /* a unique marker for this header file */
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+/*
+ * Monitor stages of a time step
+ */
+typedef enum {
+    RESOFF = 0, /* step is not monitored */
+    RESSAVE = 1, /* next update saves the field data */
+    RESMEASURE = 2, /* final updates measure the changes */
+} ResidualStage;
+/****************************************************************************
+ * Public Functions Declaration
+ ****************************************************************************/
+/*
+ * Residual monitor storage
+ *
+ * Function
+ *      Allocate the field data storage of the residual monitor if the
+ *      monitor is on, and start the residual history residual.csv for a
+ *      non restart case. Release is safe for a space without monitor.
+ */
+extern void InitializeResidualMonitor(const Time *, Space *);
+extern void ReleaseResidualMonitor(Space *);
+/*
+ * Monitor a time step
+ *
+ * Function
+ *      Start monitoring if the step count is a multiple of the monitor
+ *      interval, the fluid solver then measures the changes of conservative
+ *      variables over the step without an extra sweep of the field.
+ *      Stop appends the L2 and Linf norms of the changes divided by dt of
+ *      each conservative variable to the residual history, and returns 1
+ *      if the L2 norms of all variables are within the tolerance.
+ */
+extern void StartResidualMonitor(const Time *, Space *);
+extern int StopResidualMonitor(const Real dt, const Time *, Space *);
+#endif
+/* a good practice: end file with a newline */
@@ -19,7 +19,10 @@
 #include <string.h> /* manipulating strings */
 #include "immersed_boundary.h"
 #include "computational_geometry.h"
+#include "particle_bin.h"
 #include "linear_system.h"
+#include "trace.h"
+#include "primitive_cache.h"
 #include "cfd_commons.h"
 #include "commons.h"
 /****************************************************************************
@@ -39,25 +42,35 @@ int SolidDynamics(const Real now, const Real dt, Space *space, const Model *mode
     /*
      * Compute exerted surface forces.
      */
+    TraceBegin("surface force");
     SurfaceForceIntegration(space, model);
+    TraceEnd("surface force");
     /*
      * Kinematics
      */
+    TraceBegin("kinematics");
     Kinematics(now, dt, space);
+    TraceEnd("kinematics");
     /*
      * Collision
      */
     if (1 != model->fsi) {
+        TraceBegin("collision");
         CollisionDynamics(space);
+        TraceEnd("collision");
     }
     /*
      * Update spatial position
      */
+    TraceBegin("motion");
     ApplyMotion(dt, space);
+    TraceEnd("motion");
     /*
      * Recompute the geometry domain.
      */
+    TraceBegin("geometry domain");
     ComputeGeometryDomain(space, model);
+    TraceEnd("geometry domain");
     /*
      * Apply boundary condition
      */
@@ -70,14 +83,13 @@ void SurfaceForceIntegration(Space *space, const Model *model)
     Geometry *geo = &(space->geo);
     Polyhedron *poly = NULL;
     const Node *const node = space->node;
-    const IntVec nMin = {part->ns[PIN][X][MIN], part->ns[PIN][Y][MIN], part->ns[PIN][Z][MIN]};
-    const IntVec nMax = {part->ns[PIN][X][MAX], part->ns[PIN][Y][MAX], part->ns[PIN][Z][MAX]};
     const RealVec sMin = {part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN]};
     const RealVec d = {part->d[X], part->d[Y], part->d[Z]};
-    const RealVec dd = {part->dd[X], part->dd[Y], part->dd[Z]};
     const int ng = part->ng;
     int idx = 0; /* linear array index math variable */
-    int box[DIMS][LIMIT] = {{0}}; /* bounding box in node space */
+    const int *sepG = NULL; /* ghost node list separators */
+    const int *sepL = NULL; /* interfacial node list separators */
+    const int *nG = NULL; /* ghost node */
     int lidN = 0; /* count total number of interfacial nodes */
     int gstN = 0; /* count total number of ghost nodes */
     const Real zero = 0.0;
@@ -107,65 +119,53 @@ void SurfaceForceIntegration(Space *space, const Model *model)
         memset(poly->Fv, 0, DIMS * sizeof(*poly->Fv));
         memset(poly->Tt, 0, DIMS * sizeof(*poly->Tt));
         memset(fvar, 0, DIMS * sizeof(*fvar));
-        lidN = 0;
+        sepG = NodeListSeparator(n, LISTGST, geo);
+        sepL = NodeListSeparator(n, LISTLID, geo);
+        lidN = sepL[3] - sepL[2]; /* interfacial nodes of current geometry */
         gstN = 0;
-        /* determine search range according to bounding box of polyhedron and valid node space */
-        for (int s = 0; s < DIMS; ++s) {
-            box[s][MIN] = ValidNodeSpace(NodeSpace(poly->box[s][MIN], sMin[s], dd[s], ng), nMin[s], nMax[s]);
-            box[s][MAX] = ValidNodeSpace(NodeSpace(poly->box[s][MAX], sMin[s], dd[s], ng), nMin[s], nMax[s]) + 1;
-        }
-        for (int k = box[Z][MIN]; k < box[Z][MAX]; ++k) {
-            for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
-                for (int i = box[X][MIN]; i < box[X][MAX]; ++i) {
-                    idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                    if ((2 == node[idx].lid) && (n + 1 == node[idx].gid)) {
-                        ++lidN; /* an interfacial node of current geometry */
-                    }
-                    if ((2 != node[idx].gst) || (n + 1 != node[idx].gid)) {
-                        continue;
-                    }
-                    ++gstN; /* a ghost node of current geometry */
-                    /* surface force exerted by fluid (pressure + shear force) */
-                    pG[X] = PointSpace(i, sMin[X], d[X], ng);
-                    pG[Y] = PointSpace(j, sMin[Y], d[Y], ng);
-                    pG[Z] = PointSpace(k, sMin[Z], d[Z], ng);
-                    ComputeGeometricData(node[idx].fid, poly, pG, pO, pI, N);
-                    r[X] = pO[X] - poly->O[X];
-                    r[Y] = pO[Y] - poly->O[Y];
-                    r[Z] = pO[Z] - poly->O[Z];
-                    PrimitiveByConservative(model->gamma, model->gasR, node[idx].U[TO], Uo);
-                    Fp[X] = Uo[4] * N[X];
-                    Fp[Y] = Uo[4] * N[Y];
-                    Fp[Z] = Uo[4] * N[Z];
-                    if (1 == gstN) {
-                        fvar[0] = Uo[4];
-                    }
-                    fvar[1] = fvar[1] + Uo[4] - fvar[0];
-                    fvar[2] = fvar[2] + (Uo[4] - fvar[0]) * (Uo[4] - fvar[0]);
-                    if ((zero < model->refMu) && (zero < poly->cf)) {
-                        mu = model->refMu * Viscosity(Uo[5] * model->refT);
-                        Cross(poly->W[TO], r, V);
-                        V[X] = Uo[1] - (poly->V[TO][X] + V[X]);
-                        V[Y] = Uo[2] - (poly->V[TO][Y] + V[Y]);
-                        V[Z] = Uo[3] - (poly->V[TO][Z] + V[Z]);
-                        Vn = Dot(V, N);
-                        Fv[X] = mu * (V[X] - Vn * N[X]) / Dist(pG, pO);
-                        Fv[Y] = mu * (V[Y] - Vn * N[Y]) / Dist(pG, pO);
-                        Fv[Z] = mu * (V[Z] - Vn * N[Z]) / Dist(pG, pO);
-                    } else {
-                        memset(Fv, 0, DIMS * sizeof(*Fv));
-                    }
-                    Fs[X] = Fp[X] + Fv[X];
-                    Fs[Y] = Fp[Y] + Fv[Y];
-                    Fs[Z] = Fp[Z] + Fv[Z];
-                    Cross(r, Fs, Tt);
-                    /* integration sum */
-                    for (int s = 0; s < DIMS; ++s) {
-                        poly->Fp[s] = poly->Fp[s] + Fp[s];
-                        poly->Fv[s] = poly->Fv[s] + Fv[s];
-                        poly->Tt[s] = poly->Tt[s] + Tt[s];
-                    }
-                }
+        for (int m = sepG[2]; m < sepG[3]; ++m) {
+            nG = geo->list[m];
+            idx = IndexNode(nG[Z], nG[Y], nG[X], part->n[Y], part->n[X]);
+            ++gstN; /* a ghost node of current geometry */
+            /* surface force exerted by fluid (pressure + shear force) */
+            pG[X] = PointSpace(nG[X], sMin[X], d[X], ng);
+            pG[Y] = PointSpace(nG[Y], sMin[Y], d[Y], ng);
+            pG[Z] = PointSpace(nG[Z], sMin[Z], d[Z], ng);
+            ComputeGeometricData(node[idx].fid, poly, pG, pO, pI, N);
+            r[X] = pO[X] - poly->O[X];
+            r[Y] = pO[Y] - poly->O[Y];
+            r[Z] = pO[Z] - poly->O[Z];
+            NodePrimitive(TO, idx, node, &(space->cache), model, Uo);
+            Fp[X] = Uo[4] * N[X];
+            Fp[Y] = Uo[4] * N[Y];
+            Fp[Z] = Uo[4] * N[Z];
+            if (1 == gstN) {
+                fvar[0] = Uo[4];
+            }
+            fvar[1] = fvar[1] + Uo[4] - fvar[0];
+            fvar[2] = fvar[2] + (Uo[4] - fvar[0]) * (Uo[4] - fvar[0]);
+            if ((zero < model->refMu) && (zero < poly->cf)) {
+                mu = model->refMu * Viscosity(Uo[5] * model->refT);
+                Cross(poly->W[TO], r, V);
+                V[X] = Uo[1] - (poly->V[TO][X] + V[X]);
+                V[Y] = Uo[2] - (poly->V[TO][Y] + V[Y]);
+                V[Z] = Uo[3] - (poly->V[TO][Z] + V[Z]);
+                Vn = Dot(V, N);
+                Fv[X] = mu * (V[X] - Vn * N[X]) / Dist(pG, pO);
+                Fv[Y] = mu * (V[Y] - Vn * N[Y]) / Dist(pG, pO);
+                Fv[Z] = mu * (V[Z] - Vn * N[Z]) / Dist(pG, pO);
+            } else {
+                memset(Fv, 0, DIMS * sizeof(*Fv));
+            }
+            Fs[X] = Fp[X] + Fv[X];
+            Fs[Y] = Fp[Y] + Fv[Y];
+            Fs[Z] = Fp[Z] + Fv[Z];
+            Cross(r, Fs, Tt);
+            /* integration sum */
+            for (int s = 0; s < DIMS; ++s) {
+                poly->Fp[s] = poly->Fp[s] + Fp[s];
+                poly->Fv[s] = poly->Fv[s] + Fv[s];
+                poly->Tt[s] = poly->Tt[s] + Tt[s];
             }
         }
         /* calibrate the sum of discrete forces into integration */
@@ -235,13 +235,8 @@ static void CollisionDynamics(Space *space)
     Polyhedron *polp = NULL;
     Polyhedron *poln = NULL;
     const Node *const node = space->node;
-    const IntVec nMin = {part->ns[PIN][X][MIN], part->ns[PIN][Y][MIN], part->ns[PIN][Z][MIN]};
-    const IntVec nMax = {part->ns[PIN][X][MAX], part->ns[PIN][Y][MAX], part->ns[PIN][Z][MAX]};
-    const RealVec sMin = {part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN]};
-    const RealVec dd = {part->dd[X], part->dd[Y], part->dd[Z]};
-    const int ng = part->ng;
-    int idx = 0; /* linear array index math variable */
-    int box[DIMS][LIMIT] = {{0}}; /* bounding box in node space */
+    const int *sep = NULL; /* interfacial node list separators */
+    const int *nL = NULL; /* interfacial node */
     const Real zero = 0.0;
     const Real one = 1.0;
     const int coltag = INT_MAX / 2; /* colliding polyhedron marker */
@@ -263,21 +258,14 @@ static void CollisionDynamics(Space *space)
             continue;
         }
         geo->colN = 0; /* reset */
-        /* determine search range according to bounding box of polyhedron and valid node space */
-        for (int s = 0; s < DIMS; ++s) {
-            box[s][MIN] = ValidNodeSpace(NodeSpace(polp->box[s][MIN], sMin[s], dd[s], ng), nMin[s], nMax[s]);
-            box[s][MAX] = ValidNodeSpace(NodeSpace(polp->box[s][MAX], sMin[s], dd[s], ng), nMin[s], nMax[s]) + 1;
+        if (0 != IsolatedGeometry(p, geo)) { /* no geometry within reach */
+            continue;
         }
-        for (int k = box[Z][MIN]; k < box[Z][MAX]; ++k) {
-            for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
-                for (int i = box[X][MIN]; i < box[X][MAX]; ++i) {
-                    idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                    if ((1 != node[idx].lid) || (p + 1 != node[idx].gid)) {
-                        continue;
-                    }
-                    CollisionState(k, j, i, p + 1, part->pathSep[1], part->path, node, part, geo);
-                }
-            }
+        /* search contacts around the first layer interfacial nodes of the polyhedron */
+        sep = NodeListSeparator(p, LISTLID, geo);
+        for (int m = sep[1]; m < sep[2]; ++m) {
+            nL = geo->list[m];
+            CollisionState(nL[Z], nL[Y], nL[X], p + 1, part->pathSep[1], part->path, node, part, geo);
         }
         /* skip none contacting polyhedron */
         if (0 == geo->colN) {
@@ -17,17 +17,22 @@
 #include <float.h> /* size of floating point values */
 #include "initialization.h"
 #include "fluid_dynamics.h"
+#include "mesh_refinement.h"
 #include "solid_dynamics.h"
 #include "data_stream.h"
 #include "timer.h"
 #include "data_probe.h"
+#include "statistics.h"
+#include "residual.h"
+#include "perf_counter.h"
+#include "trace.h"
+#include "primitive_cache.h"
 #include "cfd_commons.h"
 #include "commons.h"
 /****************************************************************************
  * Static Function Declarations
  ****************************************************************************/
 static int SolutionEvolution(Time *, Space *, const Model *);
-static Real ComputeTimeStep(const Time *, const Space *, const Model *);
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
@@ -42,7 +47,10 @@ int Solve(Time *time, Space *space, const Model *model)
     fprintf(stdout, "  initializing...\n");
     InitializeComputationalDomain(time, space, model);
     fprintf(stdout, "  time marching...\n");
+    OpenCounters();
     SolutionEvolution(time, space, model);
+    ReportCounters();
+    CloseTrace();
     ShowInformation("Session End");
     return 0;
 }
@@ -66,17 +74,28 @@ static int SolutionEvolution(Time *time, Space *space, const Model *model)
     Real recLine = zero; /* line probe data writing recorder */
     Real recCurve = zero; /* curve probe data writing recorder */
     Real recForce = zero; /* force probe data writing recorder */
+    Real dtOutput[NOUTPUT] = {0.0}; /* region output writing interval */
+    Real recOutput[NOUTPUT] = {0.0}; /* region output writing recorder */
+    for (int n = 0; n < time->outputN; ++n) {
+        dtOutput[n] = time->end / (Real)(time->output[n].writeN);
+    }
     /* set some timers for monitoring time consuming of process */
     Timer timer; /* timer for computing operations */
+    Hierarchy hier = {0}; /* refined patches */
     while ((time->now < time->end) && (time->stepC < time->stepN)) {
         /*
          * Step count
          */
         ++(time->stepC);
+        TraceBegin("step");
         /*
          * Calculate dt for current time step
          */
+        TraceBegin("time step");
+        StartCounters(PHASESTEP);
         dt = ComputeTimeStep(time, space, model);
+        StopCounters(PHASESTEP);
+        TraceEnd("time step");
         /*
          * Update current time stamp, if current time exceeds the end time, 
          * recompute the value of dt to make current time equal to the end time.
@@ -95,13 +114,39 @@ static int SolutionEvolution(Time *time, Space *space, const Model *model)
          */
         TickTime(&timer);
         if (0 != model->fsi) {
+            TraceBegin("solid");
+            StartCounters(PHASESOLID);
             SolidDynamics(time->now, 0.5 * dt, space, model);
+            StopCounters(PHASESOLID);
+            TraceEnd("solid");
+        }
+        StartResidualMonitor(time, space);
+        TraceBegin("fluid");
+        StartCounters(PHASEFLUID);
+        if (0 != model->amr) {
+            AdaptiveFluidDynamics(dt, &hier, space, model);
+        } else {
+            FluidDynamics(dt, space, model);
         }
-        FluidDynamics(dt, space, model);
+        StopCounters(PHASEFLUID);
+        TraceEnd("fluid");
         if (0 != model->fsi) {
+            TraceBegin("solid");
+            StartCounters(PHASESOLID);
             SolidDynamics(time->now, 0.5 * dt, space, model);
+            StopCounters(PHASESOLID);
+            TraceEnd("solid");
         }
+        AccumulateStatistics(dt, time, space, model);
         fprintf(stdout, "  elapsed: %.6gs\n", TockTime(&timer));
+        /*
+         * A steady state ends the computation at current step, the step
+         * limit is set to current step to trigger the final data export.
+         */
+        if (0 != StopResidualMonitor(dt, time, space)) {
+            fprintf(stdout, "  steady state reached...\n");
+            time->stepN = time->stepC;
+        }
         /*
          * Export data if accumulated time increases to anticipated interval.
          */
@@ -110,40 +155,68 @@ static int SolutionEvolution(Time *time, Space *space, const Model *model)
         recLine = recLine + dt;
         recCurve = recCurve + dt;
         recForce = recForce + dt;
+        StartCounters(PHASEOUTPUT);
         if ((recForce > dtForce) || (time->now == time->end) || (time->stepC == time->stepN)) {
+            TraceBegin("write force");
             SurfaceForceIntegration(space, model);
             WriteSurfaceForceData(time, space);
+            TraceEnd("write force");
             recForce = zero; /* reset probe accumulated time */
         }
+        /* region outputs go first, the field data keep their writing counts */
+        for (int n = 0; n < time->outputN; ++n) {
+            recOutput[n] = recOutput[n] + dt;
+            if ((recOutput[n] > dtOutput[n]) || (time->now == time->end) || (time->stepC == time->stepN)) {
+                TraceBegin("write region");
+                WriteFieldDataOfRegion(n, time, space, model);
+                TraceEnd("write region");
+                ++(time->output[n].writeC); /* export count increase */
+                recOutput[n] = zero; /* reset accumulated time */
+            }
+        }
         if ((recField > dtField) || (time->now == time->end) || (time->stepC == time->stepN)) {
             ++(time->writeC); /* export count increase */
             fprintf(stdout, "  writing field data...\n");
+            TraceBegin("write field");
             WriteFieldData(time, space, model);
+            WriteStatisticsCheckpoint(time, space);
+            TraceEnd("write field");
+            TraceBegin("write geometry");
             WriteGeometryData(time, &(space->geo));
+            TraceEnd("write geometry");
             recField = zero; /* reset accumulated time */
         }
         if ((recPoint > dtPoint) || (time->now == time->end) || (time->stepC == time->stepN)) {
+            TraceBegin("write point probe");
             WriteFieldDataAtPointProbes(time, space, model);
+            TraceEnd("write point probe");
             recPoint = zero; /* reset probe accumulated time */
         }
         if ((recLine > dtLine) || (time->now == time->end) || (time->stepC == time->stepN)) {
+            TraceBegin("write line probe");
             WriteFieldDataAtLineProbes(time, space, model);
+            TraceEnd("write line probe");
             recLine = zero; /* reset probe accumulated time */
         }
         if ((recCurve > dtCurve) || (time->now == time->end) || (time->stepC == time->stepN)) {
+            TraceBegin("write curve probe");
             WriteFieldDataAtCurveProbes(time, space, model);
+            TraceEnd("write curve probe");
             recCurve = zero; /* reset probe accumulated time */
         }
+        StopCounters(PHASEOUTPUT);
+        TraceEnd("step");
     }
+    ReleaseHierarchy(&hier);
+    WriteStatistics(time, space);
     return 0;
 }
-static Real ComputeTimeStep(const Time *time, const Space *space, const Model *model)
+Real ComputeTimeStep(const Time *time, const Space *space, const Model *model)
 {
     const Partition *restrict part = &(space->part);
     const Geometry *geo = &(space->geo);
     const Polyhedron *poly = NULL;
     const Node *const node = space->node;
-    const Real *restrict U = NULL;
     int idx = 0; /* linear array index math variable */
     Real speed = 0.0;
     Real speedMax = FLT_MIN;
@@ -166,11 +239,10 @@ static Real ComputeTimeStep(const Time *time, const Space *space, const Model *m
         for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
             for (int i = part->ns[PIN][X][MIN]; i < part->ns[PIN][X][MAX]; ++i) {
                 idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                U = node[idx].U[TO];
                 if (0 != node[idx].gid) {
                     continue;
                 }
-                PrimitiveByConservative(model->gamma, model->gasR, U, Uo);
+                NodePrimitive(TO, idx, node, &(space->cache), model, Uo);
                 speed = MaxReal(fabs(Uo[1]), MaxReal(fabs(Uo[2]), fabs(Uo[3]))) + 
                     sqrt(model->gamma * model->gasR * Uo[5]);
                 if (speedMax < speed) {
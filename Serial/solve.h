@@ -30,6 +30,13 @@
  *      Call a series of function to perform numerical computation.
  */
 extern int Solve(Time *, Space *, const Model *);
+/*
+ * Time step
+ *
+ * Function
+ *      Compute the time step by the CFL condition of fluid and solid motion.
+ */
+extern Real ComputeTimeStep(const Time *, const Space *, const Model *);
 #endif
 /* a good practice: end file with a newline */
 
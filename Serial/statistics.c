@@ -0,0 +1,285 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include "statistics.h"
+#include <stdio.h> /* standard library for input and output */
+#include <string.h> /* manipulating strings */
+#include <math.h> /* common mathematical functions */
+#include "primitive_cache.h"
+#include "trace.h"
+#include "cfd_commons.h"
+#include "commons.h"
+/****************************************************************************
+ * Static Function Declarations
+ ****************************************************************************/
+static void CellRange(const int, const int, const Partition *, const int [restrict], int [restrict][LIMIT]);
+static void ReadStatisticsCheckpoint(const Time *, Space *);
+static void WriteDoubles(const Real *, const size_t, FILE *);
+static void ReadDoubles(Real *, const size_t, FILE *);
+/****************************************************************************
+ * Function definitions
+ ****************************************************************************/
+void InitializeStatistics(const Time *time, Space *space)
+{
+    if (0 == time->statBlock) {
+        return;
+    }
+    const Partition *restrict part = &(space->part);
+    Statistics *stat = &(space->stat);
+    stat->cellN = 1;
+    for (int s = 0; s < DIMS; ++s) {
+        const int nodeN = part->ns[PIN][s][MAX] - part->ns[PIN][s][MIN];
+        stat->n[s] = (nodeN + time->statBlock - 1) / time->statBlock;
+        stat->cellN = stat->cellN * stat->n[s];
+    }
+    stat->W = AssignStorage(stat->cellN * sizeof(*stat->W));
+    stat->mean = AssignStorage(stat->cellN * sizeof(*stat->mean));
+    stat->M2 = AssignStorage(stat->cellN * sizeof(*stat->M2));
+    if (0 != time->restart) {
+        ReadStatisticsCheckpoint(time, space);
+    }
+    return;
+}
+void ReleaseStatistics(Space *space)
+{
+    Statistics *stat = &(space->stat);
+    RetrieveStorage(stat->W);
+    RetrieveStorage(stat->mean);
+    RetrieveStorage(stat->M2);
+    stat->W = NULL;
+    stat->mean = NULL;
+    stat->M2 = NULL;
+    stat->cellN = 0;
+    return;
+}
+/*
+ * Node range of a cell, the last cell of each axis holds the remainder.
+ */
+static void CellRange(const int c, const int block, const Partition *part,
+        const int n[restrict], int range[restrict][LIMIT])
+{
+    const int cell[DIMS] = {c % n[X], (c / n[X]) % n[Y], c / (n[X] * n[Y])};
+    for (int s = 0; s < DIMS; ++s) {
+        range[s][MIN] = part->ns[PIN][s][MIN] + cell[s] * block;
+        range[s][MAX] = MinInt(range[s][MIN] + block, part->ns[PIN][s][MAX]);
+    }
+    return;
+}
+/*
+ * West, D. H. D. (1979). Updating mean and variance estimates: An improved
+ * method. Communications of the ACM, 22(9), 532-535.
+ *
+ * Each fluid node of a cell is a sample of weight w, the update of the
+ * weighted Welford algorithm is
+ *      W = W + w; delta = x - mean; mean = mean + w / W * delta;
+ *      M2 = M2 + w * delta * (x - mean),
+ * and a cross product takes the deviation of one variable from the old
+ * mean and the other from the new mean. Cells are independent and updated
+ * concurrently.
+ */
+void AccumulateStatistics(const Real dt, const Time *time, Space *space, const Model *model)
+{
+    Statistics *stat = &(space->stat);
+    if (NULL == stat->W) {
+        return;
+    }
+    const Real w = MinReal(dt, time->now - time->statStart);
+    if (0.0 >= w) {
+        return;
+    }
+    TraceBegin("statistics");
+    const Partition *restrict part = &(space->part);
+    const Node *const node = space->node;
+    const Cache *cache = &(space->cache);
+    const int block = time->statBlock;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int c = 0; c < stat->cellN; ++c) {
+        int range[DIMS][LIMIT] = {{0}};
+        Real Uo[DIMUo] = {0.0};
+        Real delta[DIMUo] = {0.0};
+        Real W = stat->W[c];
+        Real *restrict mean = stat->mean[c];
+        Real *restrict M2 = stat->M2[c];
+        CellRange(c, block, part, stat->n, range);
+        for (int k = range[Z][MIN]; k < range[Z][MAX]; ++k) {
+            for (int j = range[Y][MIN]; j < range[Y][MAX]; ++j) {
+                for (int i = range[X][MIN]; i < range[X][MAX]; ++i) {
+                    const int idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                    if (0 != node[idx].gid) {
+                        continue;
+                    }
+                    NodePrimitive(TO, idx, node, cache, model, Uo);
+                    W = W + w;
+                    const Real r = w / W;
+                    for (int v = 0; v < DIMUo; ++v) {
+                        delta[v] = Uo[v] - mean[v];
+                        mean[v] = mean[v] + r * delta[v];
+                        M2[v] = M2[v] + w * delta[v] * (Uo[v] - mean[v]);
+                    }
+                    M2[6] = M2[6] + w * delta[1] * (Uo[2] - mean[2]);
+                    M2[7] = M2[7] + w * delta[2] * (Uo[3] - mean[3]);
+                    M2[8] = M2[8] + w * delta[3] * (Uo[1] - mean[1]);
+                }
+            }
+        }
+        stat->W[c] = W;
+    }
+    TraceEnd("statistics");
+    return;
+}
+/*
+ * A checkpoint statisticsNNNNN.chk is written with each field data.
+ * Layout: "ArtraSTA", int writeC, int block, int n[DIMS], then double
+ * weights, means, and second moments of all cells.
+ */
+void WriteStatisticsCheckpoint(const Time *time, const Space *space)
+{
+    const Statistics *stat = &(space->stat);
+    if (NULL == stat->W) {
+        return;
+    }
+    String fileName = {'\0'};
+    snprintf(fileName, sizeof(fileName), "statistics%05d.chk", time->writeC);
+    FILE *filePointer = fopen(fileName, "wb");
+    if (NULL == filePointer) {
+        FatalError("failed to write statistics checkpoint...");
+    }
+    const int head[2 + DIMS] = {time->writeC, time->statBlock, stat->n[X], stat->n[Y], stat->n[Z]};
+    fwrite("ArtraSTA", sizeof(char), 8, filePointer);
+    fwrite(head, sizeof(int), 2 + DIMS, filePointer);
+    WriteDoubles(stat->W, stat->cellN, filePointer);
+    WriteDoubles(stat->mean[0], (size_t)stat->cellN * DIMUo, filePointer);
+    WriteDoubles(stat->M2[0], (size_t)stat->cellN * STATN, filePointer);
+    fclose(filePointer); /* close current opened file */
+    return;
+}
+static void ReadStatisticsCheckpoint(const Time *time, Space *space)
+{
+    Statistics *stat = &(space->stat);
+    String fileName = {'\0'};
+    snprintf(fileName, sizeof(fileName), "statistics%05d.chk", time->restart);
+    FILE *filePointer = fopen(fileName, "rb");
+    if (NULL == filePointer) {
+        fprintf(stdout, "  no statistics checkpoint, statistics restarts...\n");
+        return;
+    }
+    char magic[8] = {'\0'};
+    int head[2 + DIMS] = {0};
+    Fread(magic, sizeof(char), 8, filePointer);
+    Fread(head, sizeof(int), 2 + DIMS, filePointer);
+    if (0 != strncmp(magic, "ArtraSTA", 8)) {
+        FatalError("not a statistics checkpoint...");
+    }
+    if ((time->restart != head[0]) || (time->statBlock != head[1]) ||
+            (stat->n[X] != head[2]) || (stat->n[Y] != head[3]) || (stat->n[Z] != head[4])) {
+        FatalError("statistics checkpoint does not match restart data...");
+    }
+    ReadDoubles(stat->W, stat->cellN, filePointer);
+    ReadDoubles(stat->mean[0], (size_t)stat->cellN * DIMUo, filePointer);
+    ReadDoubles(stat->M2[0], (size_t)stat->cellN * STATN, filePointer);
+    fclose(filePointer); /* close current opened file */
+    return;
+}
+/*
+ * Accumulators are stored as double regardless of the type of Real, hence
+ * a checkpoint is portable between builds of different precisions.
+ */
+static void WriteDoubles(const Real *value, const size_t n, FILE *filePointer)
+{
+    double *data = AssignStorage(n * sizeof(*data));
+    for (size_t m = 0; m < n; ++m) {
+        data[m] = value[m];
+    }
+    fwrite(data, sizeof(double), n, filePointer);
+    RetrieveStorage(data);
+    return;
+}
+static void ReadDoubles(Real *value, const size_t n, FILE *filePointer)
+{
+    double *data = AssignStorage(n * sizeof(*data));
+    Fread(data, sizeof(double), n, filePointer);
+    for (size_t m = 0; m < n; ++m) {
+        value[m] = data[m];
+    }
+    RetrieveStorage(data);
+    return;
+}
+void WriteStatistics(const Time *time, const Space *space)
+{
+    const Statistics *stat = &(space->stat);
+    if (NULL == stat->W) {
+        return;
+    }
+    FILE *filePointer = fopen("statistics.vts", "w");
+    if (NULL == filePointer) {
+        FatalError("failed to write statistics...");
+    }
+    const Partition *restrict part = &(space->part);
+    const char name[DIMUo + DIMUo][15] = {"rho", "u", "v", "w", "p", "T", 
+        "rho_rms", "u_rms", "v_rms", "w_rms", "p_rms", "T_rms"};
+    const char cross[STATN - DIMUo][5] = {"uv", "vw", "wu"};
+    int range[DIMS][LIMIT] = {{0}};
+    fprintf(filePointer, "<?xml version=\"1.0\"?>\n");
+    fprintf(filePointer, "<VTKFile type=\"StructuredGrid\" version=\"1.0\"\n");
+    fprintf(filePointer, "         byte_order=\"LittleEndian\">\n");
+    fprintf(filePointer, "  <StructuredGrid WholeExtent=\"%d %d %d %d %d %d\">\n", 
+            0, stat->n[X] - 1, 0, stat->n[Y] - 1, 0, stat->n[Z] - 1);
+    fprintf(filePointer, "    <Piece Extent=\"%d %d %d %d %d %d\">\n", 
+            0, stat->n[X] - 1, 0, stat->n[Y] - 1, 0, stat->n[Z] - 1);
+    fprintf(filePointer, "      <PointData>\n");
+    for (int v = 0; v < DIMUo + STATN + 1; ++v) {
+        fprintf(filePointer, "        <DataArray type=\"Float64\" Name=\"%s\" format=\"ascii\">\n", 
+                (DIMUo + DIMUo > v) ? name[v] : ((DIMUo + STATN > v) ? cross[v - DIMUo - DIMUo] : "weight"));
+        fprintf(filePointer, "          ");
+        for (int c = 0; c < stat->cellN; ++c) {
+            const Real W = stat->W[c];
+            Real data = 0.0;
+            if (DIMUo > v) {
+                data = stat->mean[c][v];
+            } else if (DIMUo + DIMUo > v) {
+                data = (0.0 < W) ? sqrt(MaxReal(0.0, stat->M2[c][v - DIMUo]) / W) : 0.0;
+            } else if (DIMUo + STATN > v) {
+                data = (0.0 < W) ? stat->M2[c][v - DIMUo] / W : 0.0;
+            } else {
+                data = W;
+            }
+            fprintf(filePointer, "%.6g ", data);
+        }
+        fprintf(filePointer, "\n        </DataArray>\n");
+    }
+    fprintf(filePointer, "      </PointData>\n");
+    fprintf(filePointer, "      <CellData>\n");
+    fprintf(filePointer, "      </CellData>\n");
+    fprintf(filePointer, "      <Points>\n");
+    fprintf(filePointer, "        <DataArray type=\"Float64\" Name=\"points\"\n");
+    fprintf(filePointer, "                   NumberOfComponents=\"3\" format=\"ascii\">\n");
+    fprintf(filePointer, "          ");
+    for (int c = 0; c < stat->cellN; ++c) {
+        CellRange(c, time->statBlock, part, stat->n, range);
+        for (int s = 0; s < DIMS; ++s) {
+            fprintf(filePointer, "%.6g ", 0.5 * 
+                    (PointSpace(range[s][MIN], part->domain[s][MIN], part->d[s], part->ng) +
+                     PointSpace(range[s][MAX] - 1, part->domain[s][MIN], part->d[s], part->ng)));
+        }
+    }
+    fprintf(filePointer, "\n        </DataArray>\n");
+    fprintf(filePointer, "      </Points>\n");
+    fprintf(filePointer, "    </Piece>\n");
+    fprintf(filePointer, "  </StructuredGrid>\n");
+    fprintf(filePointer, "</VTKFile>\n");
+    fclose(filePointer); /* close current opened file */
+    return;
+}
+/* a good practice: end file with a newline */
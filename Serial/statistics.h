@@ -0,0 +1,61 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Header File Guards to Avoid Interdependence
+ ****************************************************************************/
+#ifndef ARTRACFD_STATISTICS_H_ /* if this is the first definition */
+#define ARTRACFD_STATISTICS_H_ /* a unique marker for this header file */
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include "commons.h"
+/****************************************************************************
+ * Public Functions Declaration
+ ****************************************************************************/
+/*
+ * Statistics storage
+ *
+ * Function
+ *      Allocate statistics cells of statBlock nodes per axis of the interior
+ *      domain if statistics is on. A restart loads the accumulators from the
+ *      checkpoint of the restart data, and starts over if it is missing.
+ *      Release is safe for a space without statistics.
+ */
+extern void InitializeStatistics(const Time *, Space *);
+extern void ReleaseStatistics(Space *);
+/*
+ * Accumulate statistics
+ *
+ * Function
+ *      Update the statistics of each cell by the primitive variables of its
+ *      fluid nodes at time level TO with the weighted Welford algorithm, each
+ *      sample is weighted by the part of the time step dt after statStart.
+ */
+extern void AccumulateStatistics(const Real dt, const Time *, Space *, const Model *);
+/*
+ * Statistics checkpoint
+ *
+ * Function
+ *      Write the accumulators to statisticsNNNNN.chk along with the field
+ *      data of the same writing count, which a restart reads back.
+ */
+extern void WriteStatisticsCheckpoint(const Time *, const Space *);
+/*
+ * Statistics output
+ *
+ * Function
+ *      Write the final statistics to statistics.vts with a point at the
+ *      centroid of each cell: means, root mean squares of the deviations
+ *      (rho_rms, ..., T_rms), covariances uv, vw, wu, and the weight.
+ */
+extern void WriteStatistics(const Time *, const Space *);
+#endif
+/* a good practice: end file with a newline */
@@ -11,9 +11,20 @@
 /****************************************************************************
  * Required Header Files
  ****************************************************************************/
+#define _POSIX_C_SOURCE 200112L /* file mapping interface */
 #include "stl.h"
 #include <stdio.h> /* standard library for input and output */
+#include <stdlib.h> /* string conversion */
 #include <string.h> /* manipulating strings */
+#include <stdint.h> /* fixed width integer types */
+#include <float.h> /* size of floating point values */
+#include <fcntl.h> /* file opening */
+#include <unistd.h> /* file closing */
+#include <sys/stat.h> /* file size */
+#include <sys/mman.h> /* memory mapping */
+#ifdef _OPENMP
+#include <omp.h> /* OpenMP runtime */
+#endif
 #include "commons.h"
 /****************************************************************************
  * Data Structure Declarations
@@ -25,54 +36,337 @@ typedef char StlString[80]; /* UINT8[80], STL string data requires 80 chars */
 typedef unsigned int StlLongInt; /* UINT32, STL unsigned long integer */
 typedef unsigned short int StlInt; /* UINT16, STL unsigned integer */
 typedef float StlReal; /* REAL32, STL real data */
+enum {
+    STLHEAD = 84, /* header and facet count of binary STL */
+    STLRECORD = 50, /* facet record of binary STL */
+    STLPIECE = 1048576, /* minimum bytes of an ASCII STL piece */
+};
 /****************************************************************************
  * Static Function Declarations
  ****************************************************************************/
+static int ReadBinaryStl(const char *, const int, Facet *);
+static Facet *ReadAsciiStl(const char *, const size_t, int *);
+static const char *NextFacet(const char *, const char *);
+static Facet *ReadAsciiStlPiece(const char *, const char *, int *);
+static int IsBlank(const char);
+static size_t NextToken(const char **, const char *);
+static int TokenIs(const char *, const size_t, const char *);
+static int ReadTokenVector(const char **, const char *, RealVec);
+static int ConvertDecimal(const char *, const size_t, StlReal *);
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
+/*
+ * The file is mapped into memory and parsed in place. A file is binary when
+ * its size matches the facet count of the binary header, otherwise it is
+ * taken as ASCII if it starts with the keyword solid.
+ */
 int ReadStlFile(const char *fileName, Polyhedron *poly)
 {
-    StlString header = {'\0'};
-    StlLongInt facetN = 0;
-    StlInt attributeCount = 0;
-    StlReal facetData = 0.0;
-    FILE *filePointer = fopen(fileName, "rb");
-    if (NULL == filePointer) {
+    const int fd = open(fileName, O_RDONLY);
+    if (0 > fd) {
         FatalError("failed to open STL file...");
     }
-    Fread(header, sizeof(char), sizeof(StlString), filePointer);
-    Fread(&facetN, sizeof(StlLongInt), 1, filePointer);
-    poly->faceN = facetN;
-    poly->facet = AssignStorage(poly->faceN * sizeof(*poly->facet));
-    for (StlLongInt n = 0; n < facetN; ++n) {
-        Fread(&facetData, sizeof(StlReal), 1, filePointer);
-        poly->facet[n].N[X] = facetData;
-        Fread(&facetData, sizeof(StlReal), 1, filePointer);
-        poly->facet[n].N[Y] = facetData;
-        Fread(&facetData, sizeof(StlReal), 1, filePointer);
-        poly->facet[n].N[Z] = facetData;
-        Fread(&facetData, sizeof(StlReal), 1, filePointer);
-        poly->facet[n].v0[X] = facetData;
-        Fread(&facetData, sizeof(StlReal), 1, filePointer);
-        poly->facet[n].v0[Y] = facetData;
-        Fread(&facetData, sizeof(StlReal), 1, filePointer);
-        poly->facet[n].v0[Z] = facetData;
-        Fread(&facetData, sizeof(StlReal), 1, filePointer);
-        poly->facet[n].v1[X] = facetData;
-        Fread(&facetData, sizeof(StlReal), 1, filePointer);
-        poly->facet[n].v1[Y] = facetData;
-        Fread(&facetData, sizeof(StlReal), 1, filePointer);
-        poly->facet[n].v1[Z] = facetData;
-        Fread(&facetData, sizeof(StlReal), 1, filePointer);
-        poly->facet[n].v2[X] = facetData;
-        Fread(&facetData, sizeof(StlReal), 1, filePointer);
-        poly->facet[n].v2[Y] = facetData;
-        Fread(&facetData, sizeof(StlReal), 1, filePointer);
-        poly->facet[n].v2[Z] = facetData;
-        Fread(&attributeCount, sizeof(StlInt), 1, filePointer);
+    struct stat status;
+    if ((0 != fstat(fd, &status)) || (0 >= status.st_size)) {
+        FatalError("failed to read STL file...");
     }
-    fclose(filePointer); /* close current opened file */
+    const size_t size = status.st_size;
+    void *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (MAP_FAILED == map) {
+        FatalError("failed to map STL file...");
+    }
+    close(fd); /* the mapping persists after closing the descriptor */
+    const char *data = map;
+    StlLongInt facetN = 0;
+    if (STLHEAD <= size) {
+        memcpy(&facetN, data + sizeof(StlString), sizeof(StlLongInt));
+    }
+    if ((STLHEAD <= size) && ((size - STLHEAD) / STLRECORD == facetN) && ((size - STLHEAD) % STLRECORD == 0)) {
+        poly->faceN = facetN;
+        poly->facet = AssignStorage(poly->faceN * sizeof(*poly->facet));
+        ReadBinaryStl(data + STLHEAD, poly->faceN, poly->facet);
+    } else {
+        if ((5 > size) || (0 != strncmp(data, "solid", 5))) {
+            FatalError("unrecognized STL file...");
+        }
+        poly->facet = ReadAsciiStl(data, size, &(poly->faceN));
+    }
+    munmap(map, size);
+    return 0;
+}
+/*
+ * Each 50-byte record holds the normal, three vertices, and an attribute.
+ */
+static int ReadBinaryStl(const char *record, const int facetN, Facet *facet)
+{
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int n = 0; n < facetN; ++n) {
+        StlReal value[12] = {0.0};
+        memcpy(value, record + (size_t)n * STLRECORD, sizeof value);
+        for (int s = 0; s < DIMS; ++s) {
+            facet[n].N[s] = value[s];
+            facet[n].v0[s] = value[DIMS + s];
+            facet[n].v1[s] = value[2 * DIMS + s];
+            facet[n].v2[s] = value[3 * DIMS + s];
+        }
+    }
+    return 0;
+}
+/*
+ * The file is cut into pieces after endfacet keywords, and pieces are
+ * scanned concurrently with OpenMP then joined in order.
+ */
+static Facet *ReadAsciiStl(const char *data, const size_t size, int *facetN)
+{
+    int pieceN = 1; /* one piece per thread */
+#ifdef _OPENMP
+    pieceN = omp_get_max_threads();
+#endif
+    if ((size_t)pieceN > size / STLPIECE) { /* avoid tiny pieces */
+        pieceN = (STLPIECE > size) ? 1 : size / STLPIECE;
+    }
+    const char **start = AssignStorage((pieceN + 1) * sizeof(*start));
+    Facet **piece = AssignStorage(pieceN * sizeof(*piece));
+    int *count = AssignStorage(pieceN * sizeof(*count));
+    start[0] = data;
+    start[pieceN] = data + size;
+    for (int p = 1; p < pieceN; ++p) {
+        start[p] = NextFacet(data + p * (size / pieceN), data + size);
+    }
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int p = 0; p < pieceN; ++p) {
+        piece[p] = ReadAsciiStlPiece(start[p], start[p + 1], count + p);
+    }
+    *facetN = 0;
+    for (int p = 0; p < pieceN; ++p) {
+        *facetN = *facetN + count[p];
+    }
+    Facet *facet = AssignStorage(*facetN * sizeof(*facet));
+    for (int p = 0, n = 0; p < pieceN; n = n + count[p], ++p) {
+        memcpy(facet + n, piece[p], count[p] * sizeof(*facet));
+        RetrieveStorage(piece[p]);
+    }
+    RetrieveStorage(start);
+    RetrieveStorage(piece);
+    RetrieveStorage(count);
+    return facet;
+}
+/*
+ * Return the position after the first endfacet keyword from a position.
+ */
+static const char *NextFacet(const char *token, const char *end)
+{
+    const size_t length = strlen("endfacet");
+    for (; end >= token + length; ++token) {
+        if ((0 == memcmp(token, "endfacet", length)) && IsBlank(*(token - 1)) &&
+                ((end == token + length) || IsBlank(token[length]))) {
+            return token + length;
+        }
+    }
+    return end;
+}
+/*
+ * Scan the keywords of ASCII STL in a single pass. Facet storage grows by
+ * doubling since the facet count is not recorded in ASCII STL.
+ */
+static Facet *ReadAsciiStlPiece(const char *data, const char *end, int *facetN)
+{
+    const char *token = data;
+    size_t length = 0;
+    int capacity = 1024;
+    int vertexC = 0;
+    RealVec vertex[DIMS + 1] = {{0.0}}; /* normal and vertices */
+    Facet *facet = AssignStorage(capacity * sizeof(*facet));
+    *facetN = 0;
+    while (0 != (length = NextToken(&token, end))) {
+        if (TokenIs(token, length, "vertex")) {
+            if (DIMS <= vertexC) {
+                FatalError("corrupted ASCII STL file...");
+            }
+            token = token + length;
+            ++vertexC;
+            ReadTokenVector(&token, end, vertex[vertexC]);
+            continue;
+        }
+        if (TokenIs(token, length, "facet")) {
+            token = token + length;
+            length = NextToken(&token, end);
+            if (!TokenIs(token, length, "normal")) {
+                FatalError("corrupted ASCII STL file...");
+            }
+            token = token + length;
+            ReadTokenVector(&token, end, vertex[0]);
+            vertexC = 0;
+            continue;
+        }
+        if (TokenIs(token, length, "endfacet")) {
+            if (DIMS != vertexC) {
+                FatalError("corrupted ASCII STL file...");
+            }
+            if (capacity == *facetN) {
+                Facet *grown = AssignStorage(2 * capacity * sizeof(*facet));
+                memcpy(grown, facet, capacity * sizeof(*facet));
+                RetrieveStorage(facet);
+                facet = grown;
+                capacity = 2 * capacity;
+            }
+            for (int s = 0; s < DIMS; ++s) {
+                facet[*facetN].N[s] = vertex[0][s];
+                facet[*facetN].v0[s] = vertex[1][s];
+                facet[*facetN].v1[s] = vertex[2][s];
+                facet[*facetN].v2[s] = vertex[3][s];
+            }
+            ++(*facetN);
+            vertexC = 0;
+            token = token + length;
+            continue;
+        }
+        if (TokenIs(token, length, "solid") || TokenIs(token, length, "endsolid")) {
+            while ((end > token) && ('\n' != *token)) { /* skip solid name */
+                ++token;
+            }
+            continue;
+        }
+        token = token + length; /* outer, loop, endloop */
+    }
+    return facet;
+}
+static int IsBlank(const char c)
+{
+    return (' ' == c) || (('\t' <= c) && ('\r' >= c));
+}
+/*
+ * Advance to the next token and return its length, zero at the end.
+ */
+static size_t NextToken(const char **token, const char *end)
+{
+    const char *start = *token;
+    while ((end > start) && IsBlank(*start)) {
+        ++start;
+    }
+    const char *stop = start;
+    while ((end > stop) && !IsBlank(*stop)) {
+        ++stop;
+    }
+    *token = start;
+    return stop - start;
+}
+static int TokenIs(const char *token, const size_t length, const char *keyword)
+{
+    return (strlen(keyword) == length) && (0 == memcmp(token, keyword, length));
+}
+/*
+ * Numbers are converted in single precision as binary STL data. Plain
+ * decimals are converted directly, others are copied to a terminated buffer
+ * since the mapping is not, and converted by the standard library.
+ */
+static int ReadTokenVector(const char **token, const char *end, RealVec value)
+{
+    char number[64] = {'\0'};
+    StlReal data = 0.0;
+    for (int s = 0; s < DIMS; ++s) {
+        const size_t length = NextToken(token, end);
+        if ((0 == length) || (sizeof number <= length)) {
+            FatalError("corrupted ASCII STL file...");
+        }
+        if (0 != ConvertDecimal(*token, length, &data)) {
+            memcpy(number, *token, length);
+            number[length] = '\0';
+            char *stop = NULL;
+            data = strtof(number, &stop);
+            if (number + length != stop) {
+                FatalError("corrupted ASCII STL file...");
+            }
+        }
+        value[s] = data;
+        *token = *token + length;
+    }
+    return 0;
+}
+/*
+ * Convert a decimal with at most 15 significant digits and a small exponent,
+ * which are exact in double precision; the product of two exact values is
+ * then correctly rounded. Rounding it to single precision is correct unless
+ * it lies exactly halfway between two single values. Return nonzero for
+ * cases left to the standard library.
+ */
+static int ConvertDecimal(const char *token, const size_t length, StlReal *value)
+{
+    static const double power[23] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    const char *c = token;
+    const char *const end = token + length;
+    const int sign = ('-' == *c) ? -1 : 1;
+    if (('-' == *c) || ('+' == *c)) {
+        ++c;
+    }
+    uint64_t mantissa = 0;
+    int digitN = 0; /* significant digits */
+    int exponent = 0;
+    int hasDigit = 0;
+    for (int fraction = 0; end > c; ++c) {
+        if (('.' == *c) && (0 == fraction)) {
+            fraction = 1;
+            continue;
+        }
+        if (('0' > *c) || ('9' < *c)) {
+            break;
+        }
+        hasDigit = 1;
+        if ((0 < mantissa) || ('0' != *c)) {
+            ++digitN;
+        }
+        mantissa = 10 * mantissa + (*c - '0');
+        exponent = exponent - fraction;
+        if (15 < digitN) {
+            return 1;
+        }
+    }
+    if (0 == hasDigit) {
+        return 1;
+    }
+    if ((end > c) && (('e' == *c) || ('E' == *c))) {
+        ++c;
+        const int expSign = ('-' == *c) ? -1 : 1;
+        if (('-' == *c) || ('+' == *c)) {
+            ++c;
+        }
+        if (end == c) {
+            return 1;
+        }
+        int expValue = 0;
+        for (; (end > c) && ('0' <= *c) && ('9' >= *c); ++c) {
+            expValue = 10 * expValue + (*c - '0');
+            if (1000 < expValue) {
+                return 1;
+            }
+        }
+        exponent = exponent + expSign * expValue;
+    }
+    if ((end != c) || (22 < exponent) || (-22 > exponent)) {
+        return 1;
+    }
+    double result = (double)mantissa;
+    if (0 <= exponent) {
+        result = result * power[exponent];
+    } else {
+        result = result / power[-exponent];
+    }
+    if ((0.0 != result) && ((FLT_MIN > result) || (FLT_MAX < result))) {
+        return 1;
+    }
+    uint64_t bits = 0;
+    memcpy(&bits, &result, sizeof bits);
+    if ((uint64_t)1 << 28 == (bits & (((uint64_t)1 << 29) - 1))) {
+        return 1;
+    }
+    *value = sign * (StlReal)result;
     return 0;
 }
 int WriteStlFile(const char *fileName, const Polyhedron *poly)
@@ -22,6 +22,11 @@
  ****************************************************************************/
 /*
  * STL Reader
+ *
+ * Function
+ *      Read binary or ASCII STL file. The file is mapped into memory and
+ *      parsed in place, binary records are converted concurrently, and ASCII
+ *      data are scanned in pieces concurrently with OpenMP.
  */
 extern int ReadStlFile(const char *fileName, Polyhedron *);
 /*
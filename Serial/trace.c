@@ -0,0 +1,127 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include "trace.h"
+#include <stdio.h> /* standard library for input and output */
+#include <string.h> /* manipulating strings */
+#ifdef _OPENMP
+#include <omp.h> /* OpenMP runtime */
+#endif
+#include "timer.h"
+#include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+typedef enum {
+    EVENTN = 1 << 18, /* capacity of the ring buffer */
+} TraceConstants;
+/*
+ * Trace event
+ */
+typedef struct {
+    double ts; /* time stamp in microseconds since opening */
+    const char *name; /* phase name */
+    int tid; /* thread identifier */
+    char ph; /* phase type: [B] begin, [E] end */
+} Event;
+/****************************************************************************
+ * Static Function Declarations
+ ****************************************************************************/
+static void Record(const char *, const char);
+/****************************************************************************
+ * Global Variables Definition with Private Scope
+ ****************************************************************************/
+static Event *event = NULL; /* ring buffer, NULL when tracing is off */
+static unsigned long eventC = 0; /* total count of recorded events */
+static Timer origin; /* time of opening */
+static char traceFile[200] = {'\0'}; /* trace file name */
+/****************************************************************************
+ * Function definitions
+ ****************************************************************************/
+void OpenTrace(const char *fileName)
+{
+    strncpy(traceFile, fileName, sizeof(traceFile) - 1);
+    event = AssignStorage(EVENTN * sizeof(*event));
+    eventC = 0;
+    TickTime(&origin);
+    return;
+}
+void TraceBegin(const char *name)
+{
+    if (NULL == event) {
+        return;
+    }
+    Record(name, 'B');
+    return;
+}
+void TraceEnd(const char *name)
+{
+    if (NULL == event) {
+        return;
+    }
+    Record(name, 'E');
+    return;
+}
+/*
+ * The slot is claimed atomically, hence threads never share a slot unless
+ * the buffer wraps around within the time of a single store.
+ */
+static void Record(const char *name, const char ph)
+{
+    unsigned long n = 0;
+#ifdef _OPENMP
+#pragma omp atomic capture
+#endif
+    n = eventC++;
+    Event *ev = event + (n % EVENTN);
+    ev->ts = TockTime(&origin) * 1.0e6;
+    ev->name = name;
+    ev->ph = ph;
+#ifdef _OPENMP
+    ev->tid = omp_get_thread_num();
+#else
+    ev->tid = 0;
+#endif
+    return;
+}
+/*
+ * Events are written from the oldest one kept in the buffer. When the
+ * buffer has wrapped, end events of which the begin events are overwritten
+ * are shown by viewers as starting at the beginning of the trace.
+ */
+void CloseTrace(void)
+{
+    if (NULL == event) {
+        return;
+    }
+    FILE *filePointer = fopen(traceFile, "w");
+    if (NULL == filePointer) {
+        FatalError("failed to write trace file...");
+    }
+    const unsigned long start = (EVENTN < eventC) ? eventC - EVENTN : 0;
+    fprintf(filePointer, "{\"traceEvents\": [\n");
+    for (unsigned long n = start; n < eventC; ++n) {
+        const Event *ev = event + (n % EVENTN);
+        fprintf(filePointer, "{\"name\": \"%s\", \"ph\": \"%c\", \"ts\": %.3f, \"pid\": 1, \"tid\": %d}%s\n",
+                ev->name, ev->ph, ev->ts, ev->tid, (eventC - 1 == n) ? "" : ",");
+    }
+    fprintf(filePointer, "],\n");
+    fprintf(filePointer, "\"displayTimeUnit\": \"ms\",\n");
+    fprintf(filePointer, "\"otherData\": {\"program\": \"artracfd\", \"dropped\": %lu}\n", start);
+    fprintf(filePointer, "}\n");
+    fclose(filePointer);
+    RetrieveStorage(event);
+    event = NULL;
+    return;
+}
+/* a good practice: end file with a newline */
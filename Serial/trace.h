@@ -0,0 +1,43 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Header File Guards to Avoid Interdependence
+ ****************************************************************************/
+#ifndef ARTRACFD_TRACE_H_ /* if this is the first definition */
+#define ARTRACFD_TRACE_H_ /* a unique marker for this header file */
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+/****************************************************************************
+ * Public Functions Declaration
+ ****************************************************************************/
+/*
+ * Execution trace
+ *
+ * Function
+ *      Open the tracer to record begin and end events of named phases into
+ *      a preallocated ring buffer, the latest events are kept when the
+ *      buffer is full. Event names should be string literals since only
+ *      the pointers are recorded. Begin and end do nothing when the tracer
+ *      is not opened, and are safe to be called from OpenMP threads.
+ *      Close writes the events to the file in Chrome trace event format,
+ *      which can be loaded by chrome://tracing or Perfetto, and releases
+ *      the buffer.
+ */
+extern void OpenTrace(const char *fileName);
+extern void TraceBegin(const char *name);
+extern void TraceEnd(const char *name);
+extern void CloseTrace(void);
+#endif
+/* a good practice: end file with a newline */
@@ -27,12 +27,17 @@
  * WENO
  *
  * Function
- *      Compute reconstructed convective fluxes by WENO scheme.
+ *      Compute reconstructed convective fluxes by WENO scheme. The fifth
+ *      order scheme has the weights of Jiang and Shu, WENO-Z, and WENO-M.
  */
 extern void WENO3(const int tn, const int s, const int k, const int j, const int i, 
         const int partn[restrict], const Node *const, const Model *, Real Fhat[restrict]);
 extern void WENO5(const int tn, const int s, const int k, const int j, const int i, 
         const int partn[restrict], const Node *const, const Model *, Real Fhat[restrict]);
+extern void WENO5Z(const int tn, const int s, const int k, const int j, const int i, 
+        const int partn[restrict], const Node *const, const Model *, Real Fhat[restrict]);
+extern void WENO5M(const int tn, const int s, const int k, const int j, const int i, 
+        const int partn[restrict], const Node *const, const Model *, Real Fhat[restrict]);
 #endif
 /* a good practice: end file with a newline */
 
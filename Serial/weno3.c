@@ -29,11 +29,11 @@ typedef enum {
  * Static Function Declarations
  ****************************************************************************/
 static void CharacteristicVariable(const int, const int, const int, const int, const int, 
-        const int [restrict], const Node *const, Real [restrict][DIMU], Real [restrict][DIMU]);
+        const int [restrict], const Node *const, const Real, const Real [restrict], Real [restrict][DIMU]);
 static void CharacteristicFlux(const Real [restrict], Real [restrict][DIMU],
         const int, const int, Real [restrict][DIMU]);
 static void WENOConstruction(Real [restrict][DIMU], Real [restrict]);
-static void InverseProjection(Real [restrict][DIMU], const Real [restrict], 
+static void InverseProjection(const int, const Real [restrict], const Real [restrict], 
         const Real [restrict], Real [restrict]);
 static Real Square(const Real);
 /****************************************************************************
@@ -54,18 +54,14 @@ void WENO3(const int tn, const int s, const int k, const int j, const int i,
     SymmetricAverage(model->jacobMean, model->gamma, node[idxL].U[tn], node[idxR].U[tn], Uo);
     /* decompose Jacobian matrix */
     Real Lambda[DIMU]; /* eigenvalues */
-    Real L[DIMU][DIMU]; /* vector space {Ln} */
-    Real R[DIMU][DIMU]; /* vector space {Rn} */
     Eigenvalue(s, Uo, Lambda);
-    EigenvectorL(s, model->gamma, Uo, L);
-    EigenvectorR(s, Uo, R);
     /* flux vector splitting */
     Real LambdaP[DIMU]; /* eigenvalues */
     Real LambdaN[DIMU]; /* eigenvalues */
     EigenvalueSplitting(model->fluxSplit, Lambda, LambdaP, LambdaN);
     /* construct local characteristic variables for all potential stencils */
     Real W[TNSTENCIL][DIMU];
-    CharacteristicVariable(tn, s, k, j, i, partn, node, L, W);
+    CharacteristicVariable(tn, s, k, j, i, partn, node, model->gamma, Uo, W);
     /* construct local characteristic fluxes */
     Real HP[NSTENCIL][DIMU]; /* forward characteristic flux stencil */
     Real HN[NSTENCIL][DIMU]; /* backward characteristic flux stencil */
@@ -77,25 +73,24 @@ void WENO3(const int tn, const int s, const int k, const int j, const int i,
     WENOConstruction(HP, HhatP);
     WENOConstruction(HN, HhatN);
     /* inverse projection */
-    InverseProjection(R, HhatP, HhatN, Fhat);
+    InverseProjection(s, Uo, HhatP, HhatN, Fhat);
     return;
 }
 static void CharacteristicVariable(const int tn, const int s, const int k, const int j, const int i, 
-        const int partn[restrict], const Node *const node, Real L[restrict][DIMU], Real W[restrict][DIMU])
+        const int partn[restrict], const Node *const node, const Real gamma, const Real Uo[restrict],
+        Real W[restrict][DIMU])
 {
     const int h[DIMS][DIMS] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}}; /* direction indicator */
     int idx = 0; /* linear array index math variable */
-    const Real *restrict U = NULL;
+    Real U[TNSTENCIL][DIMU]; /* gathered stencil */
     for (int n = -N, count = 0; count < TNSTENCIL; ++n, ++count) {
         idx = IndexNode(k + n * h[s][Z], j + n * h[s][Y], i + n * h[s][X], partn[Y], partn[X]);
-        U = node[idx].U[tn];
-        for (int row = 0; row < DIMU; ++row) {
-            W[count][row] = 0.0;
-            for (int dummy = 0; dummy < DIMU; ++dummy) {
-                W[count][row] = W[count][row] + L[row][dummy] * U[dummy];
-            }
+        for (int dim = 0; dim < DIMU; ++dim) {
+            U[count][dim] = node[idx].U[tn][dim];
         }
     }
+    /* project the whole stencil onto the characteristic fields at once */
+    EigenvectorProjectL(s, gamma, Uo, TNSTENCIL, U[0], W[0]);
     return;
 }
 static void CharacteristicFlux(const Real Lambda[restrict], Real W[restrict][DIMU],
@@ -129,15 +124,14 @@ static void WENOConstruction(Real F[restrict][DIMU], Real Fhat[restrict])
     }
     return;
 }
-static void InverseProjection(Real R[restrict][DIMU], const Real HhatP[restrict], 
+static void InverseProjection(const int s, const Real Uo[restrict], const Real HhatP[restrict], 
         const Real HhatN[restrict], Real Fhat[restrict])
 {
+    Real Hhat[DIMU]; /* numerical flux of characteristic fields */
     for (int row = 0; row < DIMU; ++row) {
-        Fhat[row] = 0.0;
-        for (int dummy = 0; dummy < DIMU; ++dummy) {
-            Fhat[row] = Fhat[row] + R[row][dummy] * (HhatP[dummy] + HhatN[dummy]);
-        }
+        Hhat[row] = HhatP[row] + HhatN[row];
     }
+    EigenvectorProjectR(s, Uo, 1, Hhat, Fhat);
     return;
 }
 static Real Square(const Real x)
@@ -13,6 +13,7 @@
  ****************************************************************************/
 #include "weno.h"
 #include <stdio.h> /* standard library for input and output */
+#include <math.h> /* common mathematical functions */
 #include "cfd_commons.h"
 #include "commons.h"
 /****************************************************************************
@@ -25,15 +26,25 @@ typedef enum {
     NSTENCIL = 5, /* number of nodes in a stencil = (2r - 1) */
     TNSTENCIL = 6, /* total number of involved nodes = (2r) */
 } WENOConstants;
+typedef enum {
+    WEIGHTJS = 0, /* weights of Jiang and Shu */
+    WEIGHTZ = 1, /* weights of WENO-Z */
+    WEIGHTM = 2, /* mapped weights of WENO-M */
+} WeightConstants;
 /****************************************************************************
  * Static Function Declarations
  ****************************************************************************/
+static void Reconstruction(const int, const int, const int, const int, const int, const int,
+        const int [restrict], const Node *const, const Model *, Real [restrict]);
 static void CharacteristicVariable(const int, const int, const int, const int, const int, 
-        const int [restrict], const Node *const, Real [restrict][DIMU], Real [restrict][DIMU]);
+        const int [restrict], const Node *const, const Real, const Real [restrict], Real [restrict][DIMU]);
 static void CharacteristicFlux(const Real [restrict], Real [restrict][DIMU],
         const int, const int, Real [restrict][DIMU]);
-static void WENOConstruction(Real [restrict][DIMU], Real [restrict]);
-static void InverseProjection(Real [restrict][DIMU], const Real [restrict], 
+static void WENOConstruction(const int, Real [restrict][DIMU], Real [restrict]);
+static void WeightJS(const Real [restrict], Real [restrict]);
+static void WeightZ(const Real [restrict], Real [restrict]);
+static void WeightM(const Real [restrict], Real [restrict]);
+static void InverseProjection(const int, const Real [restrict], const Real [restrict], 
         const Real [restrict], Real [restrict]);
 static Real Square(const Real);
 /****************************************************************************
@@ -45,6 +56,35 @@ static Real Square(const Real);
  */
 void WENO5(const int tn, const int s, const int k, const int j, const int i, 
         const int partn[restrict], const Node *const node, const Model *model, Real Fhat[restrict])
+{
+    Reconstruction(WEIGHTJS, tn, s, k, j, i, partn, node, model, Fhat);
+    return;
+}
+/*
+ * Borges, R., Carmona, M., Costa, B. and Don, W.S., 2008. An improved
+ * weighted essentially non-oscillatory scheme for hyperbolic conservation
+ * laws. Journal of Computational Physics, 227(6), pp.3191-3211.
+ */
+void WENO5Z(const int tn, const int s, const int k, const int j, const int i, 
+        const int partn[restrict], const Node *const node, const Model *model, Real Fhat[restrict])
+{
+    Reconstruction(WEIGHTZ, tn, s, k, j, i, partn, node, model, Fhat);
+    return;
+}
+/*
+ * Henrick, A.K., Aslam, T.D. and Powers, J.M., 2005. Mapped weighted
+ * essentially non-oscillatory schemes: achieving optimal order near
+ * critical points. Journal of Computational Physics, 207(2), pp.542-567.
+ */
+void WENO5M(const int tn, const int s, const int k, const int j, const int i, 
+        const int partn[restrict], const Node *const node, const Model *model, Real Fhat[restrict])
+{
+    Reconstruction(WEIGHTM, tn, s, k, j, i, partn, node, model, Fhat);
+    return;
+}
+static void Reconstruction(const int weight, const int tn, const int s, const int k, const int j,
+        const int i, const int partn[restrict], const Node *const node, const Model *model,
+        Real Fhat[restrict])
 {
     const int h[DIMS][DIMS] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}}; /* direction indicator */
     const int idxL = IndexNode(k, j, i, partn[Y], partn[X]);
@@ -54,18 +94,14 @@ void WENO5(const int tn, const int s, const int k, const int j, const int i,
     SymmetricAverage(model->jacobMean, model->gamma, node[idxL].U[tn], node[idxR].U[tn], Uo);
     /* decompose Jacobian matrix */
     Real Lambda[DIMU]; /* eigenvalues */
-    Real L[DIMU][DIMU]; /* vector space {Ln} */
-    Real R[DIMU][DIMU]; /* vector space {Rn} */
     Eigenvalue(s, Uo, Lambda);
-    EigenvectorL(s, model->gamma, Uo, L);
-    EigenvectorR(s, Uo, R);
     /* flux vector splitting */
     Real LambdaP[DIMU]; /* eigenvalues */
     Real LambdaN[DIMU]; /* eigenvalues */
     EigenvalueSplitting(model->fluxSplit, Lambda, LambdaP, LambdaN);
     /* construct local characteristic variables for all potential stencils */
     Real W[TNSTENCIL][DIMU];
-    CharacteristicVariable(tn, s, k, j, i, partn, node, L, W);
+    CharacteristicVariable(tn, s, k, j, i, partn, node, model->gamma, Uo, W);
     /* construct local characteristic fluxes */
     Real HP[NSTENCIL][DIMU]; /* forward characteristic flux stencil */
     Real HN[NSTENCIL][DIMU]; /* backward characteristic flux stencil */
@@ -74,28 +110,27 @@ void WENO5(const int tn, const int s, const int k, const int j, const int i,
     /* WENO reconstruction */
     Real HhatP[DIMU]; /* forward numerical flux of characteristic fields */
     Real HhatN[DIMU]; /* backward numerical flux of characteristic fields */
-    WENOConstruction(HP, HhatP);
-    WENOConstruction(HN, HhatN);
+    WENOConstruction(weight, HP, HhatP);
+    WENOConstruction(weight, HN, HhatN);
     /* inverse projection */
-    InverseProjection(R, HhatP, HhatN, Fhat);
+    InverseProjection(s, Uo, HhatP, HhatN, Fhat);
     return;
 }
 static void CharacteristicVariable(const int tn, const int s, const int k, const int j, const int i, 
-        const int partn[restrict], const Node *const node, Real L[restrict][DIMU], Real W[restrict][DIMU])
+        const int partn[restrict], const Node *const node, const Real gamma, const Real Uo[restrict],
+        Real W[restrict][DIMU])
 {
     const int h[DIMS][DIMS] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}}; /* direction indicator */
     int idx = 0; /* linear array index math variable */
-    const Real *restrict U = NULL;
+    Real U[TNSTENCIL][DIMU]; /* gathered stencil */
     for (int n = -N, count = 0; count < TNSTENCIL; ++n, ++count) {
         idx = IndexNode(k + n * h[s][Z], j + n * h[s][Y], i + n * h[s][X], partn[Y], partn[X]);
-        U = node[idx].U[tn];
-        for (int row = 0; row < DIMU; ++row) {
-            W[count][row] = 0.0;
-            for (int dummy = 0; dummy < DIMU; ++dummy) {
-                W[count][row] = W[count][row] + L[row][dummy] * U[dummy];
-            }
+        for (int dim = 0; dim < DIMU; ++dim) {
+            U[count][dim] = node[idx].U[tn][dim];
         }
     }
+    /* project the whole stencil onto the characteristic fields at once */
+    EigenvectorProjectL(s, gamma, Uo, TNSTENCIL, U[0], W[0]);
     return;
 }
 static void CharacteristicFlux(const Real Lambda[restrict], Real W[restrict][DIMU],
@@ -108,14 +143,16 @@ static void CharacteristicFlux(const Real Lambda[restrict], Real W[restrict][DIM
     }
     return;
 }
-static void WENOConstruction(Real F[restrict][DIMU], Real Fhat[restrict])
+/*
+ * The kind of weights is selected per field by a switch on a value that is
+ * constant over the fields, the weight functions are thus inlined into the
+ * loop and cost nothing for the classic weights.
+ */
+static void WENOConstruction(const int weight, Real F[restrict][DIMU], Real Fhat[restrict])
 {
     Real omega[R]; /* weights */
     Real q[R]; /* q vectors */
-    Real alpha[R];
     Real IS[R];
-    const Real C[R] = {1.0 / 10.0, 6.0 / 10.0, 3.0 / 10.0};
-    const Real epsilon = 1.0e-6;
     for (int row = 0; row < DIMU; ++row) {
         IS[0] = (13.0 / 12.0) * Square(F[CEN-2][row] - 2.0 * F[CEN-1][row] + F[CEN][row]) + 
             (1.0 / 4.0) * Square(F[CEN-2][row] - 4.0 * F[CEN-1][row] + 3.0 * F[CEN][row]);
@@ -123,12 +160,17 @@ static void WENOConstruction(Real F[restrict][DIMU], Real Fhat[restrict])
             (1.0 / 4.0) * Square(F[CEN-1][row] - F[CEN+1][row]);
         IS[2] = (13.0 / 12.0) * Square(F[CEN][row] - 2.0 * F[CEN+1][row] + F[CEN+2][row]) +
             (1.0 / 4.0) * Square(3.0 * F[CEN][row] - 4.0 * F[CEN+1][row] + F[CEN+2][row]);
-        alpha[0] = C[0] / Square(epsilon + IS[0]);
-        alpha[1] = C[1] / Square(epsilon + IS[1]);
-        alpha[2] = C[2] / Square(epsilon + IS[2]);
-        omega[0] = alpha[0] / (alpha[0] + alpha[1] + alpha[2]);
-        omega[1] = alpha[1] / (alpha[0] + alpha[1] + alpha[2]);
-        omega[2] = alpha[2] / (alpha[0] + alpha[1] + alpha[2]);
+        switch (weight) {
+            case WEIGHTJS:
+                WeightJS(IS, omega);
+                break;
+            case WEIGHTZ:
+                WeightZ(IS, omega);
+                break;
+            default:
+                WeightM(IS, omega);
+                break;
+        }
         q[0] = (1.0 / 6.0) * (2.0 * F[CEN-2][row] - 7.0 * F[CEN-1][row] + 11.0 * F[CEN][row]);
         q[1] = (1.0 / 6.0) * (-F[CEN-1][row] + 5.0 * F[CEN][row] + 2.0 * F[CEN+1][row]);
         q[2] = (1.0 / 6.0) * (2.0 * F[CEN][row] + 5.0 * F[CEN+1][row] - F[CEN+2][row]);
@@ -136,15 +178,72 @@ static void WENOConstruction(Real F[restrict][DIMU], Real Fhat[restrict])
     }
     return;
 }
-static void InverseProjection(Real R[restrict][DIMU], const Real HhatP[restrict], 
+static void WeightJS(const Real IS[restrict], Real omega[restrict])
+{
+    Real alpha[R];
+    const Real C[R] = {1.0 / 10.0, 6.0 / 10.0, 3.0 / 10.0};
+    const Real epsilon = 1.0e-6;
+    alpha[0] = C[0] / Square(epsilon + IS[0]);
+    alpha[1] = C[1] / Square(epsilon + IS[1]);
+    alpha[2] = C[2] / Square(epsilon + IS[2]);
+    omega[0] = alpha[0] / (alpha[0] + alpha[1] + alpha[2]);
+    omega[1] = alpha[1] / (alpha[0] + alpha[1] + alpha[2]);
+    omega[2] = alpha[2] / (alpha[0] + alpha[1] + alpha[2]);
+    return;
+}
+/*
+ * The global smoothness indicator tau = |IS0 - IS2| and the power p = 2
+ * recover fifth order at critical points, epsilon only avoids division by
+ * zero.
+ */
+static void WeightZ(const Real IS[restrict], Real omega[restrict])
+{
+    Real alpha[R];
+    const Real C[R] = {1.0 / 10.0, 6.0 / 10.0, 3.0 / 10.0};
+    const Real epsilon = 1.0e-40;
+    const Real tau = fabs(IS[0] - IS[2]);
+    alpha[0] = C[0] * (1.0 + Square(tau / (epsilon + IS[0])));
+    alpha[1] = C[1] * (1.0 + Square(tau / (epsilon + IS[1])));
+    alpha[2] = C[2] * (1.0 + Square(tau / (epsilon + IS[2])));
+    omega[0] = alpha[0] / (alpha[0] + alpha[1] + alpha[2]);
+    omega[1] = alpha[1] / (alpha[0] + alpha[1] + alpha[2]);
+    omega[2] = alpha[2] / (alpha[0] + alpha[1] + alpha[2]);
+    return;
+}
+/*
+ * The weights of Jiang and Shu are mapped by
+ *      g(w) = w (C + C^2 - 3 C w + w^2) / (C^2 + w (1 - 2 C))
+ * and normalized again.
+ */
+static void WeightM(const Real IS[restrict], Real omega[restrict])
+{
+    Real alpha[R];
+    Real w[R];
+    const Real C[R] = {1.0 / 10.0, 6.0 / 10.0, 3.0 / 10.0};
+    const Real epsilon = 1.0e-40;
+    alpha[0] = C[0] / Square(epsilon + IS[0]);
+    alpha[1] = C[1] / Square(epsilon + IS[1]);
+    alpha[2] = C[2] / Square(epsilon + IS[2]);
+    for (int n = 0; n < R; ++n) {
+        w[n] = alpha[n] / (alpha[0] + alpha[1] + alpha[2]);
+    }
+    for (int n = 0; n < R; ++n) {
+        alpha[n] = w[n] * (C[n] + C[n] * C[n] - 3.0 * C[n] * w[n] + w[n] * w[n]) /
+            (C[n] * C[n] + w[n] * (1.0 - 2.0 * C[n]));
+    }
+    omega[0] = alpha[0] / (alpha[0] + alpha[1] + alpha[2]);
+    omega[1] = alpha[1] / (alpha[0] + alpha[1] + alpha[2]);
+    omega[2] = alpha[2] / (alpha[0] + alpha[1] + alpha[2]);
+    return;
+}
+static void InverseProjection(const int s, const Real Uo[restrict], const Real HhatP[restrict], 
         const Real HhatN[restrict], Real Fhat[restrict])
 {
+    Real Hhat[DIMU]; /* numerical flux of characteristic fields */
     for (int row = 0; row < DIMU; ++row) {
-        Fhat[row] = 0.0;
-        for (int dummy = 0; dummy < DIMU; ++dummy) {
-            Fhat[row] = Fhat[row] + R[row][dummy] * (HhatP[dummy] + HhatN[dummy]);
-        }
+        Hhat[row] = HhatP[row] + HhatN[row];
     }
+    EigenvectorProjectR(s, Uo, 1, Hhat, Fhat);
     return;
 }
 static Real Square(const Real x)